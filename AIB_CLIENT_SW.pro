@@ -34,16 +34,82 @@ SOURCES += \
         mainwindow.cpp \
     qcustomplot.cpp \
     plottingwindow.cpp \
-    treeviewcommands.cpp
+    treeviewcommands.cpp \
+    consoleview.cpp \
+    logstore.cpp \
+    logviewerwindow.cpp \
+    sessionexporter.cpp \
+    csvexporter.cpp \
+    columnarexporter.cpp \
+    telemetrystore.cpp \
+    exportdialog.cpp \
+    samplesource.cpp \
+    sessionfile.cpp \
+    databasesource.cpp \
+    sessionbrowser.cpp \
+    propertyregistry.cpp \
+    telemetryparser.cpp \
+    datatablemodel.cpp \
+    telemetrybus.cpp \
+    telemetrylink.cpp \
+    commandchannel.cpp \
+    procedurerunner.cpp \
+    procedurewindow.cpp \
+    timeaxisticker.cpp \
+    dashboardwindow.cpp \
+    reportrenderer.cpp \
+    telemetrystatistics.cpp \
+    alarmengine.cpp \
+    alarmwindow.cpp \
+    derivedchannels.cpp \
+    resampler.cpp \
+    resamplewindow.cpp
 
 HEADERS += \
         mainwindow.h \
     qcustomplot.h \
-    plottingwindow.h
+    plottingwindow.h \
+    consoleview.h \
+    logstore.h \
+    logviewerwindow.h \
+    sessionexporter.h \
+    csvexporter.h \
+    columnarexporter.h \
+    telemetrystore.h \
+    exportdialog.h \
+    telemetry.h \
+    samplesource.h \
+    sessionfile.h \
+    databasesource.h \
+    sessionbrowser.h \
+    propertyregistry.h \
+    telemetryparser.h \
+    datatablemodel.h \
+    telemetrybus.h \
+    telemetrylink.h \
+    commandchannel.h \
+    procedurerunner.h \
+    procedurewindow.h \
+    timeaxisticker.h \
+    dashboardwindow.h \
+    reportrenderer.h \
+    telemetrystatistics.h \
+    alarmengine.h \
+    alarmwindow.h \
+    derivedchannels.h \
+    resampler.h \
+    resamplewindow.h
 
 FORMS += \
         mainwindow.ui \
-        plottingwindow.ui
+        plottingwindow.ui \
+        logviewerwindow.ui \
+        exportdialog.ui \
+        sessionbrowser.ui \
+        procedurewindow.ui \
+        dashboardwindow.ui \
+        alarmwindow.ui \
+        resamplewindow.ui
 
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
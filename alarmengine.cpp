@@ -0,0 +1,382 @@
+#include "alarmengine.h"
+
+#include <QFile>
+#include <QTextStream>
+#include <QStringList>
+#include <QRegularExpression>
+#include <cmath>
+
+// ---- Definitions ---- //
+
+#define RuleFields 7 ///< Property, four limits, hysteresis and rate of a rules file line
+
+/**
+ * @brief Field of a rules file line
+ *
+ * '-' marks an unused field, its default is returned.
+ */
+static inline bool ruleField(const QString &text, double unused, double *value)
+{
+    if (text == "-")
+    {
+        *value = unused;
+        return true;
+    }
+    bool ok = false;
+    *value = text.toDouble(&ok);
+    return ok;
+}
+
+/**
+ * @brief Text of a rules file field
+ */
+static inline QString ruleText(double value)
+{
+    return std::isinf(value) ? QString("-") : QString::number(value, 'g', 10);
+}
+
+/**
+ * @brief Rule is not in normal state
+ */
+static inline bool ruleActive(const alarmRule &rule)
+{
+    return rule.limitState != alarmNormal || rule.rateState;
+}
+
+//  -----------      ----------------                Constructor Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Constructor
+ *
+ * @code {.c++}
+ * AlarmEngine::AlarmEngine(TelemetryStore *store, QObject *parent)
+ * @endcode
+ */
+AlarmEngine::AlarmEngine(TelemetryStore *store, QObject *parent) : QObject(parent), targetStore(store)
+{
+}
+
+//  -----------      ----------------                Rule Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Replace rules
+ *
+ * Rule table is built again, every rule starts from normal state with the next sample.
+ *
+ * @code {.c++}
+ * AlarmEngine::setRules(const QVector<alarmRule> &newRules)
+ * @endcode
+ */
+void AlarmEngine::setRules(const QVector<alarmRule> &newRules)
+{
+    ruleList.clear();
+    ruleTable.clear();
+    active = 0;
+
+    for (int i = 0; i < newRules.size(); i++)
+    {
+        alarmRule rule = newRules[i];
+        if (rule.property < 0)
+            continue;
+
+        rule.limitState = alarmNormal;
+        rule.rateState = false;
+        rule.hasLast = false;
+        ruleList.append(rule);
+
+        while (ruleTable.size() <= rule.property) // first rule of the property id
+            ruleTable.append(QVector<int>());
+        ruleTable[rule.property].append(ruleList.size() - 1);
+    }
+    emit alarmsChanged();
+}
+
+/**
+ * @brief Current rules with their states
+ *
+ * @code {.c++}
+ * AlarmEngine::rules()
+ * @endcode
+ */
+QVector<alarmRule> AlarmEngine::rules() const
+{
+    return ruleList;
+}
+
+/**
+ * @brief Alarm level of the property
+ *
+ * Rate of change alarms count as soft.
+ *
+ * @code {.c++}
+ * AlarmEngine::levelOf(int property)
+ * @endcode
+ */
+int AlarmEngine::levelOf(int property) const
+{
+    if (property < 0 || property >= ruleTable.size())
+        return alarmNormal;
+
+    int level = alarmNormal;
+    const QVector<int> &indexes = ruleTable.at(property);
+    for (int i = 0; i < indexes.size(); i++)
+    {
+        const alarmRule &rule = ruleList.at(indexes[i]);
+        level = qMax(level, rule.limitState);
+        if (rule.rateState)
+            level = qMax(level, (int)alarmSoft);
+    }
+    return level;
+}
+
+/**
+ * @brief Number of rules not in normal state
+ *
+ * @code {.c++}
+ * AlarmEngine::activeCount()
+ * @endcode
+ */
+int AlarmEngine::activeCount() const
+{
+    return active;
+}
+
+/**
+ * @brief Name of the level
+ *
+ * @code {.c++}
+ * AlarmEngine::levelName(int level)
+ * @endcode
+ */
+QString AlarmEngine::levelName(int level)
+{
+    if (level == alarmHard)
+        return "hard";
+    if (level == alarmSoft)
+        return "soft";
+    return "normal";
+}
+
+/**
+ * @brief Color of the level
+ *
+ * Used by the properties table, alarm panel and plot markers.
+ *
+ * @code {.c++}
+ * AlarmEngine::levelColor(int level)
+ * @endcode
+ */
+QColor AlarmEngine::levelColor(int level)
+{
+    if (level == alarmHard)
+        return QColor(230, 0, 0);
+    if (level == alarmSoft)
+        return QColor(255, 165, 0);
+    return QColor();
+}
+
+/**
+ * @brief Read rules file
+ *
+ * Property names are interned, rules may be loaded before the property is received.
+ *
+ * @code {.c++}
+ * AlarmEngine::readRules(const QString &path, QString *error)
+ * @endcode
+ */
+QVector<alarmRule> AlarmEngine::readRules(const QString &path, QString *error)
+{
+    QVector<alarmRule> result;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        *error = "Cannot read " + path;
+        return result;
+    }
+
+    QTextStream stream(&file);
+    int lineNumber = 0;
+    while (!stream.atEnd())
+    {
+        QString line = stream.readLine();
+        lineNumber++;
+        line = line.section('#', 0, 0).trimmed();
+        if (line.isEmpty())
+            continue;
+
+        QStringList fields = line.split(QRegularExpression("\\s+"));
+        alarmRule rule;
+        bool ok = fields.size() == RuleFields;
+        ok = ok && ruleField(fields.value(1), rule.softLow, &rule.softLow);
+        ok = ok && ruleField(fields.value(2), rule.softHigh, &rule.softHigh);
+        ok = ok && ruleField(fields.value(3), rule.hardLow, &rule.hardLow);
+        ok = ok && ruleField(fields.value(4), rule.hardHigh, &rule.hardHigh);
+        ok = ok && ruleField(fields.value(5), 0, &rule.hysteresis);
+        ok = ok && ruleField(fields.value(6), 0, &rule.rateLimit);
+        if (!ok)
+        {
+            *error = QString("Line %1 of %2 is not a rule").arg(lineNumber).arg(path);
+            return QVector<alarmRule>();
+        }
+
+        rule.property = PropertyRegistry::instance().intern(fields[0]);
+        rule.hysteresis = qAbs(rule.hysteresis);
+        rule.rateLimit = qAbs(rule.rateLimit);
+        result.append(rule);
+    }
+    return result;
+}
+
+/**
+ * @brief Write rules file
+ *
+ * @code {.c++}
+ * AlarmEngine::writeRules(const QString &path, const QVector<alarmRule> &rules, QString *error)
+ * @endcode
+ */
+bool AlarmEngine::writeRules(const QString &path, const QVector<alarmRule> &rules, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        *error = "Cannot write " + path;
+        return false;
+    }
+
+    QTextStream stream(&file);
+    stream << "# property  soft_low  soft_high  hard_low  hard_high  hysteresis  rate_per_s\n";
+    for (int i = 0; i < rules.size(); i++)
+    {
+        const alarmRule &rule = rules[i];
+        stream << PropertyRegistry::instance().name(rule.property) << " " << ruleText(rule.softLow) << " " << ruleText(rule.softHigh) << " "
+               << ruleText(rule.hardLow) << " " << ruleText(rule.hardHigh) << " " << QString::number(rule.hysteresis, 'g', 10) << " "
+               << (rule.rateLimit > 0 ? QString::number(rule.rateLimit, 'g', 10) : QString("-")) << "\n";
+    }
+    return true;
+}
+
+//  -----------      ----------------                Evaluation Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Receive batch from the telemetry bus
+ *
+ * Only rules of the sample's property are evaluated.
+ *
+ * @code {.c++}
+ * AlarmEngine::deliver(const QVector<telemetrySample> &samples)
+ * @endcode
+ */
+void AlarmEngine::deliver(const QVector<telemetrySample> &samples)
+{
+    bool changed = false;
+    for (int i = 0; i < samples.size(); i++)
+    {
+        const telemetrySample &sample = samples.at(i);
+        if (sample.property < 0 || sample.property >= ruleTable.size())
+            continue;
+
+        const QVector<int> &indexes = ruleTable.at(sample.property);
+        for (int r = 0; r < indexes.size(); r++)
+            changed |= evaluate(ruleList[indexes[r]], sample);
+    }
+
+    if (changed)
+        emit alarmsChanged();
+}
+
+/**
+ * @brief Level of the value
+ *
+ * Limits are moved inside by margin, used to apply the hysteresis when leaving a level.
+ *
+ * @code {.c++}
+ * AlarmEngine::limitLevel(const alarmRule &rule, double value, double margin)
+ * @endcode
+ */
+int AlarmEngine::limitLevel(const alarmRule &rule, double value, double margin)
+{
+    if (value > rule.hardHigh - margin || value < rule.hardLow + margin)
+        return alarmHard;
+    if (value > rule.softHigh - margin || value < rule.softLow + margin)
+        return alarmSoft;
+    return alarmNormal;
+}
+
+/**
+ * @brief Reason text of a limit level
+ *
+ * @code {.c++}
+ * AlarmEngine::limitReason(const alarmRule &rule, double value, int level)
+ * @endcode
+ */
+QString AlarmEngine::limitReason(const alarmRule &rule, double value, int level)
+{
+    if (level == alarmHard)
+        return value > rule.hardHigh - rule.hysteresis ? "hard high" : "hard low";
+    if (level == alarmSoft)
+        return value > rule.softHigh - rule.hysteresis ? "soft high" : "soft low";
+    return "back in limits";
+}
+
+/**
+ * @brief Evaluate rule for a sample
+ *
+ * A level is entered when the value crosses its limit and left only when the value is
+ * hysteresis inside the limit again. Rate of change is taken from the previous sample.
+ *
+ * @code {.c++}
+ * AlarmEngine::evaluate(alarmRule &rule, const telemetrySample &sample)
+ * @endcode
+ */
+bool AlarmEngine::evaluate(alarmRule &rule, const telemetrySample &sample)
+{
+    bool wasActive = ruleActive(rule);
+    bool changed = false;
+
+    int raised = limitLevel(rule, sample.value, 0);
+    int held = limitLevel(rule, sample.value, rule.hysteresis);
+    int level = qMax(raised, qMin(rule.limitState, held));
+    if (level != rule.limitState)
+    {
+        rule.limitState = level;
+        mark(rule, sample, level, limitReason(rule, sample.value, level));
+        changed = true;
+    }
+
+    if (rule.rateLimit > 0 && rule.hasLast && sample.key > rule.lastKey) // same time -> rate is not known
+    {
+        double rate = (sample.value - rule.lastValue) / (sample.key - rule.lastKey);
+        bool exceeded = qAbs(rate) > rule.rateLimit;
+        if (exceeded != rule.rateState)
+        {
+            rule.rateState = exceeded;
+            mark(rule, sample, exceeded ? alarmSoft : alarmNormal, exceeded ? QString("rate %1 /s").arg(rate, 0, 'g', 4) : QString("rate back in limit"));
+            changed = true;
+        }
+    }
+    rule.hasLast = true;
+    rule.lastKey = sample.key;
+    rule.lastValue = sample.value;
+
+    if (changed)
+        active += (int)ruleActive(rule) - (int)wasActive;
+    return changed;
+}
+
+/**
+ * @brief Mark state change in the telemetry store
+ *
+ * @code {.c++}
+ * AlarmEngine::mark(const alarmRule &rule, const telemetrySample &sample, int level, const QString &reason)
+ * @endcode
+ */
+void AlarmEngine::mark(const alarmRule &rule, const telemetrySample &sample, int level, const QString &reason)
+{
+    telemetryAlarm alarm;
+    alarm.key = sample.key;
+    alarm.property = rule.property;
+    alarm.value = sample.value;
+    alarm.level = level;
+    alarm.reason = reason;
+    targetStore->addAlarm(alarm);
+}
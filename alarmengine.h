@@ -0,0 +1,87 @@
+#ifndef ALARMENGINE_H
+#define ALARMENGINE_H
+
+#include <QObject>
+#include <QColor>
+#include <QString>
+#include <QVector>
+#include <limits>
+#include "telemetrystore.h"
+#include "telemetrybus.h"
+#include "propertyregistry.h"
+
+// ---- Alarm levels, ordered by severity ---- //
+enum alarmLevel
+{
+    alarmNormal = 0,
+    alarmSoft = 1,
+    alarmHard = 2
+};
+
+// -> limits of one property, unused limits are infinite
+struct alarmRule
+{
+public:
+    int property = NoProperty;
+    double softLow = -std::numeric_limits<double>::infinity();
+    double softHigh = std::numeric_limits<double>::infinity();
+    double hardLow = -std::numeric_limits<double>::infinity();
+    double hardHigh = std::numeric_limits<double>::infinity();
+    double hysteresis = 0; // value has to be this far inside a limit to leave its level
+    double rateLimit = 0;  // largest change per second, 0 -> not checked
+
+    // state, updated by the engine
+    int limitState = alarmNormal;
+    bool rateState = false;
+    bool hasLast = false;
+    double lastKey = 0;
+    double lastValue = 0;
+};
+
+/*
+ * Limit and rate of change checking of received samples.
+ *
+ * Rules are kept in a table indexed by property id, so each sample only visits the
+ * rules of its own property and evaluating does not allocate. Only state changes are
+ * reported: they are marked in the telemetry store, like lost lines, so the alarm panel and
+ * plots show them incrementally. Subscribed to every property on the telemetry bus
+ * before the views, so the properties table shows the state of the same batch.
+ *
+ * Rules file: one rule per line, '#' starts a comment, '-' marks an unused limit
+ *   <property> <soft low> <soft high> <hard low> <hard high> <hysteresis> <rate /s>
+ */
+class AlarmEngine : public QObject, public TelemetrySubscriber
+{
+    Q_OBJECT
+
+public:
+    explicit AlarmEngine(TelemetryStore *store, QObject *parent = nullptr);
+
+    void setRules(const QVector<alarmRule> &newRules); // states start from normal
+    QVector<alarmRule> rules() const;
+    int levelOf(int property) const; // highest level of the rules of the property
+    int activeCount() const;         // rules not in normal state
+
+    static QString levelName(int level);
+    static QColor levelColor(int level); // marker color, invalid for normal
+    static QVector<alarmRule> readRules(const QString &path, QString *error);
+    static bool writeRules(const QString &path, const QVector<alarmRule> &rules, QString *error);
+
+    void deliver(const QVector<telemetrySample> &samples) override;
+
+signals:
+    void alarmsChanged(); // once per batch with state changes
+
+private:
+    static int limitLevel(const alarmRule &rule, double value, double margin);
+    static QString limitReason(const alarmRule &rule, double value, int level);
+    bool evaluate(alarmRule &rule, const telemetrySample &sample); // true if state changed
+    void mark(const alarmRule &rule, const telemetrySample &sample, int level, const QString &reason);
+
+    TelemetryStore *targetStore;
+    QVector<alarmRule> ruleList;
+    QVector<QVector<int>> ruleTable; // property id -> indexes of its rules
+    int active = 0;
+};
+
+#endif // ALARMENGINE_H
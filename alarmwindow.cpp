@@ -0,0 +1,311 @@
+#include "alarmwindow.h"
+#include "ui_alarmwindow.h"
+
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QDateTime>
+#include <QHeaderView>
+#include <cmath>
+
+// ---- Definitions ---- //
+
+#define StateColumn 7       ///< Rules model -> property, four limits, hysteresis, rate, state
+#define AlarmRowLimit 10000 ///< State changes listed on the panel, oldest rows are removed
+
+/**
+ * @brief Text of a limit cell, empty for unused limits
+ */
+static inline QString limitText(double value)
+{
+    return std::isinf(value) ? QString() : QString::number(value, 'g', 10);
+}
+
+/**
+ * @brief Limit of a cell, empty cell is the unused limit
+ */
+static inline bool limitValue(const QStandardItem *item, double unused, double *value)
+{
+    QString text = item != nullptr ? item->text().trimmed() : QString();
+    if (text.isEmpty() || text == "-")
+    {
+        *value = unused;
+        return true;
+    }
+    bool ok = false;
+    *value = text.toDouble(&ok);
+    return ok;
+}
+
+//  -----------      ----------------                Constructor Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Constructor
+ *
+ * @code {.c++}
+ * AlarmWindow::AlarmWindow(AlarmEngine *engine, TelemetryStore *store, QWidget *parent)
+ * @endcode
+ */
+AlarmWindow::AlarmWindow(AlarmEngine *engine, TelemetryStore *store, QWidget *parent) : QWidget(parent), ui(new Ui::AlarmWindow), targetEngine(engine), targetStore(store)
+{
+    ui->setupUi(this);
+    setAttribute(Qt::WA_DeleteOnClose);
+
+    rulesModel = new QStandardItemModel(this);
+    rulesModel->setHorizontalHeaderLabels({"Property", "Soft Low", "Soft High", "Hard Low", "Hard High", "Hysteresis", "Rate /s", "State"});
+    ui->Rules_tableView->setModel(rulesModel);
+    ui->Rules_tableView->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+
+    alarmsModel = new QStandardItemModel(this);
+    alarmsModel->setHorizontalHeaderLabels({"Time", "Property", "Level", "Value", "Reason"});
+    ui->Alarms_tableView->setModel(alarmsModel);
+    ui->Alarms_tableView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    ui->Alarms_tableView->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+
+    showRules(targetEngine->rules());
+    connect(targetEngine, SIGNAL(alarmsChanged()), this, SLOT(onAlarmsChanged()));
+    onAlarmsChanged(); // changes marked before the panel was opened
+}
+
+/**
+ * @brief Destructor
+ *
+ * @code {.c++}
+ * AlarmWindow::~AlarmWindow()
+ * @endcode
+ */
+AlarmWindow::~AlarmWindow()
+{
+    delete ui;
+}
+
+//  -----------      ----------------                Rule Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Show rules on the rules table
+ *
+ * @code {.c++}
+ * AlarmWindow::showRules(const QVector<alarmRule> &rules)
+ * @endcode
+ */
+void AlarmWindow::showRules(const QVector<alarmRule> &rules)
+{
+    rulesModel->removeRows(0, rulesModel->rowCount());
+    for (int i = 0; i < rules.size(); i++)
+    {
+        const alarmRule &rule = rules[i];
+        QList<QStandardItem *> row;
+        row.append(new QStandardItem(PropertyRegistry::instance().name(rule.property)));
+        row.append(new QStandardItem(limitText(rule.softLow)));
+        row.append(new QStandardItem(limitText(rule.softHigh)));
+        row.append(new QStandardItem(limitText(rule.hardLow)));
+        row.append(new QStandardItem(limitText(rule.hardHigh)));
+        row.append(new QStandardItem(rule.hysteresis > 0 ? QString::number(rule.hysteresis, 'g', 10) : QString()));
+        row.append(new QStandardItem(rule.rateLimit > 0 ? QString::number(rule.rateLimit, 'g', 10) : QString()));
+        row.append(new QStandardItem());
+        row.last()->setEditable(false);
+        rulesModel->appendRow(row);
+    }
+    updateStates();
+}
+
+/**
+ * @brief Rules of the rules table
+ *
+ * Empty limit cells are unused limits.
+ *
+ * @code {.c++}
+ * AlarmWindow::rulesFromModel(QVector<alarmRule> *rules)
+ * @endcode
+ */
+bool AlarmWindow::rulesFromModel(QVector<alarmRule> *rules)
+{
+    rules->clear();
+    for (int i = 0; i < rulesModel->rowCount(); i++)
+    {
+        QString name = rulesModel->item(i, 0) != nullptr ? rulesModel->item(i, 0)->text().trimmed() : QString();
+        if (name.isEmpty())
+            continue;
+
+        alarmRule rule;
+        bool ok = limitValue(rulesModel->item(i, 1), rule.softLow, &rule.softLow);
+        ok = ok && limitValue(rulesModel->item(i, 2), rule.softHigh, &rule.softHigh);
+        ok = ok && limitValue(rulesModel->item(i, 3), rule.hardLow, &rule.hardLow);
+        ok = ok && limitValue(rulesModel->item(i, 4), rule.hardHigh, &rule.hardHigh);
+        ok = ok && limitValue(rulesModel->item(i, 5), 0, &rule.hysteresis);
+        ok = ok && limitValue(rulesModel->item(i, 6), 0, &rule.rateLimit);
+        if (!ok)
+        {
+            ui->Rules_tableView->selectRow(i);
+            return false;
+        }
+
+        rule.property = PropertyRegistry::instance().intern(name);
+        rule.hysteresis = qAbs(rule.hysteresis);
+        rule.rateLimit = qAbs(rule.rateLimit);
+        rules->append(rule);
+    }
+    return true;
+}
+
+/**
+ * @brief Show alarm level of each rule's property
+ *
+ * @code {.c++}
+ * AlarmWindow::updateStates()
+ * @endcode
+ */
+void AlarmWindow::updateStates()
+{
+    for (int i = 0; i < rulesModel->rowCount(); i++)
+    {
+        QStandardItem *state = rulesModel->item(i, StateColumn);
+        if (state == nullptr || rulesModel->item(i, 0) == nullptr)
+            continue;
+
+        int level = targetEngine->levelOf(PropertyRegistry::instance().find(rulesModel->item(i, 0)->text().trimmed()));
+        state->setText(AlarmEngine::levelName(level));
+        state->setForeground(level == alarmNormal ? QColor("darkGreen") : AlarmEngine::levelColor(level));
+    }
+    ui->Status_label->setText(QString::number(targetEngine->activeCount()) + " active alarms");
+}
+
+//  -----------      ----------------                Alarm Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Alarm states changed
+ *
+ * Only changes marked after the last call are read from the store.
+ *
+ * @code {.c++}
+ * AlarmWindow::onAlarmsChanged()
+ * @endcode
+ */
+void AlarmWindow::onAlarmsChanged()
+{
+    QVector<telemetryAlarm> alarms = targetStore->alarms(shownAlarms);
+    shownAlarms += alarms.size();
+
+    for (int i = 0; i < alarms.size(); i++)
+    {
+        const telemetryAlarm &alarm = alarms[i];
+        QList<QStandardItem *> row;
+        row.append(new QStandardItem(QDateTime::fromMSecsSinceEpoch(qint64(alarm.key * 1000)).toString("yyyy-MM-dd hh:mm:ss.zzz")));
+        row.append(new QStandardItem(PropertyRegistry::instance().name(alarm.property)));
+        row.append(new QStandardItem(AlarmEngine::levelName(alarm.level)));
+        row.append(new QStandardItem(QString::number(alarm.value)));
+        row.append(new QStandardItem(alarm.reason));
+        row[2]->setForeground(alarm.level == alarmNormal ? QColor("darkGreen") : AlarmEngine::levelColor(alarm.level));
+        alarmsModel->appendRow(row);
+    }
+
+    if (alarmsModel->rowCount() > AlarmRowLimit)
+        alarmsModel->removeRows(0, alarmsModel->rowCount() - AlarmRowLimit);
+    if (!alarms.isEmpty())
+        ui->Alarms_tableView->scrollToBottom();
+
+    updateStates();
+}
+
+//  -----------      ----------------                Button Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Load button
+ *
+ * Loaded rules are shown, they are used after Apply.
+ *
+ * @code {.c++}
+ * AlarmWindow::on_Load_pushButton_clicked()
+ * @endcode
+ */
+void AlarmWindow::on_Load_pushButton_clicked()
+{
+    QString path = QFileDialog::getOpenFileName(this, tr("Select Alarm Rules"), QDir::currentPath(), "Text File (*.txt)");
+    if (path.isEmpty())
+        return;
+
+    QString error;
+    QVector<alarmRule> rules = AlarmEngine::readRules(path, &error);
+    if (!error.isEmpty())
+    {
+        QMessageBox::warning(this, "Alarms", error);
+        return;
+    }
+    showRules(rules);
+    ui->Status_label->setText(QString::number(rules.size()) + " rules loaded, not applied");
+}
+
+/**
+ * @brief Save button
+ *
+ * @code {.c++}
+ * AlarmWindow::on_Save_pushButton_clicked()
+ * @endcode
+ */
+void AlarmWindow::on_Save_pushButton_clicked()
+{
+    QVector<alarmRule> rules;
+    if (!rulesFromModel(&rules))
+    {
+        QMessageBox::warning(this, "Alarms", "Selected rule has a limit which is not a number");
+        return;
+    }
+
+    QString path = QFileDialog::getSaveFileName(this, tr("Save Alarm Rules"), QDir::currentPath(), "Text File (*.txt)");
+    if (path.isEmpty())
+        return;
+
+    QString error;
+    if (!AlarmEngine::writeRules(path, rules, &error))
+        QMessageBox::warning(this, "Alarms", error);
+}
+
+/**
+ * @brief Add button
+ *
+ * @code {.c++}
+ * AlarmWindow::on_Add_pushButton_clicked()
+ * @endcode
+ */
+void AlarmWindow::on_Add_pushButton_clicked()
+{
+    QList<QStandardItem *> row;
+    for (int column = 0; column <= StateColumn; column++)
+        row.append(new QStandardItem());
+    row.last()->setEditable(false);
+    rulesModel->appendRow(row);
+    ui->Rules_tableView->edit(rulesModel->index(rulesModel->rowCount() - 1, 0));
+}
+
+/**
+ * @brief Remove button
+ *
+ * @code {.c++}
+ * AlarmWindow::on_Remove_pushButton_clicked()
+ * @endcode
+ */
+void AlarmWindow::on_Remove_pushButton_clicked()
+{
+    QModelIndex current = ui->Rules_tableView->currentIndex();
+    if (current.isValid())
+        rulesModel->removeRow(current.row());
+}
+
+/**
+ * @brief Apply button
+ *
+ * Rules of the table replace the rules of the engine.
+ *
+ * @code {.c++}
+ * AlarmWindow::on_Apply_pushButton_clicked()
+ * @endcode
+ */
+void AlarmWindow::on_Apply_pushButton_clicked()
+{
+    QVector<alarmRule> rules;
+    if (!rulesFromModel(&rules))
+    {
+        QMessageBox::warning(this, "Alarms", "Selected rule has a limit which is not a number");
+        return;
+    }
+    targetEngine->setRules(rules);
+}
@@ -0,0 +1,50 @@
+#ifndef ALARMWINDOW_H
+#define ALARMWINDOW_H
+
+#include <QWidget>
+#include <QStandardItemModel>
+#include "alarmengine.h"
+#include "telemetrystore.h"
+
+namespace Ui
+{
+    class AlarmWindow;
+}
+
+/*
+ * Alarm panel.
+ * Limit rules of the alarm engine are edited, loaded and saved here, alarm state
+ * changes marked in the telemetry store are listed as they arrive.
+ */
+class AlarmWindow : public QWidget
+{
+    Q_OBJECT
+
+public:
+    AlarmWindow(AlarmEngine *engine, TelemetryStore *store, QWidget *parent = nullptr);
+    ~AlarmWindow();
+
+private slots:
+    void onAlarmsChanged(); // adds new state changes, updates rule states
+
+    void on_Load_pushButton_clicked();
+    void on_Save_pushButton_clicked();
+    void on_Add_pushButton_clicked();
+    void on_Remove_pushButton_clicked();
+    void on_Apply_pushButton_clicked();
+
+private:
+    void showRules(const QVector<alarmRule> &rules);
+    bool rulesFromModel(QVector<alarmRule> *rules); // false if a cell is not a number
+    void updateStates();
+
+    Ui::AlarmWindow *ui;
+
+    AlarmEngine *targetEngine;
+    TelemetryStore *targetStore;
+    QStandardItemModel *rulesModel;
+    QStandardItemModel *alarmsModel;
+    int shownAlarms = 0; // alarm changes of the store already listed
+};
+
+#endif // ALARMWINDOW_H
@@ -0,0 +1,239 @@
+#include "columnarexporter.h"
+#include "propertyregistry.h"
+
+#include <QFile>
+#include <QtEndian>
+#include <cstring>
+
+// ---- Definitions ---- //
+
+#define ColumnarBlockSize 65536 ///< Maximum samples in one block of the file
+#define KeyColumnType 2         ///< float64 delta encoded
+#define ValueColumnType 1       ///< float64
+
+//  -----------      ----------------                Internal Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Compress column
+ *
+ * Converts the column into little endian float64 array and compresses it.
+ * If delta is set, each entry is stored as difference to the previous one.
+ *
+ * @code {.c++}
+ * compressColumn(const QVector<double> &column, bool delta)
+ * @endcode
+ */
+static QByteArray compressColumn(const QVector<double> &column, bool delta)
+{
+    QByteArray raw(column.size() * 8, Qt::Uninitialized);
+    uchar *out = reinterpret_cast<uchar *>(raw.data());
+
+    double previous = 0;
+    for (int i = 0; i < column.size(); i++)
+    {
+        double entry = delta ? column[i] - previous : column[i];
+        previous = column[i];
+
+        quint64 bits;
+        std::memcpy(&bits, &entry, 8);
+        qToLittleEndian(bits, out + 8 * i);
+    }
+    return qCompress(raw);
+}
+
+//  -----------      ----------------                Constructor Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Constructor
+ *
+ * @code {.c++}
+ * ColumnarExporter::ColumnarExporter(TelemetryStore *store, exportOptions options, QObject *parent)
+ * @endcode
+ */
+ColumnarExporter::ColumnarExporter(TelemetryStore *store, exportOptions options, QObject *parent) : SessionExporter(options, parent), sourceStore(store)
+{
+}
+
+//  -----------      ----------------                Export Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Export telemetry store to columnar file
+ *
+ * Walks the chunks of each selected property and collects samples into blocks.
+ * Each full block is compressed and written right away, so only one block is kept
+ * in memory. Footer index is written at the end. Samples received after export started are not exported.
+ *
+ * @code {.c++}
+ * ColumnarExporter::run()
+ * @endcode
+ */
+void ColumnarExporter::run()
+{
+    QString message = "Export finished.";
+    bool ok = true;
+
+    QFile file(targetOptions.path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        emit finished(false, "Could not create export file !");
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+    stream.writeRawData("AIBCOL01", 8);
+
+    // properties to be exported
+    QVector<int> seriesList;
+    if (targetOptions.property.isEmpty())
+    {
+        for (int i = 0; i < sourceStore->seriesCount(); i++)
+        {
+            if (sourceStore->sampleCount(i) > 0)
+                seriesList.append(i);
+        }
+    }
+    else if (sourceStore->sampleCount(PropertyRegistry::instance().find(targetOptions.property)) > 0)
+    {
+        seriesList.append(PropertyRegistry::instance().find(targetOptions.property));
+    }
+
+    // total sample count -> used for progress
+    qint64 total = 0;
+    qint64 done = 0;
+    int lastPercent = -1;
+    for (int i = 0; i < seriesList.size(); i++)
+        total += sourceStore->sampleCount(seriesList[i]);
+
+    keyColumn.reserve(ColumnarBlockSize);
+    valueColumn.reserve(ColumnarBlockSize);
+
+    QVector<propertyIndex> footer;
+    int chunkSize = TelemetryStore::chunkSize();
+
+    for (int p = 0; p < seriesList.size() && ok; p++) // for each property
+    {
+        propertyIndex index;
+        index.name = PropertyRegistry::instance().name(seriesList[p]);
+
+        int remaining = sourceStore->sampleCount(seriesList[p]); // count first, every counted sample is inside the snapshot
+        QVector<QSharedPointer<sampleChunk>> chunks = sourceStore->snapshot(seriesList[p]);
+
+        for (int c = 0; c < chunks.size() && remaining > 0; c++) // for each chunk of the property
+        {
+            if (isCancelled())
+            {
+                ok = false;
+                message = "Export cancelled.";
+                break;
+            }
+
+            const sampleChunk *chunk = chunks.at(c).data();
+            int count = qMin(remaining, chunkSize);
+            remaining -= count;
+
+            bool skip = targetOptions.useTimeRange && (chunk->keys[count - 1] < targetOptions.fromKey || chunk->keys[0] > targetOptions.toKey);
+            for (int i = 0; i < count && !skip; i++)
+            {
+                double key = chunk->keys[i];
+                if (targetOptions.useTimeRange && (key < targetOptions.fromKey || key > targetOptions.toKey))
+                    continue;
+
+                keyColumn.append(key);
+                valueColumn.append(chunk->values[i]);
+                if (keyColumn.size() == ColumnarBlockSize) // block full -> write
+                    writeBlock(stream, p, index);
+            }
+
+            done += count;
+            int percent = (total > 0) ? (int)(100 * done / total) : 100;
+            if (percent != lastPercent)
+            {
+                lastPercent = percent;
+                emit progress(percent);
+            }
+        }
+
+        if (ok && !keyColumn.isEmpty()) // write what is left
+            writeBlock(stream, p, index);
+
+        footer.append(index);
+    }
+
+    if (ok) // footer index
+    {
+        quint64 footerOffset = file.pos();
+        stream << quint32(footer.size());
+        for (int p = 0; p < footer.size(); p++)
+        {
+            QByteArray name = footer[p].name.toUtf8();
+            stream << quint32(name.size());
+            stream.writeRawData(name.constData(), name.size());
+            stream << quint8(KeyColumnType) << quint8(ValueColumnType);
+            stream << quint64(footer[p].sampleCount) << quint32(footer[p].blocks.size());
+
+            for (int b = 0; b < footer[p].blocks.size(); b++)
+            {
+                const blockIndex &block = footer[p].blocks[b];
+                stream << quint64(block.offset) << quint32(block.count);
+                stream << block.firstKey << block.lastKey << block.minValue << block.maxValue;
+            }
+        }
+        stream << footerOffset;
+        stream.writeRawData("AIBCEND1", 8);
+
+        if (stream.status() != QDataStream::Ok || file.error() != QFile::NoError)
+        {
+            ok = false;
+            message = "An Error occured while writing export file !";
+        }
+        emit progress(100);
+    }
+
+    file.close();
+    if (!ok) // remove partial file
+        file.remove();
+
+    emit finished(ok, message);
+}
+
+/**
+ * @brief Write block
+ *
+ * Compresses pending key and value columns, writes them as one block and
+ * adds the block to the footer index of the property. Pending columns are emptied
+ * without releasing their memory.
+ *
+ * @code {.c++}
+ * ColumnarExporter::writeBlock(QDataStream &stream, quint32 property, propertyIndex &index)
+ * @endcode
+ */
+void ColumnarExporter::writeBlock(QDataStream &stream, quint32 property, propertyIndex &index)
+{
+    blockIndex block;
+    block.offset = stream.device()->pos();
+    block.count = keyColumn.size();
+    block.firstKey = keyColumn.first();
+    block.lastKey = keyColumn.last();
+    block.minValue = valueColumn.first();
+    block.maxValue = valueColumn.first();
+    for (int i = 1; i < valueColumn.size(); i++)
+    {
+        block.minValue = qMin(block.minValue, valueColumn[i]);
+        block.maxValue = qMax(block.maxValue, valueColumn[i]);
+    }
+
+    QByteArray keys = compressColumn(keyColumn, true);
+    QByteArray values = compressColumn(valueColumn, false);
+
+    stream << property << quint32(block.count) << quint32(keys.size()) << quint32(values.size());
+    stream.writeRawData(keys.constData(), keys.size());
+    stream.writeRawData(values.constData(), values.size());
+
+    index.sampleCount += block.count;
+    index.blocks.append(block);
+
+    keyColumn.resize(0);
+    valueColumn.resize(0);
+}
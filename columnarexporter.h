@@ -0,0 +1,71 @@
+#ifndef COLUMNAREXPORTER_H
+#define COLUMNAREXPORTER_H
+
+#include <QString>
+#include <QVector>
+#include <QDataStream>
+#include "sessionexporter.h"
+#include "telemetrystore.h"
+
+/*
+ * Worker exporting telemetry store to compressed columnar binary file (*.aibc).
+ *
+ * File layout, all numbers little endian:
+ *
+ *   header  : "AIBCOL01"
+ *   blocks  : one after another, each holding up to 65536 samples of one property
+ *             u32 property     index of the property in the footer
+ *             u32 count        number of samples
+ *             u32 keyBytes     size of compressed key column
+ *             u32 valueBytes   size of compressed value column
+ *             key column       qCompress(float64[count]), delta encoded, first entry is absolute
+ *             value column     qCompress(float64[count])
+ *   footer  : u32 propertyCount
+ *             per property : u32 nameBytes, utf8 name, u8 keyType, u8 valueType,
+ *                            u64 sampleCount, u32 blockCount
+ *                            per block : u64 offset, u32 count, f64 firstKey, f64 lastKey, f64 minValue, f64 maxValue
+ *   trailer : u64 footerOffset, "AIBCEND1"
+ *
+ * Column types : 1 -> float64, 2 -> float64 delta encoded.
+ * Keys are seconds since epoch. qCompress output is a 4 byte big endian
+ * uncompressed size followed by a zlib stream, in python:
+ *   numpy.frombuffer(zlib.decompress(column[4:]), '<f8')
+ */
+class ColumnarExporter : public SessionExporter
+{
+    Q_OBJECT
+
+public:
+    ColumnarExporter(TelemetryStore *store, exportOptions options, QObject *parent = nullptr);
+
+public slots:
+    void run() override; // exports the store, emits finished at the end
+
+private:
+    // -> footer entry of a written block
+    struct blockIndex
+    {
+        quint64 offset;
+        quint32 count;
+        double firstKey;
+        double lastKey;
+        double minValue;
+        double maxValue;
+    };
+
+    // -> footer entry of a property
+    struct propertyIndex
+    {
+        QString name;
+        quint64 sampleCount = 0;
+        QVector<blockIndex> blocks;
+    };
+
+    void writeBlock(QDataStream &stream, quint32 property, propertyIndex &index); // compresses and writes pending columns
+
+    TelemetryStore *sourceStore;
+    QVector<double> keyColumn;   // samples waiting for the next block
+    QVector<double> valueColumn;
+};
+
+#endif // COLUMNAREXPORTER_H
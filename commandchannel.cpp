@@ -0,0 +1,300 @@
+#include "commandchannel.h"
+
+// ---- Definitions ---- //
+
+#define CommandTimeout 2000  ///< Default time in ms waited for an ack
+#define CommandRetries 2     ///< Default writes after the first one
+#define CommandWindow 64     ///< Default commands in flight at most
+#define TimeoutCheckPeriod 50 ///< Period in ms of the timeout check while commands are in flight
+#define StaleAckWait 30000    ///< Time in ms a timed out write waits for its late ack when nothing else is in flight
+
+//  -----------      ----------------                Constructor Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Constructor
+ *
+ * Created on the link thread, socket belongs to the same link.
+ *
+ * @code {.c++}
+ * CommandChannel::CommandChannel(int link, QTcpSocket *socket, QObject *parent)
+ * @endcode
+ */
+CommandChannel::CommandChannel(int link, QTcpSocket *socket, QObject *parent)
+    : QObject(parent), linkId(link), targetSocket(socket), timeout(CommandTimeout), retries(CommandRetries), window(CommandWindow)
+{
+    timeoutTimer = new QTimer(this);
+    timeoutTimer->setInterval(TimeoutCheckPeriod);
+    connect(timeoutTimer, SIGNAL(timeout()), this, SLOT(checkTimeouts()));
+    clock.start();
+}
+
+/**
+ * @brief Set ack timeout
+ *
+ * @code {.c++}
+ * CommandChannel::setTimeout(int ms)
+ * @endcode
+ */
+void CommandChannel::setTimeout(int ms)
+{
+    timeout = qMax(1, ms);
+}
+
+/**
+ * @brief Set number of retries
+ *
+ * @code {.c++}
+ * CommandChannel::setRetries(int count)
+ * @endcode
+ */
+void CommandChannel::setRetries(int count)
+{
+    retries = qMax(0, count);
+}
+
+/**
+ * @brief Set pipelining window
+ *
+ * @code {.c++}
+ * CommandChannel::setWindow(int count)
+ * @endcode
+ */
+void CommandChannel::setWindow(int count)
+{
+    window = qMax(1, count);
+    pump();
+}
+
+/**
+ * @brief Number of commands waiting for the ack
+ *
+ * @code {.c++}
+ * CommandChannel::inFlight()
+ * @endcode
+ */
+int CommandChannel::inFlight() const
+{
+    return flight.size();
+}
+
+//  -----------      ----------------                Command Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Queue command
+ *
+ * Commands sent while not connected are written after the connection is established.
+ * Commands queued at front are written before the waiting ones, used for subscriptions after reconnect.
+ * One entry is written as exactly one line, so it is answered by exactly one ack: surrounding
+ * whitespace and line ends are trimmed, empty commands and commands with a line break inside
+ * are reported as failed without being written.
+ *
+ * @code {.c++}
+ * CommandChannel::enqueue(const QByteArray &command, int tag, bool front)
+ * @endcode
+ */
+void CommandChannel::enqueue(const QByteArray &command, int tag, bool front)
+{
+    QByteArray line = command.trimmed();
+
+    pendingCommand entry;
+    entry.text = line + " \n";
+    entry.tag = tag;
+    entry.serial = nextSerial++;
+
+    if (line.isEmpty() || line.contains('\n') || line.contains('\r'))
+    {
+        qint64 now = clock.nsecsElapsed();
+        entry.sentAt = now;
+        finish(entry, false, line.isEmpty() ? "empty command" : "not a single line", -1, now);
+        return;
+    }
+
+    if (front)
+        queued.prepend(entry);
+    else
+        queued.enqueue(entry);
+    pump();
+}
+
+/**
+ * @brief Ack received
+ *
+ * Matched to the oldest write in flight. Ack of a write which already timed out is
+ * reported as stale, so it is not taken as the ack of the next command. If the timed out
+ * write is still being retried, the ack answers the command: a retry still queued is
+ * dropped, a retry already written is reported with this ack and waits in flight for its
+ * own ack as stale. Acks without command in flight are ignored.
+ *
+ * @code {.c++}
+ * CommandChannel::acknowledge(const QString &response, qint64 sequence)
+ * @endcode
+ */
+void CommandChannel::acknowledge(const QString &response, qint64 sequence)
+{
+    if (flight.isEmpty())
+        return;
+
+    qint64 now = clock.nsecsElapsed();
+    pendingCommand command = flight.dequeue();
+    if (command.timedOut)
+    {
+        for (int i = 0; i < queued.size(); i++)
+        {
+            if (queued[i].serial != command.serial)
+                continue;
+            queued.removeAt(i);
+            finish(command, true, response, sequence, now);
+            pump();
+            return;
+        }
+        for (int i = 0; i < flight.size(); i++)
+        {
+            if (flight[i].serial != command.serial || flight[i].timedOut)
+                continue;
+            flight[i].timedOut = true;
+            finish(flight[i], true, response, sequence, now);
+            pump();
+            return;
+        }
+    }
+
+    finish(command, true, response, sequence, now, command.timedOut);
+    pump();
+}
+
+/**
+ * @brief Connection state changed
+ *
+ * Acks of the commands in flight can not arrive over a new connection, they are failed.
+ * Queued commands are kept and written after reconnect.
+ *
+ * @code {.c++}
+ * CommandChannel::setConnected(bool state)
+ * @endcode
+ */
+void CommandChannel::setConnected(bool state)
+{
+    connected = state;
+    if (!connected)
+    {
+        qint64 now = clock.nsecsElapsed();
+        while (!flight.isEmpty())
+        {
+            pendingCommand command = flight.dequeue();
+            if (!command.timedOut) // stale ones were already reported
+                finish(command, false, "connection lost", -1, now);
+        }
+        timeoutTimer->stop();
+        return;
+    }
+    pump();
+}
+
+/**
+ * @brief Write queued commands
+ *
+ * Commands are written back to back until the window is full, socket is flushed once.
+ *
+ * @code {.c++}
+ * CommandChannel::pump()
+ * @endcode
+ */
+void CommandChannel::pump()
+{
+    if (!connected || queued.isEmpty() || flight.size() >= window)
+        return;
+
+    while (!queued.isEmpty() && flight.size() < window)
+    {
+        pendingCommand command = queued.dequeue();
+        command.attempts++;
+        command.sentAt = clock.nsecsElapsed();
+        targetSocket->write(command.text);
+        flight.enqueue(command);
+    }
+    targetSocket->flush();
+
+    if (!timeoutTimer->isActive())
+        timeoutTimer->start();
+}
+
+/**
+ * @brief Check commands in flight
+ *
+ * Writes are in time order, so checking stops at the first one still in time.
+ * Timed out write stays in flight as stale, its late ack must not be matched to a later
+ * command. Command is written again at the front of the queue only if it is the last
+ * write in flight, otherwise it is failed like after the last retry.
+ * A write timing out behind stale writes means acks are shifted: a stale write lost its
+ * ack and took the ack of a later one. The stale writes are dropped as lost together with
+ * the timed out write, so the next ack is matched to the next write again.
+ * Stale writes are also dropped when nothing else is in flight and their acks did not
+ * arrive in StaleAckWait, so a server which lost them does not block the window.
+ *
+ * @code {.c++}
+ * CommandChannel::checkTimeouts()
+ * @endcode
+ */
+void CommandChannel::checkTimeouts()
+{
+    qint64 now = clock.nsecsElapsed();
+    for (int i = 0; i < flight.size(); i++)
+    {
+        if (flight[i].timedOut)
+            continue;
+        if (now - flight[i].sentAt <= qint64(timeout) * 1000000)
+            break;
+
+        pendingCommand command = flight[i];
+        bool last = i == flight.size() - 1;
+        if (i > 0) // every write before it is stale
+        {
+            flight.erase(flight.begin(), flight.begin() + i + 1);
+            i = -1;
+        }
+        else
+            flight[i].timedOut = true;
+
+        if (command.attempts <= retries && last)
+        {
+            command.timedOut = false;
+            queued.prepend(command);
+        }
+        else
+            finish(command, false, "timeout", -1, now);
+    }
+
+    bool allStale = true;
+    for (int i = 0; i < flight.size() && allStale; i++)
+        allStale = flight[i].timedOut;
+    if (allStale && !flight.isEmpty() && now - flight.last().sentAt > qint64(StaleAckWait) * 1000000)
+        flight.clear();
+
+    if (flight.isEmpty() && queued.isEmpty())
+        timeoutTimer->stop();
+    pump();
+}
+
+/**
+ * @brief Report result of a command
+ *
+ * Stale results report late acks, the command itself was already reported.
+ *
+ * @code {.c++}
+ * CommandChannel::finish(const pendingCommand &command, bool ok, const QString &response, qint64 sequence, qint64 now, bool stale)
+ * @endcode
+ */
+void CommandChannel::finish(const pendingCommand &command, bool ok, const QString &response, qint64 sequence, qint64 now, bool stale)
+{
+    commandResult result;
+    result.link = linkId;
+    result.tag = command.tag;
+    result.command = QString::fromUtf8(command.text).trimmed();
+    result.ok = ok;
+    result.attempts = command.attempts;
+    result.latency = (now - command.sentAt) / 1e6;
+    result.response = response;
+    result.sequence = sequence;
+    result.stale = stale;
+    emit commandFinished(result);
+}
@@ -0,0 +1,97 @@
+#ifndef COMMANDCHANNEL_H
+#define COMMANDCHANNEL_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QString>
+#include <QQueue>
+#include <QTimer>
+#include <QTcpSocket>
+#include <QElapsedTimer>
+
+// -> result of a command sent by a command channel
+struct commandResult
+{
+public:
+    int link = -1;         // link of the command
+    int tag = -1;          // given by the sender, -1 for commands typed by user
+    QString command;       // command text without line end
+    bool ok = false;       // ack received
+    int attempts = 0;      // times the command was written
+    double latency = 0;    // ms between the last write and the ack
+    QString response;      // keyword of the ack line, error text if failed
+    qint64 sequence = -1;  // sequence number of the ack line
+    bool stale = false;    // late ack of a command already reported as timed out or retried
+};
+Q_DECLARE_METATYPE(commandResult)
+
+/*
+ * Pipelined command sender of a link.
+ *
+ * Commands are written without waiting for the previous ack, up to a window of
+ * commands in flight. Server answers every written line with one ack line in order and
+ * the ack carries no id of the command, so acks are matched by write order: each ack
+ * belongs to the oldest write in flight. The sequence number of the ack line is the
+ * server's line counter, not a command id, it is only reported with the result.
+ * Every queued command gets a channel serial which its retries keep, so an ack arriving
+ * for any write of a command answers that command once.
+ * A command without ack in time stays in flight as stale, its late ack is reported as
+ * stale instead of being matched to the next command. Timed out command is written again
+ * only if no command was written after it, otherwise the retry would be executed out of order,
+ * after the last retry or with later commands in flight it is reported as failed.
+ * A later write timing out behind stale ones drops them as lost, which resyncs the acks.
+ * Lives on the link thread, every write to the server goes through the channel.
+ */
+class CommandChannel : public QObject
+{
+    Q_OBJECT
+
+public:
+    CommandChannel(int link, QTcpSocket *socket, QObject *parent = nullptr);
+
+    void setTimeout(int ms);    // time waited for an ack
+    void setRetries(int count); // writes after the first one
+    void setWindow(int count);  // commands in flight at most
+
+    void enqueue(const QByteArray &command, int tag, bool front = false); // sent when connected and window allows
+    void acknowledge(const QString &response, qint64 sequence);         // ack line received
+    void setConnected(bool state);                                       // lost connection fails commands in flight
+    int inFlight() const;
+
+signals:
+    void commandFinished(commandResult result);
+
+private slots:
+    void checkTimeouts(); // timed out commands are retried or failed, forgotten stale writes are dropped
+
+private:
+    // -> command written or waiting to be written
+    struct pendingCommand
+    {
+        QByteArray text; // with line end
+        int tag = -1;
+        int attempts = 0;
+        qint64 sentAt = 0; // ns on the channel clock
+        bool timedOut = false; // reported or retried, waits only for its late ack
+        qint64 serial = 0;     // channel id of the command, kept by its retries
+    };
+
+    void pump();                                                         // writes queued commands into the window
+    void finish(const pendingCommand &command, bool ok, const QString &response, qint64 sequence, qint64 now, bool stale = false);
+
+    int linkId;
+    QTcpSocket *targetSocket;
+    bool connected = false;
+
+    int timeout;
+    int retries;
+    int window;
+
+    QQueue<pendingCommand> queued;   // waiting for the window
+    QQueue<pendingCommand> flight;   // written, waiting for the ack in write order, stale ones included
+    QTimer *timeoutTimer;
+    QElapsedTimer clock;
+    qint64 nextSerial = 0;
+};
+
+#endif // COMMANDCHANNEL_H
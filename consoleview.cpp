@@ -0,0 +1,248 @@
+#include "consoleview.h"
+
+// ---- Definitions ---- //
+
+#define FrameInterval 16 ///< Time between console redraws in ms (~60 fps)
+
+//  -----------      ----------------                Constructor Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Default Constructor
+ *
+ * Sets up the document limits and frame timer used for batching messages.
+ *
+ * @code {.c++}
+ * ConsoleView::ConsoleView(QWidget *parent)
+ * @endcode
+ */
+ConsoleView::ConsoleView(QWidget *parent) : QPlainTextEdit(parent)
+{
+    setReadOnly(true);
+    setUndoRedoEnabled(false); // no undo stack -> memory of console stays bounded
+    setMaximumBlockCount(maxLines);
+
+    pending.resize(maxLines);
+
+    frameTimer = new QTimer(this);
+    frameTimer->setSingleShot(true);
+    frameTimer->setInterval(FrameInterval);
+    connect(frameTimer, SIGNAL(timeout()), this, SLOT(flushPending()));
+
+    connect(verticalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(onScrollChanged(int)));
+}
+
+//  -----------      ----------------                External Access Methods                     ----------------              ---------------- //
+
+/**
+ * @brief Queue message to the console
+ *
+ * Message is stored in the pending ring buffer and drawn with the next frame.
+ * Oldest messages are dropped while the queued lines are above the line limit or the
+ * ring buffer is full, since they would be dropped from the document anyway. Message
+ * with more lines than the limit is cut to its last lines.
+ *
+ * @code {.c++}
+ * ConsoleView::appendMessage(const QString &message, const QColor &color)
+ * @endcode
+ */
+void ConsoleView::appendMessage(const QString &message, const QColor &color)
+{
+    int lines = message.count('\n');
+    int start = 0;
+    if (lines > maxLines) // keep the last maxLines lines
+    {
+        start = message.size();
+        for (int i = 0; i <= maxLines; i++)
+            start = message.lastIndexOf('\n', start - 1);
+        start++;
+        lines = maxLines;
+    }
+
+    if (pendingCount == pending.size()) // buffer full -> drop the oldest one
+        dropOldest();
+
+    int tail = (pendingHead + pendingCount) % pending.size();
+    pending[tail].text = start > 0 ? message.mid(start) : message;
+    pending[tail].color = color;
+    pending[tail].lines = lines;
+    pendingCount++;
+    pendingLines += lines;
+
+    while (pendingLines > maxLines && pendingCount > 1)
+        dropOldest();
+
+    if (!paused && !frameTimer->isActive()) // schedule a redraw for this frame
+    {
+        frameTimer->start();
+    }
+}
+
+/**
+ * @brief Clear console
+ *
+ * Clears the document and drops all queued messages.
+ *
+ * @code {.c++}
+ * ConsoleView::clearConsole()
+ * @endcode
+ */
+void ConsoleView::clearConsole()
+{
+    pendingHead = 0;
+    pendingCount = 0;
+    pendingLines = 0;
+    clear();
+    follow = true;
+}
+
+/**
+ * @brief Set line limit
+ *
+ * Sets the maximum amount of lines kept in the console. Oldest lines
+ * are removed once the limit is reached.
+ *
+ * @code {.c++}
+ * ConsoleView::setLineLimit(int limit)
+ * @endcode
+ */
+void ConsoleView::setLineLimit(int limit)
+{
+    if (limit < 1)
+        return;
+
+    // move queued messages to new ring buffer, keep only the newest ones if it is smaller
+    QVector<consoleEntry> resized(limit);
+    int kept = qMin(pendingCount, limit);
+    for (int i = 0; i < kept; i++)
+    {
+        resized[i] = pending[(pendingHead + pendingCount - kept + i) % pending.size()];
+    }
+    pending = resized;
+    pendingHead = 0;
+    pendingCount = kept;
+    pendingLines = 0;
+    for (int i = 0; i < kept; i++)
+        pendingLines += pending[i].lines;
+
+    maxLines = limit;
+    setMaximumBlockCount(maxLines);
+    while (pendingLines > maxLines && pendingCount > 1)
+        dropOldest();
+}
+
+/**
+ * @brief Returns line limit of the console
+ *
+ * @code {.c++}
+ * ConsoleView::lineLimit()
+ * @endcode
+ */
+int ConsoleView::lineLimit() const
+{
+    return maxLines;
+}
+
+/**
+ * @brief Pause or resume console
+ *
+ * Paused console keeps collecting messages in the ring buffer but does not
+ * redraw, so user can read the lines. When resumed, buffered messages are drawn
+ * and console follows the latest line again.
+ *
+ * @code {.c++}
+ * ConsoleView::setPaused(bool state)
+ * @endcode
+ */
+void ConsoleView::setPaused(bool state)
+{
+    paused = state;
+    if (!paused)
+    {
+        follow = true;
+        flushPending();
+    }
+}
+
+/**
+ * @brief Returns if console is paused
+ *
+ * @code {.c++}
+ * ConsoleView::isPaused()
+ * @endcode
+ */
+bool ConsoleView::isPaused() const
+{
+    return paused;
+}
+
+//  -----------      ----------------                Internal Methods                     ----------------              ---------------- //
+
+/**
+ * @brief Draw queued messages
+ *
+ * Called once per frame. Inserts every queued message in a single edit block,
+ * so document layout is done only once for the whole batch.
+ *
+ * @code {.c++}
+ * ConsoleView::flushPending()
+ * @endcode
+ */
+void ConsoleView::flushPending()
+{
+    if (paused || pendingCount == 0)
+        return;
+
+    QTextCursor cursor(document());
+    QTextCharFormat format;
+
+    cursor.movePosition(QTextCursor::End);
+    cursor.beginEditBlock();
+    for (int i = 0; i < pendingCount; i++) // for each queued message in order
+    {
+        consoleEntry &entry = pending[(pendingHead + i) % pending.size()];
+        format.setForeground(entry.color);
+        cursor.insertText(entry.text, format);
+        entry.text.clear();
+    }
+    cursor.endEditBlock();
+
+    pendingHead = 0;
+    pendingCount = 0;
+    pendingLines = 0;
+
+    if (follow) // scrolling to bottom automatically
+    {
+        verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+    }
+}
+
+/**
+ * @brief Drop oldest queued message
+ *
+ * @code {.c++}
+ * ConsoleView::dropOldest()
+ * @endcode
+ */
+void ConsoleView::dropOldest()
+{
+    consoleEntry &entry = pending[pendingHead];
+    pendingLines -= entry.lines;
+    entry.text.clear();
+    pendingHead = (pendingHead + 1) % pending.size();
+    pendingCount--;
+}
+
+/**
+ * @brief Scroll bar moved
+ *
+ * Console follows new lines only if the scroll bar is at the bottom.
+ * Scrolling up stops following, scrolling back down enables it again.
+ *
+ * @code {.c++}
+ * ConsoleView::onScrollChanged(int value)
+ * @endcode
+ */
+void ConsoleView::onScrollChanged(int value)
+{
+    follow = (value >= verticalScrollBar()->maximum());
+}
@@ -0,0 +1,67 @@
+#ifndef CONSOLEVIEW_H
+#define CONSOLEVIEW_H
+
+#include <QPlainTextEdit>
+#include <QScrollBar>
+#include <QTextCursor>
+#include <QTextCharFormat>
+#include <QColor>
+#include <QTimer>
+#include <QVector>
+
+// -> single message waiting to be drawn on the console
+struct consoleEntry
+{
+public:
+    consoleEntry() {}
+    consoleEntry(QString txt, QColor clr) : text(txt), color(clr) {}
+
+    QString text;
+    QColor color;
+    int lines = 0; // line ends in the text
+};
+
+/*
+ * Console widget used at main window.
+ *
+ * Messages are not drawn when they arrive, they are queued in a ring buffer
+ * and drawn together once per ui frame. Document is limited to a fixed amount of lines,
+ * oldest lines are dropped when limit is reached. Queued messages are bounded by the
+ * same amount of lines, a message can hold a whole receive batch.
+ */
+class ConsoleView : public QPlainTextEdit
+{
+    Q_OBJECT
+
+public:
+    explicit ConsoleView(QWidget *parent = nullptr);
+
+    void appendMessage(const QString &message, const QColor &color); // queues message, drawn on next frame
+    void clearConsole();                                             // clears both document and queued messages
+
+    void setLineLimit(int limit); // maximum lines kept on the console
+    int lineLimit() const;
+
+    void setPaused(bool state); // paused console keeps buffering but does not redraw
+    bool isPaused() const;
+
+private slots:
+    void flushPending();              // draws the queued messages at once
+    void onScrollChanged(int value);  // follow mode is disabled when user scrolls up
+
+private:
+    void dropOldest(); // removes the oldest queued message
+    QTimer *frameTimer; //-> one shot timer for batching messages in a frame
+
+    // *** Pending message ring buffer *** //
+    QVector<consoleEntry> pending; // fixed size storage
+    int pendingHead = 0;           // index of the oldest queued message
+    int pendingCount = 0;          // number of queued messages
+    int pendingLines = 0;          // line ends in the queued messages
+
+    int maxLines = 5000;
+    bool paused = false;
+    bool follow = true; // scroll to the bottom automatically
+};
+
+#endif // CONSOLEVIEW_H
@@ -0,0 +1,195 @@
+#include "csvexporter.h"
+#include "telemetry.h"
+
+#include <QFile>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QVariant>
+
+// ---- Definitions ---- //
+
+#define ExportChunkSize 20000        ///< Rows read from database at once
+#define WriteBufferSize (1 << 20)    ///< Bytes collected before writing to the file
+
+//  -----------      ----------------                Constructor Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Constructor
+ *
+ * @code {.c++}
+ * CsvExporter::CsvExporter(QString databasePath, exportOptions options, QObject *parent)
+ * @endcode
+ */
+CsvExporter::CsvExporter(QString databasePath, exportOptions options, QObject *parent) : SessionExporter(options, parent), sourcePath(databasePath)
+{
+}
+
+//  -----------      ----------------                Export Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Export database to csv
+ *
+ * Opens a read only connection to the session database on this thread,
+ * then reads rows in chunks using rowid ranges. Rows added after export started are not exported.
+ *
+ * Time range filter uses TimeKey column when database has it, older databases
+ * are filtered by parsing the timestamp text.
+ *
+ * @code {.c++}
+ * CsvExporter::run()
+ * @endcode
+ */
+void CsvExporter::run()
+{
+    QString connectionName = "csvExport" + QString::number((quintptr)this);
+    QString message = "Export finished.";
+    bool ok = true;
+
+    QFile file(targetOptions.path);
+    {
+        QSqlDatabase source = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        source.setDatabaseName(sourcePath);
+        source.setConnectOptions("QSQLITE_OPEN_READONLY");
+
+        if (!source.open())
+        {
+            ok = false;
+            message = "Could not open database for export !";
+        }
+        else if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        {
+            ok = false;
+            message = "Could not create export file !";
+        }
+        else
+        {
+            bool hasTimeKey = source.record("database").indexOf("TimeKey") >= 0;
+
+            // rowid range at the beginning of the export -> used for progress
+            QSqlQuery rangeQuery(source);
+            rangeQuery.exec("SELECT MIN(rowid), MAX(rowid) FROM database;");
+            qint64 firstRow = 0;
+            qint64 lastRow = 0;
+            if (rangeQuery.next())
+            {
+                firstRow = rangeQuery.value(0).toLongLong();
+                lastRow = rangeQuery.value(1).toLongLong();
+            }
+
+            // create script for the chunk query
+            QString script = "SELECT rowid, Timestamp, SequenceNumber, Note, Property, Value FROM database "
+                             "WHERE rowid > ? AND rowid <= ?";
+            if (!targetOptions.property.isEmpty())
+                script += " AND Property = ?";
+            if (targetOptions.useTimeRange && hasTimeKey)
+                script += " AND TimeKey BETWEEN ? AND ?";
+            script += " ORDER BY rowid LIMIT ?;";
+
+            QSqlQuery query(source);
+            query.setForwardOnly(true); // no result caching
+            query.prepare(script);
+
+            QByteArray buffer;
+            buffer.reserve(WriteBufferSize + 4096);
+            buffer += "<TimeStamp>,<Sequence Number>,<Keyword>,<Property>,<Value>\n";
+
+            qint64 lastExported = firstRow - 1;
+            int lastPercent = -1;
+            bool moreRows = true;
+
+            while (moreRows && ok)
+            {
+                if (isCancelled())
+                {
+                    ok = false;
+                    message = "Export cancelled.";
+                    break;
+                }
+
+                query.addBindValue(lastExported);
+                query.addBindValue(lastRow);
+                if (!targetOptions.property.isEmpty())
+                    query.addBindValue(targetOptions.property);
+                if (targetOptions.useTimeRange && hasTimeKey)
+                {
+                    query.addBindValue(targetOptions.fromKey);
+                    query.addBindValue(targetOptions.toKey);
+                }
+                query.addBindValue(ExportChunkSize);
+
+                if (!query.exec())
+                {
+                    ok = false;
+                    message = "An Error occured while reading database !";
+                    break;
+                }
+
+                int rows = 0;
+                while (query.next()) // for each row in the chunk
+                {
+                    rows++;
+                    lastExported = query.value(0).toLongLong();
+
+                    QString timestamp = query.value(1).toString();
+                    if (targetOptions.useTimeRange && !hasTimeKey) // old database -> filter by parsing
+                    {
+                        double key = timeKeyFromString(timestamp);
+                        if (key < targetOptions.fromKey || key > targetOptions.toKey)
+                            continue;
+                    }
+
+                    int split = timestamp.lastIndexOf('-'); // <date>-<time> -> <date> <time>
+                    if (split > 0)
+                        timestamp[split] = ' ';
+
+                    buffer += timestamp.toUtf8();
+                    buffer += ',';
+                    buffer += query.value(2).toString().toUtf8();
+                    buffer += ',';
+                    buffer += query.value(3).toString().toUtf8();
+                    buffer += ',';
+                    buffer += query.value(4).toString().toUtf8();
+                    buffer += ',';
+                    buffer += query.value(5).toString().trimmed().toUtf8(); // value is stored with line ending
+                    buffer += '\n';
+
+                    if (buffer.size() >= WriteBufferSize) // flush full buffer
+                    {
+                        file.write(buffer);
+                        buffer.resize(0);
+                    }
+                }
+                query.finish();
+
+                moreRows = (rows == ExportChunkSize);
+
+                // progress according to rowid position
+                int percent = (lastRow > firstRow) ? (int)(100 * (lastExported - firstRow) / (lastRow - firstRow)) : 100;
+                if (!moreRows)
+                    percent = 100;
+                if (percent != lastPercent)
+                {
+                    lastPercent = percent;
+                    emit progress(percent);
+                }
+            }
+
+            if (ok)
+            {
+                file.write(buffer);
+                if (file.error() != QFile::NoError)
+                {
+                    ok = false;
+                    message = "An Error occured while writing export file !";
+                }
+            }
+            file.close();
+            if (!ok) // remove partial file
+                file.remove();
+        }
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+
+    emit finished(ok, message);
+}
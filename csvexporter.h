@@ -0,0 +1,28 @@
+#ifndef CSVEXPORTER_H
+#define CSVEXPORTER_H
+
+#include <QString>
+#include "sessionexporter.h"
+
+/*
+ * Worker exporting session database to csv file.
+ *
+ * Runs on its own thread with its own database connection. Rows are read
+ * in chunks ordered by rowid and written through a fixed size buffer, so memory
+ * use does not depend on the session size.
+ */
+class CsvExporter : public SessionExporter
+{
+    Q_OBJECT
+
+public:
+    CsvExporter(QString databasePath, exportOptions options, QObject *parent = nullptr);
+
+public slots:
+    void run() override; // exports the database, emits finished at the end
+
+private:
+    QString sourcePath;
+};
+
+#endif // CSVEXPORTER_H
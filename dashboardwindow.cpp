@@ -0,0 +1,396 @@
+#include "dashboardwindow.h"
+#include "ui_dashboardwindow.h"
+#include "propertyregistry.h"
+
+// ---- Definitions ---- //
+
+#define ValueMargin 0.05 ///< Part of the value range added above and below when scaling
+
+//  -----------      ----------------                Constructor Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Constructor
+ *
+ * Given properties are checked, other properties of the main window are listed unchecked.
+ *
+ * @code {.c++}
+ * DashboardWindow::DashboardWindow(TelemetryStore *store, TelemetryBus *bus, QStandardItemModel *mainProperties, const QVector<int> &properties, QWidget *parent)
+ * @endcode
+ */
+DashboardWindow::DashboardWindow(TelemetryStore *store, TelemetryBus *bus, QStandardItemModel *mainProperties, const QVector<int> &properties, QWidget *parent)
+    : QWidget(parent), ui(new Ui::DashboardWindow), targetStore(store), targetBus(bus), targetModelProperties(mainProperties)
+{
+    ui->setupUi(this);
+    setAttribute(Qt::WA_DeleteOnClose);
+
+    channelsModel = new QStandardItemModel(this);
+    for (int i = 0; i < properties.size(); i++)
+    {
+        QStandardItem *item = new QStandardItem(PropertyRegistry::instance().name(properties[i]));
+        item->setData(properties[i], Qt::UserRole);
+        item->setCheckable(true);
+        item->setCheckState(Qt::Checked);
+        channelsModel->appendRow(item);
+    }
+    ui->Channels_listView->setModel(channelsModel);
+    updateChannels();
+
+    marginGroup = new QCPMarginGroup(ui->Dashboard_customPlot);
+    timeTicker = QSharedPointer<TimeAxisTicker>(new TimeAxisTicker);
+    ui->Dashboard_customPlot->setInteractions(QCP::iRangeDrag | QCP::iRangeZoom);
+    ui->Dashboard_customPlot->plotLayout()->setRowSpacing(0);
+
+    setupRows(); // rows are fitted to the received samples
+}
+
+/**
+ * @brief Destructor
+ *
+ * @code {.c++}
+ * DashboardWindow::~DashboardWindow()
+ * @endcode
+ */
+DashboardWindow::~DashboardWindow()
+{
+    targetBus->unsubscribe(this);
+    delete ui;
+}
+
+//  -----------      ----------------                Row Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Add new properties to the channel list
+ *
+ * @code {.c++}
+ * DashboardWindow::updateChannels()
+ * @endcode
+ */
+void DashboardWindow::updateChannels()
+{
+    for (int i = 0; i < targetModelProperties->rowCount(); i++)
+    {
+        QVariant id = targetModelProperties->item(i, 0)->data(Qt::UserRole); // header row has no id
+        if (!id.isValid())
+            continue;
+
+        bool listed = false;
+        for (int j = 0; j < channelsModel->rowCount() && !listed; j++)
+            listed = channelsModel->item(j)->data(Qt::UserRole).toInt() == id.toInt();
+        if (listed)
+            continue;
+
+        QStandardItem *item = new QStandardItem(PropertyRegistry::instance().name(id.toInt()));
+        item->setData(id, Qt::UserRole);
+        item->setCheckable(true);
+        item->setCheckState(Qt::Unchecked);
+        channelsModel->appendRow(item);
+    }
+}
+
+/**
+ * @brief Build one row per checked property
+ *
+ * Graphs are removed before their axis rects, graphs must not outlive their axes.
+ * Only the bottom row shows time labels, the others share its range.
+ *
+ * @code {.c++}
+ * DashboardWindow::setupRows()
+ * @endcode
+ */
+void DashboardWindow::setupRows()
+{
+    static const QColor colors[] = {QColor(31, 119, 180), QColor(214, 39, 40), QColor(44, 160, 44), QColor(255, 127, 14), QColor(148, 103, 189), QColor(140, 86, 75)};
+
+    QCustomPlot *plot = ui->Dashboard_customPlot;
+    QCPRange timeRange = rows.isEmpty() ? QCPRange() : rows.first().rect->axis(QCPAxis::atBottom)->range();
+
+    targetBus->unsubscribe(this);
+    plot->clearPlottables();
+    plot->clearItems();
+    plot->plotLayout()->clear();
+    rows.clear();
+
+    for (int i = 0; i < channelsModel->rowCount(); i++)
+    {
+        if (channelsModel->item(i)->checkState() != Qt::Checked)
+            continue;
+
+        dashboardRow row;
+        row.property = channelsModel->item(i)->data(Qt::UserRole).toInt();
+        row.rect = new QCPAxisRect(plot);
+        plot->plotLayout()->addElement(rows.size(), 0, row.rect);
+        row.rect->setMarginGroup(QCP::msLeft | QCP::msRight, marginGroup);
+        row.rect->setRangeDrag(Qt::Horizontal);
+        row.rect->setRangeZoom(Qt::Horizontal);
+
+        QCPAxis *timeAxis = row.rect->axis(QCPAxis::atBottom);
+        timeAxis->setTicker(timeTicker);
+        timeAxis->setTickLabels(false);
+        connect(timeAxis, SIGNAL(rangeChanged(QCPRange)), this, SLOT(onTimeRangeChanged(QCPRange)));
+
+        QCPAxis *valueAxis = row.rect->axis(QCPAxis::atLeft);
+        valueAxis->setLabel(PropertyRegistry::instance().name(row.property));
+        valueAxis->ticker()->setTickCount(4);
+
+        row.graph = plot->addGraph(timeAxis, valueAxis);
+        row.graph->setPen(QPen(colors[rows.size() % 6])); // rows are told apart by color
+
+        targetBus->subscribe(this, row.property);
+        rows.append(row);
+        copyNewSamples(rows.last());
+    }
+
+    if (rows.isEmpty())
+    {
+        plot->replot();
+        return;
+    }
+
+    rows.last().rect->axis(QCPAxis::atBottom)->setTickLabels(true);
+    rows.last().rect->axis(QCPAxis::atBottom)->setLabel("Time");
+    if (timeRange.size() > 0)
+        onTimeRangeChanged(timeRange);
+    else
+        on_Fit_pushButton_clicked();
+    plot->replot();
+}
+
+/**
+ * @brief Copy new samples of the row
+ *
+ * @code {.c++}
+ * DashboardWindow::copyNewSamples(dashboardRow &row)
+ * @endcode
+ */
+void DashboardWindow::copyNewSamples(dashboardRow &row)
+{
+    int count = targetStore->sampleCount(row.property); // count first, every counted sample is inside the snapshot
+    if (count <= row.copied)
+        return;
+
+    QVector<QSharedPointer<sampleChunk>> chunks = targetStore->snapshot(row.property);
+    int chunkSize = TelemetryStore::chunkSize();
+
+    QVector<QCPGraphData> samples;
+    samples.reserve(count - row.copied);
+    for (int i = row.copied; i < count; i++)
+    {
+        const sampleChunk *chunk = chunks.at(i / chunkSize).data();
+        samples.append(QCPGraphData(chunk->keys[i % chunkSize], chunk->values[i % chunkSize]));
+    }
+
+    row.graph->data()->add(samples, true);
+    row.copied = count;
+}
+
+/**
+ * @brief Receive samples from the telemetry bus
+ *
+ * Rows of the delivered properties are updated, dashboard is redrawn once with the next frame.
+ *
+ * @code {.c++}
+ * DashboardWindow::deliver(const QVector<telemetrySample> &samples)
+ * @endcode
+ */
+void DashboardWindow::deliver(const QVector<telemetrySample> &samples)
+{
+    int lastProperty = NoProperty;
+    for (int i = 0; i < samples.size(); i++)
+    {
+        if (samples.at(i).property == lastProperty) // consecutive samples of the same property
+            continue;
+        lastProperty = samples.at(i).property;
+
+        for (int r = 0; r < rows.size(); r++)
+        {
+            if (rows[r].property == lastProperty)
+                copyNewSamples(rows[r]);
+        }
+    }
+
+    if (ui->Follow_checkBox->isChecked())
+        followLatest();
+    if (ui->AutoScale_checkBox->isChecked())
+        autoScaleRows();
+    ui->Dashboard_customPlot->replot(QCustomPlot::rpQueuedReplot);
+}
+
+//  -----------      ----------------                Axis Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Synchronize time axes
+ *
+ * Called when the time axis of any row changes by drag, zoom or code.
+ *
+ * @code {.c++}
+ * DashboardWindow::onTimeRangeChanged(const QCPRange &range)
+ * @endcode
+ */
+void DashboardWindow::onTimeRangeChanged(const QCPRange &range)
+{
+    if (syncing)
+        return;
+
+    syncing = true;
+    for (int i = 0; i < rows.size(); i++)
+        rows[i].rect->axis(QCPAxis::atBottom)->setRange(range);
+    syncing = false;
+
+    if (ui->AutoScale_checkBox->isChecked())
+        autoScaleRows();
+    ui->Dashboard_customPlot->replot(QCustomPlot::rpQueuedReplot);
+}
+
+/**
+ * @brief Keep newest sample visible
+ *
+ * Visible span is kept, range is moved so the newest sample is at the right edge.
+ *
+ * @code {.c++}
+ * DashboardWindow::followLatest()
+ * @endcode
+ */
+void DashboardWindow::followLatest()
+{
+    if (rows.isEmpty())
+        return;
+
+    bool found = false;
+    double latest = 0;
+    for (int i = 0; i < rows.size(); i++)
+    {
+        double first = 0;
+        double last = 0;
+        if (!targetStore->keyRange(rows[i].property, &first, &last))
+            continue;
+        latest = found ? qMax(latest, last) : last;
+        found = true;
+    }
+
+    QCPRange range = rows.first().rect->axis(QCPAxis::atBottom)->range();
+    if (found && latest > range.upper)
+        onTimeRangeChanged(QCPRange(latest - range.size(), latest));
+}
+
+/**
+ * @brief Fit value axis of each row
+ *
+ * Bounds come from the chunk summaries of the store, see TelemetryStore::valueRange.
+ *
+ * @code {.c++}
+ * DashboardWindow::autoScaleRows()
+ * @endcode
+ */
+void DashboardWindow::autoScaleRows()
+{
+    if (rows.isEmpty())
+        return;
+
+    QCPRange visible = rows.first().rect->axis(QCPAxis::atBottom)->range();
+    for (int i = 0; i < rows.size(); i++)
+    {
+        double minValue = 0;
+        double maxValue = 0;
+        if (!targetStore->valueRange(rows[i].property, visible.lower, visible.upper, &minValue, &maxValue))
+            continue;
+
+        double margin = (maxValue - minValue) * ValueMargin;
+        if (margin <= 0) // constant value
+            margin = qMax(1.0, qAbs(minValue) * ValueMargin);
+        rows[i].rect->axis(QCPAxis::atLeft)->setRange(minValue - margin, maxValue + margin);
+    }
+}
+
+//  -----------      ----------------                Ui Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Channel list clicked
+ *
+ * Rows are built again when a channel is checked or unchecked.
+ *
+ * @code {.c++}
+ * DashboardWindow::on_Channels_listView_clicked(const QModelIndex &index)
+ * @endcode
+ */
+void DashboardWindow::on_Channels_listView_clicked(const QModelIndex &index)
+{
+    Q_UNUSED(index);
+
+    int checked = 0;
+    for (int i = 0; i < channelsModel->rowCount(); i++)
+    {
+        if (channelsModel->item(i)->checkState() == Qt::Checked)
+            checked++;
+    }
+
+    bool changed = checked != rows.size();
+    for (int i = 0, r = 0; i < channelsModel->rowCount() && !changed; i++)
+    {
+        if (channelsModel->item(i)->checkState() == Qt::Checked)
+            changed = channelsModel->item(i)->data(Qt::UserRole).toInt() != rows[r++].property;
+    }
+
+    if (changed)
+        setupRows();
+}
+
+/**
+ * @brief Refresh button
+ *
+ * @code {.c++}
+ * DashboardWindow::on_Refresh_pushButton_clicked()
+ * @endcode
+ */
+void DashboardWindow::on_Refresh_pushButton_clicked()
+{
+    updateChannels();
+}
+
+/**
+ * @brief Fit button
+ *
+ * Time axis covers every sample of the plotted properties, value axes are fitted to them.
+ *
+ * @code {.c++}
+ * DashboardWindow::on_Fit_pushButton_clicked()
+ * @endcode
+ */
+void DashboardWindow::on_Fit_pushButton_clicked()
+{
+    bool found = false;
+    double lower = 0;
+    double upper = 0;
+    for (int i = 0; i < rows.size(); i++)
+    {
+        double first = 0;
+        double last = 0;
+        if (!targetStore->keyRange(rows[i].property, &first, &last))
+            continue;
+        lower = found ? qMin(lower, first) : first;
+        upper = found ? qMax(upper, last) : last;
+        found = true;
+    }
+    if (!found)
+        return;
+
+    onTimeRangeChanged(QCPRange(lower - 1, upper + 1));
+    if (!ui->AutoScale_checkBox->isChecked()) // otherwise already scaled
+        autoScaleRows();
+    ui->Dashboard_customPlot->replot();
+}
+
+/**
+ * @brief Auto scale checkbox
+ *
+ * @code {.c++}
+ * DashboardWindow::on_AutoScale_checkBox_stateChanged(int arg1)
+ * @endcode
+ */
+void DashboardWindow::on_AutoScale_checkBox_stateChanged(int arg1)
+{
+    if (arg1 == Qt::Checked)
+    {
+        autoScaleRows();
+        ui->Dashboard_customPlot->replot();
+    }
+}
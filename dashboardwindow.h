@@ -0,0 +1,73 @@
+#ifndef DASHBOARDWINDOW_H
+#define DASHBOARDWINDOW_H
+
+#include <QWidget>
+#include <QVector>
+#include <QSharedPointer>
+#include <QStandardItemModel>
+#include "qcustomplot.h"
+#include "telemetrystore.h"
+#include "telemetrybus.h"
+#include "timeaxisticker.h"
+
+namespace Ui
+{
+    class DashboardWindow;
+}
+
+/*
+ * Several live properties stacked in one plot with a shared time axis.
+ *
+ * Each property has its own axis rect, left and right margins are aligned by a margin group.
+ * Time axes of the rows are kept in sync, so pan and zoom move every row. Window is subscribed
+ * once to the plotted properties, new samples are copied from the store and the whole dashboard
+ * is redrawn once per frame. Rows share a single time ticker, ticks are generated once per range.
+ */
+class DashboardWindow : public QWidget, public TelemetrySubscriber
+{
+    Q_OBJECT
+
+public:
+    DashboardWindow(TelemetryStore *store, TelemetryBus *bus, QStandardItemModel *mainProperties, const QVector<int> &properties, QWidget *parent = nullptr);
+    ~DashboardWindow();
+
+    void deliver(const QVector<telemetrySample> &samples) override; // new samples of the plotted properties
+
+private slots:
+    void onTimeRangeChanged(const QCPRange &range); // moves the time axis of every row
+
+    void on_Channels_listView_clicked(const QModelIndex &index);
+    void on_Refresh_pushButton_clicked();
+    void on_Fit_pushButton_clicked();
+    void on_AutoScale_checkBox_stateChanged(int arg1);
+
+private:
+    // -> single plotted property
+    struct dashboardRow
+    {
+        int property;
+        int copied = 0; // samples already copied from the store
+        QCPAxisRect *rect = nullptr;
+        QCPGraph *graph = nullptr;
+    };
+
+    void updateChannels();       // adds new properties of the main window to the list
+    void setupRows();            // one axis rect per checked property
+    void copyNewSamples(dashboardRow &row);
+    void followLatest();         // keeps the newest sample at the right edge
+    void autoScaleRows();        // value axes follow the visible samples
+
+    Ui::DashboardWindow *ui;
+
+    TelemetryStore *targetStore;
+    TelemetryBus *targetBus;
+    QStandardItemModel *targetModelProperties;
+    QStandardItemModel *channelsModel;
+
+    QVector<dashboardRow> rows;
+    QCPMarginGroup *marginGroup;
+    QSharedPointer<TimeAxisTicker> timeTicker; // shared by every row
+    bool syncing = false;                      // time axes are being updated by onTimeRangeChanged
+};
+
+#endif // DASHBOARDWINDOW_H
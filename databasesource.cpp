@@ -0,0 +1,373 @@
+#include "databasesource.h"
+#include "telemetry.h"
+
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QVariant>
+#include <algorithm>
+#include <cmath>
+
+// ---- Definitions ---- //
+
+#define PrefetchMargin 0.5        ///< Part of the visible range loaded additionally on each side
+#define CachedWindowLimit 16      ///< Loaded windows kept in memory, least recently used is evicted
+#define ConvertChunkSize 20000    ///< Rows converted at once while computing TimeKey of old databases
+
+/**
+ * @brief Numeric part of the stored value
+ *
+ * Values are stored as received, for example "25.4/C".
+ */
+static inline double sampleValue(const QSqlQuery &query)
+{
+    return query.value(1).toString().section('/', 0, 0).toDouble();
+}
+
+//  -----------      ----------------                Constructor Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Constructor
+ *
+ * @code {.c++}
+ * DatabaseSource::DatabaseSource()
+ * @endcode
+ */
+DatabaseSource::DatabaseSource()
+{
+}
+
+/**
+ * @brief Destructor
+ *
+ * Closes and removes the connection of this source.
+ *
+ * @code {.c++}
+ * DatabaseSource::~DatabaseSource()
+ * @endcode
+ */
+DatabaseSource::~DatabaseSource()
+{
+    windows.clear();
+    if (db.isValid())
+        db.close();
+    db = QSqlDatabase(); // connection must not be in use when removed
+
+    if (!connectionName.isEmpty())
+        QSqlDatabase::removeDatabase(connectionName);
+}
+
+//  -----------      ----------------                Database Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Open session database
+ *
+ * Opens own read only connection to the database, so archived, write protected and
+ * the running session's database can be opened without writing to them.
+ * Reads property names and key range of each property.
+ *
+ * @code {.c++}
+ * DatabaseSource::open(const QString &path)
+ * @endcode
+ */
+bool DatabaseSource::open(const QString &path)
+{
+    connectionName = "sessionSource" + QString::number((quintptr)this);
+    db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+    db.setDatabaseName(path);
+    db.setConnectOptions("QSQLITE_OPEN_READONLY");
+
+    if (!db.open() || !db.tables().contains("database"))
+        return false;
+
+    // older databases -> keys are computed into a temporary table, archive is not changed
+    if (db.record("database").indexOf("TimeKey") < 0 && !buildTimeKeys())
+        return false;
+
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT DISTINCT Property FROM " + sampleTable + " WHERE Property <> '' ORDER BY Property;"))
+        return false;
+
+    QStringList names;
+    while (query.next())
+        names.append(query.value(0).toString());
+    query.finish();
+
+    // first and last key of each property -> single index lookups
+    query.prepare("SELECT MIN(TimeKey), MAX(TimeKey) FROM " + sampleTable + " WHERE Property = ?;");
+    for (int i = 0; i < names.size(); i++)
+    {
+        query.addBindValue(names[i]);
+        if (!query.exec() || !query.next() || query.value(0).isNull())
+            continue;
+
+        propertyNames.append(names[i]);
+        propertyRanges.insert(names[i], QCPRange(query.value(0).toDouble(), query.value(1).toDouble()));
+        query.finish();
+    }
+    return true;
+}
+
+/**
+ * @brief Keys of an old database were computed
+ *
+ * Such sources are slow to open, they should be opened once and reused.
+ *
+ * @code {.c++}
+ * DatabaseSource::convertedKeys()
+ * @endcode
+ */
+bool DatabaseSource::convertedKeys() const
+{
+    return sampleTable != "database";
+}
+
+/**
+ * @brief Temporary keyed table of an old database
+ *
+ * Databases written before TimeKey column existed only have the timestamp text.
+ * Property, value and the key computed from the timestamp are copied in rowid chunks
+ * into a temporary table of this connection, then the index used for range queries is
+ * created on it. Temporary tables are writable on a read only connection and are
+ * dropped with the connection, so the archive itself is never written or locked.
+ *
+ * @code {.c++}
+ * DatabaseSource::buildTimeKeys()
+ * @endcode
+ */
+bool DatabaseSource::buildTimeKeys()
+{
+    QSqlQuery query(db);
+    if (!query.exec("CREATE TEMP TABLE keyed (Property TEXT, TimeKey REAL, Value TEXT);") || !db.transaction())
+        return false;
+
+    QSqlQuery select(db);
+    select.setForwardOnly(true);
+    select.prepare("SELECT rowid, Timestamp, Property, Value FROM database WHERE rowid > ? ORDER BY rowid LIMIT ?;");
+
+    QSqlQuery insert(db);
+    insert.prepare("INSERT INTO temp.keyed (Property, TimeKey, Value) VALUES (?, ?, ?);");
+
+    QVector<QVariantList> rows;
+    rows.reserve(ConvertChunkSize);
+    qint64 lastRow = 0;
+    bool moreRows = true;
+
+    while (moreRows)
+    {
+        select.addBindValue(lastRow);
+        select.addBindValue(ConvertChunkSize);
+        if (!select.exec())
+        {
+            db.rollback();
+            return false;
+        }
+
+        rows.resize(0);
+        while (select.next())
+        {
+            lastRow = select.value(0).toLongLong();
+            rows.append(QVariantList() << select.value(2) << timeKeyFromString(select.value(1).toString()) << select.value(3));
+        }
+        select.finish(); // reading is done before the chunk is written
+        moreRows = rows.size() == ConvertChunkSize;
+
+        for (int i = 0; i < rows.size(); i++)
+        {
+            insert.addBindValue(rows[i][0]);
+            insert.addBindValue(rows[i][1]);
+            insert.addBindValue(rows[i][2]);
+            if (!insert.exec())
+            {
+                db.rollback();
+                return false;
+            }
+        }
+    }
+
+    if (!query.exec("CREATE INDEX temp.KeyedPropertyTime ON keyed (Property, TimeKey);") || !db.commit())
+    {
+        db.rollback();
+        return false;
+    }
+    sampleTable = "temp.keyed";
+    return true;
+}
+
+//  -----------      ----------------                Sample Source Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Recorded property names
+ *
+ * @code {.c++}
+ * DatabaseSource::properties()
+ * @endcode
+ */
+QStringList DatabaseSource::properties() const
+{
+    return propertyNames;
+}
+
+/**
+ * @brief First and last key of the property
+ *
+ * @code {.c++}
+ * DatabaseSource::keyRange(const QString &property)
+ * @endcode
+ */
+QCPRange DatabaseSource::keyRange(const QString &property) const
+{
+    return propertyRanges.value(property, QCPRange(0, 0));
+}
+
+/**
+ * @brief Samples of the visible range
+ *
+ * Served from the loaded window of the property when it covers the range with
+ * enough resolution, otherwise a new window with prefetch margin is loaded.
+ * One sample on each side of the range is added so lines reach the plot borders.
+ *
+ * @code {.c++}
+ * DatabaseSource::loadRange(const QString &property, double lower, double upper, int maxPoints)
+ * @endcode
+ */
+QVector<QCPGraphData> DatabaseSource::loadRange(const QString &property, double lower, double upper, int maxPoints)
+{
+    QVector<QCPGraphData> result;
+    if (!propertyRanges.contains(property))
+        return result;
+
+    maxPoints = qMax(2, maxPoints);
+    double span = upper - lower;
+    if (span <= 0)
+        span = 1;
+    double wanted = 2 * span / maxPoints; // bucket width giving maxPoints samples on the screen
+
+    loadedWindow &window = windows[property];
+    if (window.lastUse == 0 || lower < window.lower || upper > window.upper || window.resolution > wanted)
+    {
+        double margin = span * PrefetchMargin;
+        int buckets = (int)std::ceil((span + 2 * margin) / wanted);
+        loadWindow(property, lower - margin, upper + margin, buckets, &window);
+    }
+    window.lastUse = ++useCounter;
+
+    const QVector<QCPGraphData> &samples = window.samples;
+    int first = std::lower_bound(samples.constBegin(), samples.constEnd(), lower, [](const QCPGraphData &sample, double key) { return sample.key < key; }) - samples.constBegin();
+    int last = std::upper_bound(samples.constBegin(), samples.constEnd(), upper, [](double key, const QCPGraphData &sample) { return key < sample.key; }) - samples.constBegin();
+
+    if (first > 0) // sample before the range
+        result.append(samples[first - 1]);
+
+    if (window.resolution == 0 && last - first > maxPoints) // every sample was loaded -> decimate the visible part
+    {
+        MinMaxDecimator decimator(lower, upper, maxPoints / 2, &result);
+        for (int i = first; i < last; i++)
+            decimator.add(samples[i].key, samples[i].value);
+        decimator.finish();
+    }
+    else
+    {
+        result.reserve(result.size() + last - first + 1);
+        for (int i = first; i < last; i++)
+            result.append(samples[i]);
+    }
+
+    if (last < samples.size()) // sample after the range
+        result.append(samples[last]);
+
+    evictWindows();
+    return result;
+}
+
+/**
+ * @brief Load window of samples from database
+ *
+ * Number of samples in the window is counted on the index first. If it is larger than
+ * the bucket count allows, rows are decimated while reading so memory use stays
+ * limited by the plot width instead of the session size.
+ *
+ * @code {.c++}
+ * DatabaseSource::loadWindow(const QString &property, double lower, double upper, int buckets, loadedWindow *window)
+ * @endcode
+ */
+void DatabaseSource::loadWindow(const QString &property, double lower, double upper, int buckets, loadedWindow *window)
+{
+    window->lower = lower;
+    window->upper = upper;
+    window->samples.clear(); // frees previous window
+    buckets = qMax(1, buckets);
+
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+
+    qint64 count = 0;
+    query.prepare("SELECT COUNT(*) FROM " + sampleTable + " WHERE Property = ? AND TimeKey BETWEEN ? AND ?;");
+    query.addBindValue(property);
+    query.addBindValue(lower);
+    query.addBindValue(upper);
+    if (query.exec() && query.next())
+        count = query.value(0).toLongLong();
+    query.finish();
+
+    window->resolution = count > 2 * buckets ? (upper - lower) / buckets : 0;
+
+    // sample before the window
+    query.prepare("SELECT TimeKey, Value FROM " + sampleTable + " WHERE Property = ? AND TimeKey < ? ORDER BY TimeKey DESC LIMIT 1;");
+    query.addBindValue(property);
+    query.addBindValue(lower);
+    if (query.exec() && query.next())
+        window->samples.append(QCPGraphData(query.value(0).toDouble(), sampleValue(query)));
+    query.finish();
+
+    // samples inside the window
+    query.prepare("SELECT TimeKey, Value FROM " + sampleTable + " WHERE Property = ? AND TimeKey BETWEEN ? AND ? ORDER BY TimeKey;");
+    query.addBindValue(property);
+    query.addBindValue(lower);
+    query.addBindValue(upper);
+    if (query.exec())
+    {
+        if (window->resolution > 0)
+        {
+            MinMaxDecimator decimator(lower, upper, buckets, &window->samples);
+            while (query.next())
+                decimator.add(query.value(0).toDouble(), sampleValue(query));
+            decimator.finish();
+        }
+        else
+        {
+            window->samples.reserve(count + 2);
+            while (query.next())
+                window->samples.append(QCPGraphData(query.value(0).toDouble(), sampleValue(query)));
+        }
+    }
+    query.finish();
+
+    // sample after the window
+    query.prepare("SELECT TimeKey, Value FROM " + sampleTable + " WHERE Property = ? AND TimeKey > ? ORDER BY TimeKey LIMIT 1;");
+    query.addBindValue(property);
+    query.addBindValue(upper);
+    if (query.exec() && query.next())
+        window->samples.append(QCPGraphData(query.value(0).toDouble(), sampleValue(query)));
+}
+
+/**
+ * @brief Evict least recently used windows
+ *
+ * @code {.c++}
+ * DatabaseSource::evictWindows()
+ * @endcode
+ */
+void DatabaseSource::evictWindows()
+{
+    while (windows.size() > CachedWindowLimit)
+    {
+        QHash<QString, loadedWindow>::iterator oldest = windows.begin();
+        for (QHash<QString, loadedWindow>::iterator it = windows.begin(); it != windows.end(); ++it)
+        {
+            if (it.value().lastUse < oldest.value().lastUse)
+                oldest = it;
+        }
+        windows.erase(oldest);
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef DATABASESOURCE_H
+#define DATABASESOURCE_H
+
+#include <QHash>
+#include <QSqlDatabase>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "samplesource.h"
+
+/*
+ * Recorded session database (*.db) as sample source.
+ *
+ * Only the requested key range is read using the (Property, TimeKey) index,
+ * extended with a prefetch margin on both sides so small pans are served from memory.
+ * One loaded window is kept per property, least recently used windows are evicted.
+ * Archives are opened read only and never modified. Databases created before TimeKey
+ * column existed are read through a temporary table of this connection with computed keys.
+ */
+class DatabaseSource : public SampleSource
+{
+public:
+    DatabaseSource();
+    ~DatabaseSource();
+
+    bool open(const QString &path); // opens read only connection, old databases get a temporary keyed table
+    bool convertedKeys() const;     // keys of an old database were computed when opened
+
+    QStringList properties() const override;
+    QCPRange keyRange(const QString &property) const override;
+    QVector<QCPGraphData> loadRange(const QString &property, double lower, double upper, int maxPoints) override;
+
+private:
+    // -> samples of a property loaded from the database
+    struct loadedWindow
+    {
+        double lower = 0;
+        double upper = 0;
+        double resolution = 0; // bucket width of decimated samples, 0 -> every sample
+        quint64 lastUse = 0;
+        QVector<QCPGraphData> samples;
+    };
+
+    bool buildTimeKeys();                                                                       // temporary table with TimeKey and index
+    void loadWindow(const QString &property, double lower, double upper, int buckets, loadedWindow *window);
+    void evictWindows();                                                                        // keeps number of windows limited
+
+    QString connectionName;
+    QSqlDatabase db;
+    QString sampleTable = "database"; // table read by the queries, temporary table for old databases
+
+    QStringList propertyNames;
+    QHash<QString, QCPRange> propertyRanges;
+    QHash<QString, loadedWindow> windows;
+    quint64 useCounter = 0;
+};
+
+#endif // DATABASESOURCE_H
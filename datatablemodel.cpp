@@ -0,0 +1,166 @@
+#include "datatablemodel.h"
+#include "telemetryparser.h"
+
+// ---- Definitions ---- //
+
+#define DataTableColumns 6 ///< Fields of a telemetry line
+
+static const char *const columnNames[DataTableColumns] = {"<Timestamp>", "<Timestamp>", "<Sequence Number>", "note", "<Property>", "<Message>"};
+
+//  -----------      ----------------                Constructor Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Constructor
+ *
+ * @code {.c++}
+ * DataTableModel::DataTableModel(LogStore *store, QObject *parent)
+ * @endcode
+ */
+DataTableModel::DataTableModel(LogStore *store, QObject *parent) : QAbstractTableModel(parent), targetStore(store)
+{
+}
+
+//  -----------      ----------------                Model Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Number of rows shown at view
+ *
+ * @code {.c++}
+ * DataTableModel::rowCount(const QModelIndex &parent)
+ * @endcode
+ */
+int DataTableModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return visibleCount;
+}
+
+/**
+ * @brief Number of columns
+ *
+ * @code {.c++}
+ * DataTableModel::columnCount(const QModelIndex &parent)
+ * @endcode
+ */
+int DataTableModel::columnCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return DataTableColumns;
+}
+
+/**
+ * @brief Data of the cell
+ *
+ * Called by the view for visible cells only.
+ *
+ * @code {.c++}
+ * DataTableModel::data(const QModelIndex &index, int role)
+ * @endcode
+ */
+QVariant DataTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || role != Qt::DisplayRole)
+        return QVariant();
+
+    const logLine &line = targetStore->line(rows.at(index.row()));
+    telemetryRecord record;
+    TelemetryParser::tokenize(line.text, line.length, &record);
+
+    if (index.column() >= record.count || index.column() >= MaxRecordTokens)
+        return QVariant();
+    return record.token(index.column());
+}
+
+/**
+ * @brief Column names
+ *
+ * @code {.c++}
+ * DataTableModel::headerData(int section, Qt::Orientation orientation, int role)
+ * @endcode
+ */
+QVariant DataTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole && section >= 0 && section < DataTableColumns)
+        return QString(columnNames[section]);
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+//  -----------      ----------------                Row Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Queue line as new row
+ *
+ * @code {.c++}
+ * DataTableModel::appendLine(int line)
+ * @endcode
+ */
+void DataTableModel::appendLine(int line)
+{
+    rows.append(line);
+}
+
+/**
+ * @brief Show queued rows
+ *
+ * Called once after each receive batch, view is notified once for all new rows.
+ * Rows of lines dropped by the log store are removed first.
+ *
+ * @code {.c++}
+ * DataTableModel::flushRows()
+ * @endcode
+ */
+void DataTableModel::flushRows()
+{
+    int firstLine = targetStore->firstLine();
+    int dropped = 0;
+    while (dropped < rows.size() && rows.at(dropped) < firstLine)
+        dropped++;
+    if (dropped > 0)
+    {
+        int shown = qMin(dropped, visibleCount);
+        if (shown > 0)
+            beginRemoveRows(QModelIndex(), 0, shown - 1);
+        rows.remove(0, dropped);
+        visibleCount -= shown;
+        if (shown > 0)
+            endRemoveRows();
+    }
+
+    if (rows.size() == visibleCount)
+        return;
+
+    beginInsertRows(QModelIndex(), visibleCount, rows.size() - 1);
+    visibleCount = rows.size();
+    endInsertRows();
+}
+
+/**
+ * @brief Receive batch from the telemetry bus
+ *
+ * @code {.c++}
+ * DataTableModel::deliver(const QVector<telemetrySample> &samples)
+ * @endcode
+ */
+void DataTableModel::deliver(const QVector<telemetrySample> &samples)
+{
+    for (int i = 0; i < samples.size(); i++)
+        appendLine(samples.at(i).line);
+    flushRows();
+}
+
+/**
+ * @brief Remove every row
+ *
+ * @code {.c++}
+ * DataTableModel::clearRows()
+ * @endcode
+ */
+void DataTableModel::clearRows()
+{
+    beginResetModel();
+    rows.clear();
+    visibleCount = 0;
+    endResetModel();
+}
@@ -0,0 +1,42 @@
+#ifndef DATATABLEMODEL_H
+#define DATATABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QVector>
+#include "logstore.h"
+#include "telemetrybus.h"
+
+/*
+ * Table model of received telemetry lines.
+ *
+ * Rows only keep the index of the line in the log store, columns are
+ * split from the stored text when the view asks for a visible cell.
+ * New rows are queued and inserted with one notification per receive batch.
+ * Rows of lines dropped by the log store are removed, so the table is bounded like the store.
+ * Subscribed to every property on the telemetry bus.
+ */
+class DataTableModel : public QAbstractTableModel, public TelemetrySubscriber
+{
+    Q_OBJECT
+
+public:
+    explicit DataTableModel(LogStore *store, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    void appendLine(int line); // queues log line as new row
+    void flushRows();          // shows queued rows, removes rows of dropped lines
+    void clearRows();          // removes every row, log store is not affected
+
+    void deliver(const QVector<telemetrySample> &samples) override; // adds lines of the samples as rows
+
+private:
+    LogStore *targetStore;
+    QVector<int> rows;    // log line index of each row
+    int visibleCount = 0; // rows shown at view, rest is queued
+};
+
+#endif // DATATABLEMODEL_H
@@ -0,0 +1,684 @@
+#include "derivedchannels.h"
+
+#include <QRegularExpression>
+#include <cmath>
+
+/*
+ * Recursive descent compiler of a channel expression.
+ * Instructions are appended in postfix order while parsing, depth of the
+ * evaluation stack is tracked so it can be checked against the fixed stack.
+ */
+struct expressionCompiler
+{
+public:
+    expressionCompiler(const QString &source, derivedChannel *target) : text(source), channel(target) {}
+
+    QString text;
+    int position = 0;
+    derivedChannel *channel;
+    QString error;
+    int depth = 0;
+    int maxDepth = 0;
+
+    bool expression();
+    bool term();
+    bool unary();
+    bool power();
+    bool primary();
+    bool function(const QString &word);
+    bool name(QString *result);
+    bool number(double *result);
+
+    QChar peek();
+    bool accept(QChar c);
+    void append(int op, double constant = 0, int input = -1);
+    int inputOf(const QString &property, double window);
+    bool fail(const QString &message);
+};
+
+/**
+ * @brief Character allowed in a property name without quotes
+ */
+static inline bool nameCharacter(QChar c)
+{
+    return c.isLetterOrNumber() || c == '_' || c == '.' || c == ':';
+}
+
+//  -----------      ----------------                Compiler Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Next character after spaces, null at the end
+ */
+QChar expressionCompiler::peek()
+{
+    while (position < text.size() && text[position].isSpace())
+        position++;
+    return position < text.size() ? text[position] : QChar();
+}
+
+/**
+ * @brief Skip the character if it is next
+ */
+bool expressionCompiler::accept(QChar c)
+{
+    if (peek() != c)
+        return false;
+    position++;
+    return true;
+}
+
+/**
+ * @brief Append instruction and track stack depth
+ */
+void expressionCompiler::append(int op, double constant, int input)
+{
+    channel->program.append(expressionInstruction(op, constant, input));
+    if (op == opConstant || op == opInput)
+        depth++;
+    else if (op == opAdd || op == opSubtract || op == opMultiply || op == opDivide || op == opPower || op == opMin || op == opMax)
+        depth--;
+    maxDepth = qMax(maxDepth, depth);
+}
+
+/**
+ * @brief Input slot of the property, same property and window share a slot
+ */
+int expressionCompiler::inputOf(const QString &property, double window)
+{
+    int id = PropertyRegistry::instance().intern(property);
+    for (int i = 0; i < channel->inputs.size(); i++)
+    {
+        if (channel->inputs[i].property == id && channel->inputs[i].window == window)
+            return i;
+    }
+
+    channelInput input;
+    input.property = id;
+    input.window = window;
+    channel->inputs.append(input);
+    return channel->inputs.size() - 1;
+}
+
+/**
+ * @brief Set error at the current position
+ */
+bool expressionCompiler::fail(const QString &message)
+{
+    if (error.isEmpty())
+        error = message + " at column " + QString::number(position + 1);
+    return false;
+}
+
+/**
+ * @brief expression := term (('+' | '-') term)*
+ */
+bool expressionCompiler::expression()
+{
+    if (!term())
+        return false;
+    while (true)
+    {
+        if (accept('+'))
+        {
+            if (!term())
+                return false;
+            append(opAdd);
+        }
+        else if (accept('-'))
+        {
+            if (!term())
+                return false;
+            append(opSubtract);
+        }
+        else
+        {
+            return true;
+        }
+    }
+}
+
+/**
+ * @brief term := unary (('*' | '/') unary)*
+ */
+bool expressionCompiler::term()
+{
+    if (!unary())
+        return false;
+    while (true)
+    {
+        if (accept('*'))
+        {
+            if (!unary())
+                return false;
+            append(opMultiply);
+        }
+        else if (accept('/'))
+        {
+            if (!unary())
+                return false;
+            append(opDivide);
+        }
+        else
+        {
+            return true;
+        }
+    }
+}
+
+/**
+ * @brief unary := ('-' | '+') unary | power
+ */
+bool expressionCompiler::unary()
+{
+    if (accept('-'))
+    {
+        if (!unary())
+            return false;
+        append(opNegate);
+        return true;
+    }
+    if (accept('+'))
+        return unary();
+    return power();
+}
+
+/**
+ * @brief power := primary ('^' unary)?, right associative
+ */
+bool expressionCompiler::power()
+{
+    if (!primary())
+        return false;
+    if (accept('^'))
+    {
+        if (!unary())
+            return false;
+        append(opPower);
+    }
+    return true;
+}
+
+/**
+ * @brief primary := number | '(' expression ')' | function | property
+ */
+bool expressionCompiler::primary()
+{
+    QChar c = peek();
+    if (c.isNull())
+        return fail("Expression ends early");
+
+    if (accept('('))
+    {
+        if (!expression())
+            return false;
+        return accept(')') || fail("Missing )");
+    }
+
+    if (c.isDigit() || c == '.')
+    {
+        double value = 0;
+        if (!number(&value))
+            return false;
+        append(opConstant, value);
+        return true;
+    }
+
+    QString word;
+    if (!name(&word))
+        return false;
+    if (c != '"' && peek() == '(') // quoted names are never functions
+        return function(word);
+
+    append(opInput, 0, inputOf(word, 0));
+    return true;
+}
+
+/**
+ * @brief Function call, name is already read
+ */
+bool expressionCompiler::function(const QString &word)
+{
+    accept('(');
+
+    if (word == "avg") // avg(<property>, <seconds>)
+    {
+        QString property;
+        double window = 0;
+        if (!name(&property) || !(accept(',') || fail("Missing ,")) || !number(&window))
+            return false;
+        if (window <= 0)
+            return fail("Window of avg must be positive");
+        append(opInput, 0, inputOf(property, window));
+        return accept(')') || fail("Missing )");
+    }
+
+    int op = -1;
+    int arguments = 1;
+    if (word == "abs")
+        op = opAbs;
+    else if (word == "sqrt")
+        op = opSqrt;
+    else if (word == "exp")
+        op = opExp;
+    else if (word == "log")
+        op = opLog;
+    else if (word == "sin")
+        op = opSin;
+    else if (word == "cos")
+        op = opCos;
+    else if (word == "min" || word == "max")
+    {
+        op = word == "min" ? opMin : opMax;
+        arguments = 2;
+    }
+    else
+        return fail("Unknown function " + word);
+
+    for (int i = 0; i < arguments; i++)
+    {
+        if (i > 0 && !accept(','))
+            return fail("Missing ,");
+        if (!expression())
+            return false;
+    }
+    append(op);
+    return accept(')') || fail("Missing )");
+}
+
+/**
+ * @brief Property name, plain or in double quotes
+ */
+bool expressionCompiler::name(QString *result)
+{
+    if (accept('"'))
+    {
+        int end = text.indexOf('"', position);
+        if (end < 0)
+            return fail("Missing closing quote");
+        *result = text.mid(position, end - position);
+        position = end + 1;
+        return !result->isEmpty() || fail("Empty name");
+    }
+
+    QChar c = peek();
+    if (!c.isLetter() && c != '_')
+        return fail(QString("Unexpected '") + c + "'");
+
+    int start = position;
+    while (position < text.size() && nameCharacter(text[position]))
+        position++;
+    *result = text.mid(start, position - start);
+    return true;
+}
+
+/**
+ * @brief Decimal number with optional exponent
+ */
+bool expressionCompiler::number(double *result)
+{
+    peek();
+    int start = position;
+    while (position < text.size() && (text[position].isDigit() || text[position] == '.'))
+        position++;
+    if (position < text.size() && (text[position] == 'e' || text[position] == 'E'))
+    {
+        position++;
+        if (position < text.size() && (text[position] == '+' || text[position] == '-'))
+            position++;
+        while (position < text.size() && text[position].isDigit())
+            position++;
+    }
+
+    bool ok = false;
+    *result = text.mid(start, position - start).toDouble(&ok);
+    return ok || fail("Not a number");
+}
+
+//  -----------      ----------------                Constructor Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Constructor
+ *
+ * @code {.c++}
+ * DerivedChannels::DerivedChannels(TelemetryStore *store)
+ * @endcode
+ */
+DerivedChannels::DerivedChannels(TelemetryStore *store) : targetStore(store)
+{
+}
+
+//  -----------      ----------------                Definition Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Compile channel definition
+ *
+ * @code {.c++}
+ * DerivedChannels::compile(const QString &definition, derivedChannel *channel, QString *error)
+ * @endcode
+ */
+bool DerivedChannels::compile(const QString &definition, derivedChannel *channel, QString *error)
+{
+    int equals = definition.indexOf('=');
+    QString name = definition.left(equals).trimmed();
+    if (equals < 0 || name.isEmpty())
+    {
+        *error = "\"" + definition + "\" is not <name> = <expression>";
+        return false;
+    }
+    if (name.startsWith('"') && name.endsWith('"') && name.size() > 2)
+        name = name.mid(1, name.size() - 2);
+    if (name.contains(QRegularExpression("\\s")))
+    {
+        *error = name + ": channel name can not contain spaces"; // stored as a field of a telemetry line
+        return false;
+    }
+
+    *channel = derivedChannel();
+    channel->definition = definition.trimmed();
+
+    expressionCompiler compiler(definition.mid(equals + 1), channel);
+    bool ok = compiler.expression();
+    if (ok && !compiler.peek().isNull())
+        ok = compiler.fail("Unexpected '" + QString(compiler.peek()) + "'");
+    if (ok && compiler.maxDepth > ExpressionStackLimit)
+        ok = compiler.fail("Expression is too deep");
+    if (ok && channel->inputs.isEmpty())
+        ok = compiler.fail("Expression uses no property");
+
+    if (!ok)
+    {
+        *error = name + ": " + compiler.error;
+        return false;
+    }
+
+    channel->property = PropertyRegistry::instance().intern(name);
+    for (int i = 0; i < channel->inputs.size(); i++)
+    {
+        if (channel->inputs[i].property == channel->property)
+        {
+            *error = name + ": channel uses itself";
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Replace channels
+ *
+ * Empty lines and lines starting with '#' are skipped. A channel may only use
+ * channels defined before it, so outputs never loop. Names of received properties and
+ * names in the namespace of a link ("psu1:...") are rejected, output series are claimed
+ * in the store once every definition is valid.
+ *
+ * @code {.c++}
+ * DerivedChannels::setDefinitions(const QStringList &definitions, const QStringList &namespaces, QString *error)
+ * @endcode
+ */
+bool DerivedChannels::setDefinitions(const QStringList &definitions, const QStringList &namespaces, QString *error)
+{
+    QVector<derivedChannel> compiled;
+    for (int i = 0; i < definitions.size(); i++)
+    {
+        QString line = definitions[i].trimmed();
+        if (line.isEmpty() || line.startsWith('#'))
+            continue;
+
+        derivedChannel channel;
+        if (!compile(line, &channel, error))
+            return false;
+
+        for (int c = 0; c < compiled.size(); c++)
+        {
+            if (compiled[c].property == channel.property)
+            {
+                *error = PropertyRegistry::instance().name(channel.property) + " is defined twice";
+                return false;
+            }
+        }
+
+        QString name = PropertyRegistry::instance().name(channel.property);
+        int writer = targetStore->writerOf(channel.property);
+        if (writer != writerNone && writer != writerDerived)
+        {
+            *error = name + " is a received property";
+            return false;
+        }
+        for (int n = 0; n < namespaces.size(); n++)
+        {
+            if (!namespaces[n].isEmpty() && name.startsWith(namespaces[n] + ":"))
+            {
+                *error = name + " is in the namespace of link " + namespaces[n];
+                return false;
+            }
+        }
+        compiled.append(channel);
+    }
+
+    for (int i = 0; i < compiled.size(); i++) // channels used before their definition
+    {
+        for (int later = i; later < compiled.size(); later++)
+        {
+            for (int input = 0; input < compiled[i].inputs.size(); input++)
+            {
+                if (compiled[i].inputs[input].property == compiled[later].property)
+                {
+                    *error = PropertyRegistry::instance().name(compiled[i].property) + " must be defined after " + PropertyRegistry::instance().name(compiled[later].property);
+                    return false;
+                }
+            }
+        }
+    }
+
+    for (int i = 0; i < compiled.size(); i++) // received since the check -> nothing is replaced
+    {
+        if (!targetStore->claim(compiled[i].property, writerDerived))
+        {
+            *error = PropertyRegistry::instance().name(compiled[i].property) + " is a received property";
+            return false;
+        }
+    }
+
+    for (int i = 0; i < compiled.size(); i++) // redefined channels continue their series
+    {
+        double firstKey = 0;
+        targetStore->keyRange(compiled[i].property, &firstKey, &compiled[i].lastKey); // unchanged without samples
+    }
+
+    channels = compiled;
+    inputTable.clear();
+    for (int i = 0; i < channels.size(); i++)
+    {
+        for (int input = 0; input < channels[i].inputs.size(); input++)
+        {
+            int property = channels[i].inputs[input].property;
+            while (inputTable.size() <= property) // first use of the property id
+                inputTable.append(QVector<int>());
+            if (!inputTable[property].contains(i))
+                inputTable[property].append(i);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Definitions of the channels
+ *
+ * @code {.c++}
+ * DerivedChannels::definitions()
+ * @endcode
+ */
+QStringList DerivedChannels::definitions() const
+{
+    QStringList result;
+    for (int i = 0; i < channels.size(); i++)
+        result.append(channels[i].definition);
+    return result;
+}
+
+/**
+ * @brief No channel defined
+ *
+ * @code {.c++}
+ * DerivedChannels::isEmpty()
+ * @endcode
+ */
+bool DerivedChannels::isEmpty() const
+{
+    return channels.isEmpty();
+}
+
+//  -----------      ----------------                Evaluation Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Evaluate channels using the sample
+ *
+ * Output samples have no log line, caller adds them to the log and store.
+ *
+ * @code {.c++}
+ * DerivedChannels::evaluate(const telemetrySample &sample, QVector<telemetrySample> *output)
+ * @endcode
+ */
+void DerivedChannels::evaluate(const telemetrySample &sample, QVector<telemetrySample> *output)
+{
+    update(sample.property, sample.key, sample.value, -1, output);
+}
+
+/**
+ * @brief Update inputs of the property
+ *
+ * Only channels after the given one are updated, outputs of a channel are passed
+ * on to the channels defined after it.
+ *
+ * @code {.c++}
+ * DerivedChannels::update(int property, double key, double value, int after, QVector<telemetrySample> *output)
+ * @endcode
+ */
+void DerivedChannels::update(int property, double key, double value, int after, QVector<telemetrySample> *output)
+{
+    if (property < 0 || property >= inputTable.size())
+        return;
+
+    const QVector<int> &users = inputTable.at(property);
+    for (int u = 0; u < users.size(); u++)
+    {
+        int index = users[u];
+        if (index <= after)
+            continue;
+
+        derivedChannel &channel = channels[index];
+        bool ready = true;
+        for (int i = 0; i < channel.inputs.size(); i++)
+        {
+            channelInput &input = channel.inputs[i];
+            if (input.property == property)
+            {
+                if (input.window > 0) // moving average of the window
+                {
+                    input.samples.push_back(averagedSample(key, value));
+                    input.sum += value;
+                    while (input.samples.front().key < key - input.window)
+                    {
+                        input.sum -= input.samples.front().value;
+                        input.samples.pop_front();
+                    }
+                    input.value = input.sum / input.samples.size();
+                }
+                else
+                {
+                    input.value = value;
+                }
+                input.fresh = true;
+            }
+            ready = ready && input.fresh;
+        }
+        if (!ready)
+            continue;
+
+        for (int i = 0; i < channel.inputs.size(); i++)
+            channel.inputs[i].fresh = false;
+
+        double result = run(channel);
+        channel.lastKey = qMax(channel.lastKey, key); // inputs of several links may not be in time order
+        output->append(telemetrySample(channel.property, channel.lastKey, result, -1));
+        update(channel.property, channel.lastKey, result, index, output); // channels using this one
+    }
+}
+
+/**
+ * @brief Run compiled program of the channel
+ *
+ * @code {.c++}
+ * DerivedChannels::run(const derivedChannel &channel)
+ * @endcode
+ */
+double DerivedChannels::run(const derivedChannel &channel)
+{
+    double stack[ExpressionStackLimit];
+    int top = -1;
+
+    const expressionInstruction *code = channel.program.constData();
+    for (int i = 0; i < channel.program.size(); i++)
+    {
+        const expressionInstruction &instruction = code[i];
+        switch (instruction.op)
+        {
+        case opConstant:
+            stack[++top] = instruction.constant;
+            break;
+        case opInput:
+            stack[++top] = channel.inputs.at(instruction.input).value;
+            break;
+        case opAdd:
+            top--;
+            stack[top] += stack[top + 1];
+            break;
+        case opSubtract:
+            top--;
+            stack[top] -= stack[top + 1];
+            break;
+        case opMultiply:
+            top--;
+            stack[top] *= stack[top + 1];
+            break;
+        case opDivide:
+            top--;
+            stack[top] /= stack[top + 1];
+            break;
+        case opPower:
+            top--;
+            stack[top] = std::pow(stack[top], stack[top + 1]);
+            break;
+        case opMin:
+            top--;
+            stack[top] = qMin(stack[top], stack[top + 1]);
+            break;
+        case opMax:
+            top--;
+            stack[top] = qMax(stack[top], stack[top + 1]);
+            break;
+        case opNegate:
+            stack[top] = -stack[top];
+            break;
+        case opAbs:
+            stack[top] = std::fabs(stack[top]);
+            break;
+        case opSqrt:
+            stack[top] = std::sqrt(stack[top]);
+            break;
+        case opExp:
+            stack[top] = std::exp(stack[top]);
+            break;
+        case opLog:
+            stack[top] = std::log(stack[top]);
+            break;
+        case opSin:
+            stack[top] = std::sin(stack[top]);
+            break;
+        case opCos:
+            stack[top] = std::cos(stack[top]);
+            break;
+        }
+    }
+    return stack[0];
+}
@@ -0,0 +1,125 @@
+#ifndef DERIVEDCHANNELS_H
+#define DERIVEDCHANNELS_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <deque>
+#include "telemetrybus.h"
+#include "telemetrystore.h"
+#include "propertyregistry.h"
+
+// ---- Definitions ---- //
+
+#define ExpressionStackLimit 32 ///< Deepest evaluation stack of a compiled expression
+
+// ---- Instructions of a compiled expression ---- //
+enum expressionOp
+{
+    opConstant, // pushes constant
+    opInput,    // pushes value of an input
+    opAdd,
+    opSubtract,
+    opMultiply,
+    opDivide,
+    opPower,
+    opNegate,
+    opAbs,
+    opSqrt,
+    opExp,
+    opLog,
+    opSin,
+    opCos,
+    opMin,
+    opMax
+};
+
+// -> single instruction, expressions are compiled to postfix order
+struct expressionInstruction
+{
+public:
+    expressionInstruction() {}
+    expressionInstruction(int o, double c = 0, int i = -1) : op(o), constant(c), input(i) {}
+
+    int op = opConstant;
+    double constant = 0; // opConstant
+    int input = -1;      // opInput -> index in the inputs of the channel
+};
+
+// -> sample kept by a moving average input
+struct averagedSample
+{
+public:
+    averagedSample() {}
+    averagedSample(double k, double v) : key(k), value(v) {}
+
+    double key = 0;
+    double value = 0;
+};
+
+// -> property used by a channel, last value or moving average of the last window seconds
+struct channelInput
+{
+public:
+    int property = NoProperty;
+    double window = 0;  // seconds, 0 -> last value
+    bool fresh = false; // updated since the last output of the channel
+    double value = 0;
+
+    std::deque<averagedSample> samples; // moving average -> samples of the window
+    double sum = 0;
+};
+
+// -> compiled channel
+struct derivedChannel
+{
+public:
+    QString definition; // "<name> = <expression>" as entered
+    int property = NoProperty;
+    QVector<expressionInstruction> program;
+    QVector<channelInput> inputs;
+    double lastKey = 0; // time of the last output, outputs never go back in time
+};
+
+/*
+ * Channels computed from received properties.
+ *
+ * Each channel is defined as "<name> = <expression>", for example
+ *   coil0.power = coil0.vol * coil0.cur
+ *   de1.temp_avg = avg(de1.temp, 10)
+ * Expressions are compiled once into postfix instructions evaluated on a fixed stack.
+ * Operators + - * / ^, functions abs sqrt exp log sin cos min max, avg(<property>, <seconds>)
+ * for moving averages. Names with other characters are written in double quotes.
+ *
+ * Inputs are aligned: a channel is evaluated when every input was updated since its last
+ * output, time of the output is the time of the last input sample. Channels may use channels
+ * defined before them. Outputs are stored and published like received samples, so they are
+ * plotted, recorded, exported and alarmed on as any other property.
+ *
+ * Output series are claimed in the telemetry store for the derived channels, names of
+ * received properties or in the namespace of a link are rejected, and links refuse
+ * samples of names claimed here, so every series keeps a single writer.
+ */
+class DerivedChannels
+{
+public:
+    explicit DerivedChannels(TelemetryStore *store);
+
+    bool setDefinitions(const QStringList &definitions, const QStringList &namespaces, QString *error); // replaces every channel, nothing changes on error
+    QStringList definitions() const;
+    bool isEmpty() const;
+
+    void evaluate(const telemetrySample &sample, QVector<telemetrySample> *output); // appends outputs caused by the sample
+
+    static bool compile(const QString &definition, derivedChannel *channel, QString *error);
+
+private:
+    void update(int property, double key, double value, int after, QVector<telemetrySample> *output); // inputs of channels after the given one
+    static double run(const derivedChannel &channel);
+
+    TelemetryStore *targetStore;
+    QVector<derivedChannel> channels;
+    QVector<QVector<int>> inputTable; // property id -> channels using it, ascending
+};
+
+#endif // DERIVEDCHANNELS_H
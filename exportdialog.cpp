@@ -0,0 +1,75 @@
+#include "exportdialog.h"
+#include "ui_exportdialog.h"
+
+//  -----------      ----------------                Constructor Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Constructor
+ *
+ * Fills format and property selections. Time range defaults
+ * to the whole session.
+ *
+ * @code {.c++}
+ * ExportDialog::ExportDialog(QStringList properties, QDateTime sessionStart, QWidget *parent)
+ * @endcode
+ */
+ExportDialog::ExportDialog(QStringList properties, QDateTime sessionStart, QWidget *parent) : QDialog(parent), ui(new Ui::ExportDialog)
+{
+    ui->setupUi(this);
+
+    ui->Format_comboBox->addItem("CSV text (*.csv)", exportCsv);
+    ui->Format_comboBox->addItem("Columnar binary (*.aibc)", exportColumnar);
+
+    ui->Property_comboBox->addItem("All properties");
+    ui->Property_comboBox->addItems(properties);
+
+    ui->From_dateTimeEdit->setDateTime(sessionStart);
+    ui->To_dateTimeEdit->setDateTime(QDateTime::currentDateTime());
+}
+
+/**
+ * @brief Destructor
+ *
+ * @code {.c++}
+ * ExportDialog::~ExportDialog()
+ * @endcode
+ */
+ExportDialog::~ExportDialog()
+{
+    delete ui;
+}
+
+/**
+ * @brief Selected options
+ *
+ * Returns export options selected on the dialog. Output path is selected seperately.
+ *
+ * @code {.c++}
+ * ExportDialog::options()
+ * @endcode
+ */
+exportOptions ExportDialog::options() const
+{
+    exportOptions selected;
+    selected.format = ui->Format_comboBox->currentData().toInt();
+    if (ui->Property_comboBox->currentIndex() != 0 || ui->Property_comboBox->currentText() != "All properties")
+        selected.property = ui->Property_comboBox->currentText().trimmed();
+
+    selected.useTimeRange = ui->TimeRange_checkBox->isChecked();
+    selected.fromKey = ui->From_dateTimeEdit->dateTime().toSecsSinceEpoch();
+    selected.toKey = ui->To_dateTimeEdit->dateTime().toSecsSinceEpoch();
+    return selected;
+}
+
+/**
+ * @brief Enable time range selection
+ *
+ * @code {.c++}
+ * ExportDialog::on_TimeRange_checkBox_stateChanged(int arg1)
+ * @endcode
+ */
+void ExportDialog::on_TimeRange_checkBox_stateChanged(int arg1)
+{
+    ui->From_dateTimeEdit->setEnabled(arg1);
+    ui->To_dateTimeEdit->setEnabled(arg1);
+}
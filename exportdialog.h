@@ -0,0 +1,34 @@
+#ifndef EXPORTDIALOG_H
+#define EXPORTDIALOG_H
+
+#include <QDialog>
+#include <QStringList>
+#include <QDateTime>
+#include "sessionexporter.h"
+
+namespace Ui
+{
+    class ExportDialog;
+}
+
+/*
+ * Dialog for selecting what part of the session is exported.
+ */
+class ExportDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    ExportDialog(QStringList properties, QDateTime sessionStart, QWidget *parent = nullptr);
+    ~ExportDialog();
+
+    exportOptions options() const; // selected options, path is left empty
+
+private slots:
+    void on_TimeRange_checkBox_stateChanged(int arg1);
+
+private:
+    Ui::ExportDialog *ui;
+};
+
+#endif // EXPORTDIALOG_H
@@ -0,0 +1,290 @@
+#include "logstore.h"
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <cstring>
+
+// ---- Definitions ---- //
+
+#define LogChunkSize 65536    ///< Lines per storage chunk
+#define LogTextBlockSize (1 << 20) ///< Bytes per text block, longer lines are cut
+#define LogRetainedChunks 16  ///< Chunks kept in the store, older lines are dropped with their text
+#define ResultBatchSize 4096  ///< Maximum matches sent in one result batch
+#define ResultBatchTime 50    ///< Maximum time in ms before partial results are sent
+
+//  -----------      ----------------                Filter Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Check if line passes the filter
+ *
+ * Severity and property are checked first since they are cheap,
+ * regex is only evaluated for remaining lines.
+ *
+ * @code {.c++}
+ * logFilter::matches(const logLine &line)
+ * @endcode
+ */
+bool logFilter::matches(const logLine &line) const
+{
+    if (!(severityMask & (1 << line.severity))) // severity is filtered out
+        return false;
+    if (property != NoProperty && line.property != property) // other property
+        return false;
+    if (!regex.pattern().isEmpty() && !regex.match(line.toString()).hasMatch()) // text does not match
+        return false;
+    return true;
+}
+
+//  -----------      ----------------                Log Store Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Default Constructor
+ *
+ * @code {.c++}
+ * LogStore::LogStore()
+ * @endcode
+ */
+LogStore::LogStore()
+{
+}
+
+/**
+ * @brief Returns number of lines in a storage chunk
+ *
+ * @code {.c++}
+ * LogStore::chunkSize()
+ * @endcode
+ */
+int LogStore::chunkSize()
+{
+    return LogChunkSize;
+}
+
+/**
+ * @brief Returns number of lines kept at most
+ *
+ * @code {.c++}
+ * LogStore::retainedLines()
+ * @endcode
+ */
+int LogStore::retainedLines()
+{
+    return LogChunkSize * LogRetainedChunks;
+}
+
+/**
+ * @brief Append line to the store
+ *
+ * Only called from ui thread. Text is copied into the current text block and line
+ * is written first, published afterwards, so readers never see half written lines.
+ * Blocks and chunks are allocated once for many lines, nothing is allocated per line.
+ * Starting a new chunk drops the oldest one beyond LogRetainedChunks, readers holding
+ * a snapshot keep it alive until they are done.
+ *
+ * @code {.c++}
+ * LogStore::appendLine(int severity, int property, const char *text, int length)
+ * @endcode
+ */
+void LogStore::appendLine(int severity, int property, const char *text, int length)
+{
+    int index = totalCount.loadAcquire();
+    int inChunk = index % LogChunkSize;
+
+    if (inChunk == 0) // current chunk is full -> create new one
+    {
+        QMutexLocker locker(&chunkLock);
+        chunks.append(QSharedPointer<logChunk>(new logChunk(LogChunkSize)));
+        int first = firstIndex.loadAcquire() / LogChunkSize;
+        if (chunks.size() - first > LogRetainedChunks) // drop the oldest chunk and its text
+        {
+            chunks[first].clear();
+            firstIndex.storeRelease((first + 1) * LogChunkSize);
+        }
+        if (!textBlock.isNull())
+            chunks.last()->textBlocks.append(textBlock); // lines of the new chunk continue in the current block
+    }
+
+    logChunk *chunk = chunks.at(chunks.size() - 1).data();
+    length = qMin(length, LogTextBlockSize);
+    if (textBlock.isNull() || textBlock->used + length > LogTextBlockSize) // current block is full -> create new one
+    {
+        textBlock = QSharedPointer<logTextBlock>(new logTextBlock(LogTextBlockSize));
+        chunk->textBlocks.append(textBlock);
+    }
+
+    logTextBlock *block = textBlock.data();
+    char *target = block->bytes.data() + block->used;
+    memcpy(target, text, length);
+    block->used += length;
+
+    logLine &entry = chunk->lines[inChunk];
+    entry.time = QDateTime::currentMSecsSinceEpoch();
+    entry.severity = severity;
+    entry.property = property;
+    entry.text = target;
+    entry.length = length;
+    chunk->count.storeRelease(inChunk + 1);
+
+    totalCount.storeRelease(index + 1);
+}
+
+/**
+ * @brief Append line to the store
+ *
+ * Used for lines created by the client, text is converted to utf8.
+ *
+ * @code {.c++}
+ * LogStore::appendLine(int severity, int property, const QString &text)
+ * @endcode
+ */
+void LogStore::appendLine(int severity, int property, const QString &text)
+{
+    QByteArray utf8 = text.toUtf8();
+    appendLine(severity, property, utf8.constData(), utf8.size());
+}
+
+/**
+ * @brief Returns number of lines in the store
+ *
+ * @code {.c++}
+ * LogStore::lineCount()
+ * @endcode
+ */
+int LogStore::lineCount() const
+{
+    return totalCount.loadAcquire();
+}
+
+/**
+ * @brief Returns index of the oldest line kept
+ *
+ * Lines below are dropped, indexes of the kept lines do not change.
+ *
+ * @code {.c++}
+ * LogStore::firstLine()
+ * @endcode
+ */
+int LogStore::firstLine() const
+{
+    return firstIndex.loadAcquire();
+}
+
+/**
+ * @brief Access line by index
+ *
+ * Index must be lower than line count. Only called from ui thread, dropped lines
+ * are returned as an empty line.
+ *
+ * @code {.c++}
+ * LogStore::line(int index)
+ * @endcode
+ */
+const logLine &LogStore::line(int index) const
+{
+    static const logLine droppedLine;
+    if (index < firstIndex.loadAcquire())
+        return droppedLine;
+    return chunks.at(index / LogChunkSize)->lines[index % LogChunkSize];
+}
+
+/**
+ * @brief Copy of chunk list
+ *
+ * Readers on other threads work on this copy, chunks stay alive
+ * as long as the copy exists. Dropped chunks are null.
+ *
+ * @code {.c++}
+ * LogStore::snapshot()
+ * @endcode
+ */
+QVector<QSharedPointer<logChunk>> LogStore::snapshot() const
+{
+    QMutexLocker locker(&chunkLock);
+    return chunks;
+}
+
+//  -----------      ----------------                Search Worker Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Constructor
+ *
+ * @code {.c++}
+ * LogSearchWorker::LogSearchWorker(LogStore *store, QObject *parent)
+ * @endcode
+ */
+LogSearchWorker::LogSearchWorker(LogStore *store, QObject *parent) : QObject(parent), targetStore(store)
+{
+}
+
+/**
+ * @brief Start a new search generation
+ *
+ * Called from ui thread before queuing a new search. Running search
+ * sees the changed generation and stops.
+ *
+ * @code {.c++}
+ * LogSearchWorker::nextGeneration()
+ * @endcode
+ */
+int LogSearchWorker::nextGeneration()
+{
+    return currentGeneration.fetchAndAddOrdered(1) + 1;
+}
+
+/**
+ * @brief Search the log store
+ *
+ * Runs on worker thread. Iterates over the lines starting from filter.fromLine and
+ * sends matching line indexes in batches. Dropped chunks are skipped. Batches are sent when they are full or
+ * when enough time passed, so view fills progressively on long searches.
+ *
+ * @code {.c++}
+ * LogSearchWorker::search(logFilter filter, int generation)
+ * @endcode
+ */
+void LogSearchWorker::search(logFilter filter, int generation)
+{
+    if (generation != currentGeneration.loadAcquire()) // already outdated
+        return;
+
+    filter.regex.optimize();
+
+    int total = targetStore->lineCount(); // count first, every counted line is inside the snapshot
+    QVector<QSharedPointer<logChunk>> chunks = targetStore->snapshot();
+
+    QVector<int> batch;
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int index = filter.fromLine; index < total; index++)
+    {
+        if ((index % 4096) == 0 && generation != currentGeneration.loadAcquire()) // cancelled
+            return;
+
+        const logChunk *chunk = chunks.at(index / LogChunkSize).data();
+        if (chunk == nullptr) // dropped, continue at the next chunk
+        {
+            index += LogChunkSize - 1 - index % LogChunkSize;
+            continue;
+        }
+
+        const logLine &line = chunk->lines[index % LogChunkSize];
+        if (filter.matches(line))
+        {
+            batch.append(index);
+        }
+
+        if (batch.size() >= ResultBatchSize || (batch.size() > 0 && (index % 1024) == 0 && timer.elapsed() > ResultBatchTime)) // send partial results
+        {
+            emit resultsReady(generation, batch);
+            batch.clear();
+            timer.restart();
+        }
+    }
+
+    if (batch.size() > 0)
+        emit resultsReady(generation, batch);
+
+    emit searchFinished(generation, total);
+}
@@ -0,0 +1,138 @@
+#ifndef LOGSTORE_H
+#define LOGSTORE_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QSharedPointer>
+#include <QRegularExpression>
+#include <vector>
+#include "propertyregistry.h"
+
+// ---- Definitions ---- //
+
+#define UnknownProperty -2 ///< Filter value for a property name never received
+
+// ---- Severity levels of the log lines ---- //
+enum logSeverity
+{
+    logInfo = 0,      // general information, unknown packages
+    logTelemetry = 1, // property value received from server
+    logResponse = 2,  // ack response from server
+    logCommand = 3,   // command sent by user
+    logError = 4      // error reported by client or server
+};
+
+// -> single line stored in the log. Text is kept in the text blocks of the store,
+// line only points to it, so storing a line does not allocate.
+struct logLine
+{
+public:
+    qint64 time = 0; // receive time, ms since epoch
+    int severity = logInfo;
+    int property = NoProperty;  // property id, NoProperty if line is not a telemetry line
+    const char *text = nullptr; // utf8 text inside a text block of the store
+    int length = 0;             // bytes of text
+
+    QString toString() const { return QString::fromUtf8(text, length); }
+};
+
+// -> fixed size block of text bytes. Allocated once and never moved,
+// so lines can point into it.
+struct logTextBlock
+{
+public:
+    logTextBlock(int size) : bytes(size) {}
+
+    std::vector<char> bytes;
+    int used = 0; // only accessed by the writer
+};
+
+// -> fixed size block of lines. Storage is allocated once, so readers on other
+// threads can access lines below count while new lines are appended.
+// Chunk owns the text blocks of its lines, text is released with the chunk.
+struct logChunk
+{
+public:
+    logChunk(int size) : lines(size) {}
+
+    std::vector<logLine> lines;
+    QAtomicInt count; // number of lines published in this chunk
+    QVector<QSharedPointer<logTextBlock>> textBlocks; // blocks holding text of the lines, only accessed by the writer
+};
+
+// -> filter used while searching the log
+struct logFilter
+{
+public:
+    QRegularExpression regex; // empty pattern matches every line
+    int severityMask = 0xFF;  // bit per logSeverity
+    int property = NoProperty; // NoProperty -> all properties, UnknownProperty -> no line
+    int fromLine = 0;         // first line to search
+
+    bool isEmpty() const { return regex.pattern().isEmpty() && severityMask == 0xFF && property == NoProperty; }
+    bool matches(const logLine &line) const;
+};
+Q_DECLARE_METATYPE(logFilter)
+
+/*
+ * Append only store for every line shown at console.
+ *
+ * Lines are kept in fixed size chunks. Writer is the ui thread, search workers
+ * can read concurrently since published lines are never moved or modified.
+ * Only the last LogRetainedChunks chunks are kept: when a new chunk is started the oldest
+ * one is dropped with its text. Line indexes stay global, dropped lines are below firstLine()
+ * and their chunks are null in the snapshot.
+ */
+class LogStore
+{
+public:
+    LogStore();
+
+    void appendLine(int severity, int property, const char *text, int length); // add new line to the end, text is copied into the store
+    void appendLine(int severity, int property, const QString &text);
+    int lineCount() const;                                                          // number of published lines
+    int firstLine() const;                                                          // index of the oldest line still kept
+    const logLine &line(int index) const;                                            // access line by global index, empty line if dropped
+
+    QVector<QSharedPointer<logChunk>> snapshot() const; // chunks list, used by readers on other threads
+    static int chunkSize();
+    static int retainedLines(); // lines kept at most
+
+private:
+    mutable QMutex chunkLock; //-> protects chunk list only, not the lines
+    QVector<QSharedPointer<logChunk>> chunks; //-> null for dropped chunks
+    QAtomicInt totalCount;
+    QAtomicInt firstIndex;
+
+    QSharedPointer<logTextBlock> textBlock; //-> block receiving the text of new lines, only accessed by the writer
+};
+
+/*
+ * Worker used to search log store on a seperate thread.
+ * Results are sent progressively in batches while search continues.
+ */
+class LogSearchWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LogSearchWorker(LogStore *store, QObject *parent = nullptr);
+
+    int nextGeneration(); // cancels running search, returns id for the next one
+
+public slots:
+    void search(logFilter filter, int generation); // runs the search, emits results
+
+signals:
+    void resultsReady(int generation, QVector<int> lines); // batch of matching line indexes
+    void searchFinished(int generation, int searchedUpTo);  // search reached the end of the snapshot
+
+private:
+    LogStore *targetStore;
+    QAtomicInt currentGeneration; // running search stops when this changes
+};
+
+#endif // LOGSTORE_H
@@ -0,0 +1,439 @@
+#include "logviewerwindow.h"
+#include "ui_logviewerwindow.h"
+
+// ---- Definitions ---- //
+
+#define FilterDelay 150    ///< Time in ms waited after typing before search starts
+#define RefreshInterval 250 ///< Time in ms between view updates for new lines
+
+//  -----------      ----------------                List Model Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Constructor
+ *
+ * @code {.c++}
+ * LogListModel::LogListModel(LogStore *store, QObject *parent)
+ * @endcode
+ */
+LogListModel::LogListModel(LogStore *store, QObject *parent) : QAbstractListModel(parent), targetStore(store)
+{
+}
+
+/**
+ * @brief Number of rows shown at view
+ *
+ * @code {.c++}
+ * LogListModel::rowCount(const QModelIndex &parent)
+ * @endcode
+ */
+int LogListModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return filtered ? matches.size() : visibleCount - firstVisible;
+}
+
+/**
+ * @brief Data of the row
+ *
+ * Called by the view for visible rows only, text is read directly from the store.
+ * Foreground color follows the console colors.
+ *
+ * @code {.c++}
+ * LogListModel::data(const QModelIndex &index, int role)
+ * @endcode
+ */
+QVariant LogListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    int lineIndex = filtered ? matches.at(index.row()) : firstVisible + index.row();
+    const logLine &line = targetStore->line(lineIndex);
+
+    if (role == Qt::DisplayRole)
+    {
+        return line.toString().trimmed();
+    }
+    else if (role == Qt::ForegroundRole)
+    {
+        switch (line.severity)
+        {
+        case logTelemetry:
+            return QColor("blue");
+        case logCommand:
+            return QColor("darkMagenta");
+        case logError:
+            return QColor("red");
+        case logResponse:
+            return QColor("black");
+        default:
+            return QColor("gray");
+        }
+    }
+    return QVariant();
+}
+
+/**
+ * @brief Switch filtered mode
+ *
+ * Resets the model. Filtered mode starts empty and gets filled by search results.
+ *
+ * @code {.c++}
+ * LogListModel::setFiltered(bool state)
+ * @endcode
+ */
+void LogListModel::setFiltered(bool state)
+{
+    beginResetModel();
+    filtered = state;
+    matches.clear();
+    firstVisible = filtered ? 0 : targetStore->firstLine();
+    visibleCount = filtered ? 0 : targetStore->lineCount();
+    endResetModel();
+}
+
+/**
+ * @brief Append search results
+ *
+ * @code {.c++}
+ * LogListModel::appendMatches(const QVector<int> &lines)
+ * @endcode
+ */
+void LogListModel::appendMatches(const QVector<int> &lines)
+{
+    if (!filtered || lines.isEmpty())
+        return;
+
+    beginInsertRows(QModelIndex(), matches.size(), matches.size() + lines.size() - 1);
+    matches += lines;
+    endInsertRows();
+}
+
+/**
+ * @brief Show new lines of the store
+ *
+ * Only used when not filtered, new lines are inserted as one block.
+ *
+ * @code {.c++}
+ * LogListModel::refreshLines()
+ * @endcode
+ */
+void LogListModel::refreshLines()
+{
+    int count = targetStore->lineCount();
+    if (filtered || count == visibleCount)
+        return;
+
+    if (visibleCount == firstVisible) // no rows shown, start at the oldest kept line
+        firstVisible = visibleCount = qMax(visibleCount, targetStore->firstLine());
+
+    beginInsertRows(QModelIndex(), visibleCount - firstVisible, count - firstVisible - 1);
+    visibleCount = count;
+    endInsertRows();
+}
+
+/**
+ * @brief Remove rows of dropped lines
+ *
+ * Store drops its oldest chunk at once, rows are removed as one block from the top.
+ *
+ * @code {.c++}
+ * LogListModel::dropLines()
+ * @endcode
+ */
+void LogListModel::dropLines()
+{
+    int firstLine = targetStore->firstLine();
+    if (filtered)
+    {
+        int dropped = 0;
+        while (dropped < matches.size() && matches.at(dropped) < firstLine)
+            dropped++;
+        if (dropped == 0)
+            return;
+
+        beginRemoveRows(QModelIndex(), 0, dropped - 1);
+        matches.remove(0, dropped);
+        endRemoveRows();
+    }
+    else
+    {
+        int dropped = qMin(firstLine, visibleCount) - firstVisible;
+        if (dropped <= 0)
+            return;
+
+        beginRemoveRows(QModelIndex(), 0, dropped - 1);
+        firstVisible += dropped;
+        endRemoveRows();
+    }
+}
+
+//  -----------      ----------------                Constructor Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Constructor
+ *
+ * Sets up the list view and starts the search worker thread.
+ *
+ * @code {.c++}
+ * LogViewerWindow::LogViewerWindow(LogStore *store, QWidget *parent)
+ * @endcode
+ */
+LogViewerWindow::LogViewerWindow(LogStore *store, QWidget *parent) : QWidget(parent), ui(new Ui::LogViewerWindow), targetStore(store)
+{
+    ui->setupUi(this);
+    setAttribute(Qt::WA_DeleteOnClose); // stop worker thread when window is closed
+
+    qRegisterMetaType<logFilter>("logFilter");
+    qRegisterMetaType<QVector<int>>("QVector<int>");
+
+    // Timers
+    filterTimer = new QTimer(this);
+    filterTimer->setSingleShot(true);
+    filterTimer->setInterval(FilterDelay);
+    connect(filterTimer, SIGNAL(timeout()), this, SLOT(applyFilter()));
+
+    refreshTimer = new QTimer(this);
+    refreshTimer->setInterval(RefreshInterval);
+    connect(refreshTimer, SIGNAL(timeout()), this, SLOT(refreshView()));
+
+    // Model setup
+    logModel = new LogListModel(targetStore, this);
+    logModel->setFiltered(false);
+    ui->Log_listView->setModel(logModel);
+
+    setupSeverity_comboBox();
+
+    // Search worker setup
+    worker = new LogSearchWorker(targetStore);
+    worker->moveToThread(&searchThread);
+    connect(this, SIGNAL(requestSearch(logFilter, int)), worker, SLOT(search(logFilter, int)));
+    connect(worker, SIGNAL(resultsReady(int, QVector<int>)), this, SLOT(onResultsReady(int, QVector<int>)));
+    connect(worker, SIGNAL(searchFinished(int, int)), this, SLOT(onSearchFinished(int, int)));
+    searchThread.start();
+
+    refreshTimer->start();
+
+    refreshView();
+}
+
+/**
+ * @brief Destructor
+ *
+ * Cancels running search and waits for worker thread to finish.
+ *
+ * @code {.c++}
+ * LogViewerWindow::~LogViewerWindow()
+ * @endcode
+ */
+LogViewerWindow::~LogViewerWindow()
+{
+    worker->nextGeneration(); // cancel running search
+    searchThread.quit();
+    searchThread.wait();
+    delete worker;
+
+    delete ui;
+}
+
+/**
+ * @brief Setup severity combo box
+ *
+ * Each item carries the severity mask used by the filter.
+ *
+ * @code {.c++}
+ * LogViewerWindow::setupSeverity_comboBox()
+ * @endcode
+ */
+void LogViewerWindow::setupSeverity_comboBox()
+{
+    ui->Severity_comboBox->addItem("All", 0xFF);
+    ui->Severity_comboBox->addItem("Telemetry", 1 << logTelemetry);
+    ui->Severity_comboBox->addItem("Responses", 1 << logResponse);
+    ui->Severity_comboBox->addItem("Commands", 1 << logCommand);
+    ui->Severity_comboBox->addItem("Errors", 1 << logError);
+    ui->Severity_comboBox->addItem("Info", 1 << logInfo);
+}
+
+//  -----------      ----------------                Search Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Apply current filter
+ *
+ * Builds filter from the ui elements and restarts the search. Empty filter
+ * shows every line directly without searching.
+ *
+ * @code {.c++}
+ * LogViewerWindow::applyFilter()
+ * @endcode
+ */
+void LogViewerWindow::applyFilter()
+{
+    logFilter filter;
+    filter.regex.setPattern(ui->Search_lineEdit->text());
+    if (!ui->CaseSensitive_checkBox->isChecked())
+        filter.regex.setPatternOptions(QRegularExpression::CaseInsensitiveOption);
+    filter.severityMask = ui->Severity_comboBox->currentData().toInt();
+    QString property = ui->Property_lineEdit->text().trimmed();
+    if (!property.isEmpty())
+    {
+        filter.property = PropertyRegistry::instance().find(property);
+        if (filter.property == NoProperty) // never received -> nothing matches
+            filter.property = UnknownProperty;
+    }
+
+    if (!filter.regex.isValid()) // wait until expression is complete
+    {
+        ui->Status_label->setText("Invalid expression: " + filter.regex.errorString());
+        return;
+    }
+
+    activeFilter = filter;
+    activeGeneration = worker->nextGeneration(); // cancels the previous search
+    searchedUpTo = 0;
+
+    if (activeFilter.isEmpty()) // no search needed
+    {
+        searching = false;
+        logModel->setFiltered(false);
+    }
+    else
+    {
+        searching = true;
+        logModel->setFiltered(true);
+        emit requestSearch(activeFilter, activeGeneration);
+    }
+    refreshView();
+}
+
+/**
+ * @brief Periodic view refresh
+ *
+ * Shows lines received since the last refresh. When filtered, new lines are
+ * searched by the worker continuing from where the last search stopped.
+ * Rows of lines dropped by the store are removed, status shows how many lines are kept.
+ *
+ * @code {.c++}
+ * LogViewerWindow::refreshView()
+ * @endcode
+ */
+void LogViewerWindow::refreshView()
+{
+    logModel->dropLines();
+
+    int firstLine = targetStore->firstLine();
+    int lineCount = targetStore->lineCount();
+    QString lines = QString::number(lineCount - firstLine) + " lines";
+    if (firstLine > 0) // store is full
+        lines += " (last " + QString::number(LogStore::retainedLines()) + " kept, " + QString::number(firstLine) + " older dropped)";
+
+    if (activeFilter.isEmpty())
+    {
+        logModel->refreshLines();
+        ui->Status_label->setText(lines);
+    }
+    else
+    {
+        if (!searching && lineCount > searchedUpTo) // search only the new lines
+        {
+            logFilter filter = activeFilter;
+            filter.fromLine = qMax(searchedUpTo, firstLine);
+            searching = true;
+            emit requestSearch(filter, activeGeneration);
+        }
+        ui->Status_label->setText(QString::number(logModel->rowCount()) + " matches in " + lines + (searching ? " (searching...)" : ""));
+    }
+
+    if (ui->Follow_checkBox->isChecked())
+    {
+        ui->Log_listView->scrollToBottom();
+    }
+}
+
+/**
+ * @brief Search results received
+ *
+ * Results of outdated searches are ignored.
+ *
+ * @code {.c++}
+ * LogViewerWindow::onResultsReady(int generation, QVector<int> lines)
+ * @endcode
+ */
+void LogViewerWindow::onResultsReady(int generation, QVector<int> lines)
+{
+    if (generation == activeGeneration)
+    {
+        logModel->appendMatches(lines);
+    }
+}
+
+/**
+ * @brief Search reached the end of the store
+ *
+ * @code {.c++}
+ * LogViewerWindow::onSearchFinished(int generation, int upTo)
+ * @endcode
+ */
+void LogViewerWindow::onSearchFinished(int generation, int upTo)
+{
+    if (generation == activeGeneration)
+    {
+        searching = false;
+        searchedUpTo = upTo;
+    }
+}
+
+//  -----------      ----------------                Ui Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Search text changed
+ *
+ * @code {.c++}
+ * LogViewerWindow::on_Search_lineEdit_textChanged(const QString &arg1)
+ * @endcode
+ */
+void LogViewerWindow::on_Search_lineEdit_textChanged(const QString &arg1)
+{
+    Q_UNUSED(arg1);
+    filterTimer->start(); // restart delay
+}
+
+/**
+ * @brief Property filter changed
+ *
+ * @code {.c++}
+ * LogViewerWindow::on_Property_lineEdit_textChanged(const QString &arg1)
+ * @endcode
+ */
+void LogViewerWindow::on_Property_lineEdit_textChanged(const QString &arg1)
+{
+    Q_UNUSED(arg1);
+    filterTimer->start();
+}
+
+/**
+ * @brief Severity filter changed
+ *
+ * @code {.c++}
+ * LogViewerWindow::on_Severity_comboBox_currentIndexChanged(int index)
+ * @endcode
+ */
+void LogViewerWindow::on_Severity_comboBox_currentIndexChanged(int index)
+{
+    Q_UNUSED(index);
+    filterTimer->start();
+}
+
+/**
+ * @brief Case sensitivity changed
+ *
+ * @code {.c++}
+ * LogViewerWindow::on_CaseSensitive_checkBox_stateChanged(int arg1)
+ * @endcode
+ */
+void LogViewerWindow::on_CaseSensitive_checkBox_stateChanged(int arg1)
+{
+    Q_UNUSED(arg1);
+    filterTimer->start();
+}
@@ -0,0 +1,89 @@
+#ifndef LOGVIEWERWINDOW_H
+#define LOGVIEWERWINDOW_H
+
+#include <QWidget>
+#include <QAbstractListModel>
+#include <QThread>
+#include <QTimer>
+#include <QVector>
+#include <QColor>
+#include "logstore.h"
+
+/*
+ * List model showing lines of the log store.
+ *
+ * Model does not copy any text. Unfiltered it shows every line in the store,
+ * filtered it only keeps the indexes of matching lines. Lines dropped by the store
+ * are removed from the top.
+ */
+class LogListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit LogListModel(LogStore *store, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    void setFiltered(bool state);                // switches between all lines and filtered lines, clears results
+    void appendMatches(const QVector<int> &lines); // adds search results to the end
+    void refreshLines();                         // shows new lines of the store when not filtered
+    void dropLines();                            // removes rows of lines dropped by the store
+
+private:
+    LogStore *targetStore;
+    bool filtered = false;
+    QVector<int> matches; // line indexes when filtered
+    int firstVisible = 0; // line of the first row when not filtered
+    int visibleCount = 0; // lines below this index are visible when not filtered
+};
+
+namespace Ui
+{
+    class LogViewerWindow;
+}
+
+class LogViewerWindow : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit LogViewerWindow(LogStore *store, QWidget *parent = nullptr);
+    ~LogViewerWindow();
+
+    void setupSeverity_comboBox();
+
+signals:
+    void requestSearch(logFilter filter, int generation); // queued to the search worker
+
+private slots:
+    void applyFilter();     // restarts the search with current filter
+    void refreshView();     // periodic update for new lines
+    void onResultsReady(int generation, QVector<int> lines);
+    void onSearchFinished(int generation, int upTo);
+
+    void on_Search_lineEdit_textChanged(const QString &arg1);
+    void on_Property_lineEdit_textChanged(const QString &arg1);
+    void on_Severity_comboBox_currentIndexChanged(int index);
+    void on_CaseSensitive_checkBox_stateChanged(int arg1);
+
+private:
+    Ui::LogViewerWindow *ui;
+
+    LogStore *targetStore;
+    LogListModel *logModel;
+
+    // *** Search worker *** //
+    QThread searchThread;
+    LogSearchWorker *worker;
+    logFilter activeFilter;
+    int activeGeneration = 0;
+    bool searching = false;
+    int searchedUpTo = 0; // lines below this index are already searched
+
+    QTimer *filterTimer;  //-> delays search while user is typing
+    QTimer *refreshTimer; //-> periodic refresh for new lines
+};
+
+#endif // LOGVIEWERWINDOW_H
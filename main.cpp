@@ -1,9 +1,47 @@
 #include "mainwindow.h"
+#include "reportrenderer.h"
 #include <QApplication>
+#include <QTextStream>
+
+/*
+ * Batch report without main window:
+ *   AIB_ClIENT_SW -platform offscreen --report <archive> <figure list> <output folder> [--pdf]
+ */
+static int renderReport(const QStringList &arguments)
+{
+    QTextStream out(stdout);
+    int at = arguments.indexOf("--report");
+    if (at + 3 >= arguments.size())
+    {
+        out << "usage : --report <archive> <figure list> <output folder> [--pdf]" << "\n";
+        return 2;
+    }
+
+    QString error;
+    QVector<reportFigure> figures = ReportRenderer::readFigures(arguments[at + 2], &error);
+    if (!error.isEmpty())
+    {
+        out << error << "\n";
+        return 2;
+    }
+
+    ReportRenderer renderer(arguments[at + 1], arguments[at + 3]);
+    renderer.setPdf(arguments.contains("--pdf"));
+    QObject::connect(&renderer, &ReportRenderer::figureFailed, &renderer, [](QString name, QString message) {
+        QTextStream(stderr) << name << " : " << message << "\n";
+    }, Qt::DirectConnection); // emitted by pool threads as well, no event loop is running
+
+    int written = renderer.render(figures);
+    out << written << " of " << figures.size() << " figures written to " << arguments[at + 3] << "\n";
+    return written == figures.size() ? 0 : 1;
+}
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
+    if (a.arguments().contains("--report"))
+        return renderReport(a.arguments());
+
     MainWindow w;
 
     // Prefereces
@@ -1,11 +1,20 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 
-#include "treeviewcommands.cpp"
+#include "procedurewindow.h"
+#include "dashboardwindow.h"
+#include "resamplewindow.h"
 #include <QHostAddress>
+#include <QInputDialog>
+#include <QLocale>
 
 #include <QtWidgets/QFileDialog>
 
+// ---- Definitions ---- //
+
+#define ConsoleLineLimit 10000 ///< Maximum lines kept on the console
+#define PropertiesColumns 8    ///< Name, value and statistics columns of the properties table
+
 //  -----------      ----------------                Ui Initalization Functions                     ----------------              ---------------- //
 MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWindow)
 {
@@ -14,18 +23,36 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), ui(new Ui::MainWi
     //
     serialTimer = new QTimer(this);
     mainItemModel = new QStandardItemModel(this);
+    qRegisterMetaType<ingestBatch>("ingestBatch");
+    qRegisterMetaType<commandResult>("commandResult");
     //
     setup();
 }
 
 MainWindow::~MainWindow()
 {
-    // Checking if its still connected
-    if (isConnected)
+    // Closing every link, samples of the store are no longer written
+    while (!links.isEmpty())
+    {
+        removeLink(links.size() - 1);
+    }
+
+    // Stop running export
+    if (exportThread != nullptr)
     {
-        disconnectTCP();
+        exporter->cancel();
+        exportThread->quit();
+        exportThread->wait();
+        delete exporter;
     }
 
+    // Alarm panel uses the alarm engine of this window
+    delete alarmWindow.data();
+
+    // Write remaining samples and index of the session file
+    sessionWriter.close();
+    delete insertQuery;
+
     delete ui;
 }
 
@@ -46,6 +73,7 @@ void MainWindow::setup()
 
     // Console Text edit Setup
     ui->Console_textEdit->setTextInteractionFlags(Qt::NoTextInteraction);
+    ui->Console_textEdit->setLineLimit(ConsoleLineLimit);
 
     //----- Ui Function Initalization  ------//
     //
@@ -54,6 +82,13 @@ void MainWindow::setup()
     setupProperties_tableView();
     setupDatabase();
 
+    // Consumers of received samples
+    telemetryBus.subscribeAll(&telemetryStatistics); // first, views read the statistics of the same batch
+    telemetryBus.subscribeAll(&alarmEngine);         // before the views as well, properties table shows alarm levels
+    telemetryBus.subscribeAll(Data_tableView_Model);
+    telemetryBus.subscribeAll(&sessionWriter);
+    telemetryBus.subscribeAll(this);
+
     // Insert Predefined commands to the command buffer
     insertElementToBuffer("sub de1.temp");
     insertElementToBuffer("sub coil0.vol");
@@ -87,12 +122,17 @@ void MainWindow::setTCPConnection()
     ui->TCP_ManualInput_IP_label->setEnabled(0);
     ui->TCP_ManualInput_Port_lineEdit->setEnabled(0);
     ui->TCP_ManualInput_Port_label->setEnabled(0);
+
+    // Connect progress is only shown while a link is connecting
+    ui->TCP_Connect_progressBar->setRange(0, 0);
+    ui->TCP_Connect_progressBar->setVisible(0);
 }
 
 /**
  * @brief Setup function for table view
  *
- * Setup for tablew view. Sets up header name, stretch format and other initial properties.
+ * Setup for tablew view. Sets up model, stretch format and other initial properties.
+ * Column names are provided by the model.
  *
  * @code {.c++}
  * MainWindow::setupData_tableView()
@@ -101,26 +141,9 @@ void MainWindow::setTCPConnection()
  */
 void MainWindow::setupData_tableView()
 {
+    Data_tableView_Model = new DataTableModel(&logStore, this); // rows are read from the log store, nothing is copied
     //
-    QList<QStandardItem *> headerItem; // list of standard Item  -> append each column -> align at center
-    headerItem.append(new QStandardItem("<Timestamp>"));
-    headerItem[0]->setTextAlignment(Qt::AlignCenter);
-    headerItem.append(new QStandardItem("<Timestamp>"));
-    headerItem[1]->setTextAlignment(Qt::AlignCenter);
-    headerItem.append(new QStandardItem("<Sequence Number>"));
-    headerItem[2]->setTextAlignment(Qt::AlignCenter);
-    headerItem.append(new QStandardItem("note"));
-    headerItem[3]->setTextAlignment(Qt::AlignCenter);
-    headerItem.append(new QStandardItem("<Property>"));
-    headerItem[4]->setTextAlignment(Qt::AlignCenter);
-    headerItem.append(new QStandardItem("<Message>"));
-    headerItem[5]->setTextAlignment(Qt::AlignCenter);
-
-    // Append header
-    Data_tablewView_ItemModel = new QStandardItemModel(this);
-    Data_tablewView_ItemModel->appendRow(headerItem);
-    //
-    ui->Data_tableView->setModel(Data_tablewView_ItemModel);                            // append final model to data table
+    ui->Data_tableView->setModel(Data_tableView_Model);                                 // append final model to data table
     ui->Data_tableView->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch); // adjust column width
     //
 }
@@ -129,6 +152,7 @@ void MainWindow::setupData_tableView()
  * @brief Setup properties table view
  *
  * setup functin for table view. Creates header and sets default parameters for view.
+ * Mean, standard deviation and rate are taken over the statistics window, min and max over every sample.
  *
  * @code {.c++}
  * MainWindow::setupProperties_tableView()
@@ -140,6 +164,12 @@ void MainWindow::setupProperties_tableView()
     QList<QStandardItem *> tempHeader; // Create list of temp headers
     tempHeader.append(new QStandardItem("<Property Name>"));
     tempHeader.append(new QStandardItem("<Value>"));
+    tempHeader.append(new QStandardItem("<Mean>"));
+    tempHeader.append(new QStandardItem("<Std Dev>"));
+    tempHeader.append(new QStandardItem("<Min>"));
+    tempHeader.append(new QStandardItem("<Max>"));
+    tempHeader.append(new QStandardItem("<Rate /s>"));
+    tempHeader.append(new QStandardItem("<Last Change>"));
 
     tempHeader[0]->setTextAlignment(Qt::AlignCenter);
 
@@ -155,7 +185,8 @@ void MainWindow::setupProperties_tableView()
  *
  *  Function for setting up database functionality.
  *  Creates new database folder according to the startup time of the program.
- *  Creates database items based on string.
+ *  Creates database items based on string. TimeKey column stores timestamp as
+ *  seconds since epoch, so rows can be selected by time range.
  * @code {.c++}
  * MainWindow::setupDatabase()
  * @endcode
@@ -165,7 +196,8 @@ void MainWindow::setupDatabase()
 {
 
     // create default path for fb
-    QString path = QDir::currentPath() + "/data/" + QDateTime::currentDateTime().toString("MM-dd-HH:mm:ss");
+    sessionStart = QDateTime::currentDateTime();
+    QString path = QDir::currentPath() + "/data/" + sessionStart.toString("MM-dd-HH:mm:ss");
     path = path + ".db";
     //qDebug() << path << endl;
     db.setDatabaseName(path);
@@ -182,7 +214,8 @@ void MainWindow::setupDatabase()
                           "SequenceNumber VARCHAR(20),"
                           "Note VARCHAR(20),"
                           "Property VARCHAR(20),"
-                          "Value VARCHAR(20) );";
+                          "Value VARCHAR(20),"
+                          "TimeKey REAL );";
     QSqlQuery query;
     // create table
     if (!query.exec(setupScript))
@@ -190,6 +223,28 @@ void MainWindow::setupDatabase()
         displayMessageBox("An Error occured while setting up database ! ", "black");
         //qDebug() << "An Error occured while creating database ! " << endl;
     }
+    // index for reading property values by time range
+    if (!query.exec("CREATE INDEX PropertyTime ON database (Property, TimeKey);"))
+    {
+        displayMessageBox("An Error occured while setting up database ! ", "black");
+    }
+
+    // insert query -> prepared once for every received row
+    insertQuery = new QSqlQuery(db);
+    insertQuery->prepare("INSERT INTO database ("
+                         "Timestamp, "
+                         "SequenceNumber, "
+                         "Note, "
+                         "Property, "
+                         "Value, "
+                         "TimeKey) "
+                         "VALUES (?,?,?,?,?,?);");
+
+    // session file next to the database -> reopened later without loading it
+    if (!sessionWriter.open(path.left(path.size() - 3) + ".aibs"))
+    {
+        displayMessageBox("An Error occured while setting up session file ! ", "black");
+    }
 }
 
 
@@ -198,41 +253,66 @@ void MainWindow::setupDatabase()
 /**
  * @brief Connect to TCP target
  *
- * Function for connecting tcp target. host and port names are get from corresponding
- * combo box sections.
+ * Function for opening a new link to a tcp target. host and port names are get from corresponding
+ * combo box sections, namespace of the properties from the prefix line edit.
+ * Link connects and receives on its own thread without waiting, result is reported by onLinkConnected
+ * or onLinkFailed. Until then, connect button cancels the attempt.
  *
  * @code {.c++}
- * MainWindow::setupProperties_tableView()
+ * MainWindow::connectTCP(QString &host, QString &port)
  * @endcode
  *
  */
 void MainWindow::connectTCP(QString &host, QString &port)
 {
-    if (!isConnected) // if not already connected
+    QString prefix = ui->TCP_Prefix_lineEdit->text().trimmed();
+    if (prefix.contains(' ') || prefix.contains(':'))
     {
-        socket.connectToHost(QHostAddress(host), port.toInt()); // connect to specified host
-        socket.waitForConnected(100);                           // wait for connection
-        if (socket.state() == QTcpSocket::ConnectedState)       // if succesfull
-        {
-            isConnected = 1;
-            ui->TCP_EnableManualInput_checkBox->setEnabled(0);
-            ui->TCP_Connect_pushButton->setText("Disconnect");
-            connect(&socket, SIGNAL(readyRead()), this, SLOT(onReadyRead()));
-        }
-        else // not succesfull -> close port
+        displayMessageBox("Prefix can not contain spaces or ':' !", "black");
+        return;
+    }
+    for (int i = 0; i < links.size(); i++) // each property is written by one link only
+    {
+        if (links[i].link->prefix() == prefix)
         {
-            displayMessageBox("Could not find the host !", "black");
-            socket.disconnect();
-            socket.close();
+            displayMessageBox("A link with this prefix already exists !", "black");
+            return;
         }
     }
-}
 
+    linkEntry entry;
+    int timeout = ui->TCP_Timeout_spinBox->value() * 1000; // ms waited for the server
+    entry.link = new TelemetryLink(nextLinkId++, host, port.toUShort(), prefix, timeout, &telemetryStore);
+
+    linkOptions options;
+    options.lowDelay = ui->TCP_LowDelay_checkBox->isChecked();
+    options.keepAlive = ui->TCP_KeepAlive_checkBox->isChecked();
+    options.receiveBuffer = ui->TCP_ReceiveBuffer_spinBox->value() * 1024;
+    options.sendBuffer = ui->TCP_SendBuffer_spinBox->value() * 1024;
+    entry.link->setOptions(options);
+
+    entry.thread = new QThread(this);
+    entry.link->moveToThread(entry.thread);
+
+    connect(entry.thread, SIGNAL(started()), entry.link, SLOT(start()));
+    connect(entry.link, SIGNAL(connected(int)), this, SLOT(onLinkConnected(int)));
+    connect(entry.link, SIGNAL(connectionFailed(int, QString)), this, SLOT(onLinkFailed(int, QString)));
+    connect(entry.link, SIGNAL(disconnected(int)), this, SLOT(onLinkDisconnected(int)));
+    connect(entry.link, SIGNAL(reconnecting(int, int, int)), this, SLOT(onLinkReconnecting(int, int, int)));
+    connect(entry.link, SIGNAL(sequenceGap(int, qint64, qint64)), this, SLOT(onLinkGap(int, qint64, qint64)));
+    connect(entry.link, SIGNAL(batchReady(ingestBatch)), this, SLOT(onBatchReady(ingestBatch)));
+    connect(entry.link, SIGNAL(commandFinished(commandResult)), this, SLOT(onCommandFinished(commandResult)));
+
+    links.append(entry);
+    entry.thread->start();
+    setConnecting(entry.link->id()); // until result of this link is known
+}
 
 /**
  * @brief Disconnect from TCP target
  *
- * Function for disconnecting from tcp target.
+ * Function for disconnecting the link selected on the links list.
+ * Link is removed when it reports it is closed.
  *
  * @code {.c++}
  * MainWindow::disconnectTCP()
@@ -241,32 +321,247 @@ void MainWindow::connectTCP(QString &host, QString &port)
  */
 void MainWindow::disconnectTCP()
 {
-    if (isConnected)
+    int row = ui->TCP_Links_listWidget->currentRow();
+    if (row < 0 || row >= ui->TCP_Links_listWidget->count())
+        return;
+
+    int index = indexOfLink(ui->TCP_Links_listWidget->item(row)->data(Qt::UserRole).toInt());
+    if (index >= 0)
+        QMetaObject::invokeMethod(links[index].link, "stop", Qt::QueuedConnection);
+}
+
+/**
+ * @brief Link connected
+ *
+ * Called at the first connection and after each reconnect.
+ *
+ * @code {.c++}
+ * MainWindow::onLinkConnected(int link)
+ * @endcode
+ *
+ */
+void MainWindow::onLinkConnected(int link)
+{
+    int index = indexOfLink(link);
+    if (index < 0)
+        return;
+
+    linkEntry &entry = links[index];
+    entry.connected = true;
+    entry.attempt = 0;
+
+    if (entry.listed) // reconnected -> subscriptions are sent again by the link
+    {
+        displayMessageConsole("Reconnected to " + entry.link->description() + "\n", "darkMagenta");
+        updateLinkItem(index);
+        return;
+    }
+
+    entry.listed = true;
+    QListWidgetItem *item = new QListWidgetItem(entry.link->description());
+    item->setData(Qt::UserRole, link);
+    ui->TCP_Links_listWidget->addItem(item);
+    ui->TCP_Links_listWidget->setCurrentItem(item); // commands go to the latest link
+    if (link == connectingLink)
+        setConnecting(-1);
+}
+
+/**
+ * @brief Link lost connection
+ *
+ * Link keeps trying until it reconnects or user disconnects it.
+ *
+ * @code {.c++}
+ * MainWindow::onLinkReconnecting(int link, int attempt, int delay)
+ * @endcode
+ *
+ */
+void MainWindow::onLinkReconnecting(int link, int attempt, int delay)
+{
+    int index = indexOfLink(link);
+    if (index < 0)
+        return;
+
+    links[index].connected = false;
+    links[index].attempt = attempt;
+    if (attempt == 1)
+        displayMessageConsole("Connection lost to " + links[index].link->description() + ", reconnecting...\n", "red");
+    updateLinkItem(index);
+    Q_UNUSED(delay);
+}
+
+/**
+ * @brief Lines missing in sequence numbers
+ *
+ * Gap is already marked in the telemetry store, plots show it with the next batch.
+ *
+ * @code {.c++}
+ * MainWindow::onLinkGap(int link, qint64 lost, qint64 totalLost)
+ * @endcode
+ *
+ */
+void MainWindow::onLinkGap(int link, qint64 lost, qint64 totalLost)
+{
+    int index = indexOfLink(link);
+    if (index < 0)
+        return;
+
+    links[index].lostLines = totalLost;
+    QString message = "Sequence gap on " + links[index].link->description() + " : " + QString::number(lost) + " lines lost";
+    displayMessageConsole(message + "\n", "red");
+    logStore.appendLine(logError, NoProperty, message); // keep gaps searchable
+    updateLinkItem(index);
+}
+
+/**
+ * @brief Show state of the link
+ *
+ * @code {.c++}
+ * MainWindow::updateLinkItem(int index)
+ * @endcode
+ *
+ */
+void MainWindow::updateLinkItem(int index)
+{
+    const linkEntry &entry = links.at(index);
+    QString text = entry.link->description();
+    if (!entry.connected)
+        text += "  (reconnecting " + QString::number(entry.attempt) + ")";
+    if (entry.lostLines > 0)
+        text += "  lost: " + QString::number(entry.lostLines);
+
+    for (int row = 0; row < ui->TCP_Links_listWidget->count(); row++)
+    {
+        QListWidgetItem *item = ui->TCP_Links_listWidget->item(row);
+        if (item->data(Qt::UserRole).toInt() == entry.link->id())
+            item->setText(text);
+    }
+}
+
+/**
+ * @brief Link could not connect
+ *
+ * @code {.c++}
+ * MainWindow::onLinkFailed(int link, QString message)
+ * @endcode
+ *
+ */
+void MainWindow::onLinkFailed(int link, QString message)
+{
+    int index = indexOfLink(link);
+    if (index >= 0)
+        removeLink(index);
+
+    setConnecting(-1);
+    displayMessageBox("Could not find the host ! " + message, "black");
+}
+
+/**
+ * @brief Link closed
+ *
+ * Called when user disconnects the link or server closes the connection.
+ *
+ * @code {.c++}
+ * MainWindow::onLinkDisconnected(int link)
+ * @endcode
+ *
+ */
+void MainWindow::onLinkDisconnected(int link)
+{
+    int index = indexOfLink(link);
+    if (index < 0)
+        return;
+
+    if (link == connectingLink) // attempt cancelled by user
+        setConnecting(-1);
+    else
+        displayMessageConsole("Disconnected from " + links[index].link->description() + "\n", "darkMagenta");
+    removeLink(index);
+}
+
+/**
+ * @brief Show connect progress
+ *
+ * While a link is connecting, progress bar is shown and connect button cancels it.
+ * Called with -1 when the attempt is over.
+ *
+ * @code {.c++}
+ * MainWindow::setConnecting(int link)
+ * @endcode
+ *
+ */
+void MainWindow::setConnecting(int link)
+{
+    connectingLink = link;
+    ui->TCP_Connect_progressBar->setVisible(link >= 0);
+    ui->TCP_Connect_pushButton->setText(link >= 0 ? "Cancel" : "Connect");
+}
+
+/**
+ * @brief Index of the link
+ *
+ * Returns -1 if link does not exists.
+ *
+ * @code {.c++}
+ * MainWindow::indexOfLink(int link)
+ * @endcode
+ *
+ */
+int MainWindow::indexOfLink(int link) const
+{
+    for (int i = 0; i < links.size(); i++)
     {
-        socket.disconnect();
-        if (socket.state() != QTcpSocket::ConnectedState)
-            ; // checks if properly disconnected
+        if (links[i].link->id() == link)
+            return i;
+    }
+    return -1;
+}
+
+/**
+ * @brief Remove link
+ *
+ * Stops the thread of the link and deletes it, removes it from the links list.
+ * Socket is closed when the link is deleted.
+ *
+ * @code {.c++}
+ * MainWindow::removeLink(int index)
+ * @endcode
+ *
+ */
+void MainWindow::removeLink(int index)
+{
+    linkEntry entry = links.takeAt(index);
+    int link = entry.link->id();
+    entry.link->disconnect(this);
+
+    entry.thread->quit();
+    entry.thread->wait();
+    delete entry.link; // thread is finished -> deleted from ui thread
+    delete entry.thread;
+
+    for (int row = 0; row < ui->TCP_Links_listWidget->count(); row++)
+    {
+        if (ui->TCP_Links_listWidget->item(row)->data(Qt::UserRole).toInt() == link)
         {
-            isConnected = 0;
-            ui->TCP_EnableManualInput_checkBox->setEnabled(1);
-            ui->TCP_Connect_pushButton->setText("Connect");
-            socket.close();
+            delete ui->TCP_Links_listWidget->takeItem(row);
+            break;
         }
     }
 }
 
 /**
- * @brief Function for reading data from TCP
+ * @brief Lines received by a link
  *
- * Function emitted when ui recieves bytes over TCP connection.
- * Reads the bytes and converts into data package.
+ * Called once per read of a link. Samples are already in the telemetry store,
+ * lines are added to the log here and to the console as one message, samples are delivered to
+ * the bus subscribers once for the batch, together with the derived channels they update. Database rows of the batch are written in one transaction.
  *
  * @code {.c++}
- * MainWindow::onReadyRead()
+ * MainWindow::onBatchReady(ingestBatch batch)
  * @endcode
  *
  */
-void MainWindow::onReadyRead() // triggers when byte received
+void MainWindow::onBatchReady(ingestBatch batch)
 {
     /*
      * Qt incoming data structre for reqular client - server comm
@@ -276,55 +571,68 @@ void MainWindow::onReadyRead() // triggers when byte received
      *      QBtreArray = <Time Stamp> + <Time Stamp> + <sequence number> + note +  <property> + <value>
      */
 
-    QByteArray rawData = socket.readLine();             // reads the all available btyes in the socket
-    QStringList dataList = QString(rawData).split(" "); // splits it
-    //
-
-    displayMessageConsole(rawData, "blue"); // Displaying the raw message on console
-    //
+    bool batchTransaction = db.transaction(); // every row of this batch is written with one commit
+    consoleBytes.resize(0);                   // keeps its capacity, lines are copied without allocating
 
-    if (dataList.size() == 6) // Check if data package fits for package with property value
+    for (int i = 0; i < batch.entries.size(); i++)
     {
-        addData_tableView(dataList);                                                                               // add message to the data table view
-        addProperties_tableView(dataList[4], dataList[5]);                                                         // pass property and its value
-        addElementToDatabase(dataList[0] + "-" + dataList[1], dataList[2], dataList[3], dataList[4], dataList[5]); // add message to the database
+        const ingestEntry &entry = batch.entries.at(i);
+        const char *line = batch.text.constData() + entry.offset;
+        int logIndex = logStore.lineCount();
+
+        consoleBytes.append(line, entry.length);
+        consoleBytes.append('\n');
+        logStore.appendLine(entry.severity, entry.property, line, entry.length);  // add message to the log
 
-        for (int i = 0; i < temperaturePlots.size(); i++) // for each open plotting window, update the plot values
+        if (entry.severity == logTelemetry)
         {
-            temperaturePlots[i]->updatePlot();
+            telemetrySample sample(entry.property, entry.key, entry.value, logIndex);
+            telemetryBus.publish(sample); // queue sample for the subscribers
+            if (!derivedChannels.isEmpty())
+                derivedChannels.evaluate(sample, &derivedSamples);
         }
     }
-    else if (dataList.size() == 4) // if package is just ack response
+    publishDerivedSamples();
+
+    if (!consoleBytes.isEmpty())
+        displayMessageConsole(QString::fromUtf8(consoleBytes), "blue"); // one console message per batch
+    telemetryBus.flush(); // subscribers receive the batch once
+
+    if (batchTransaction)
     {
+        db.commit();
     }
 }
 
-
 /**
  * @brief Send commands over TCP.
  *
- * Sends commands over TCP connection. uses QTCP functions to send data
- * over tcp connection.
+ * Sends commands to the link of the command. Commands with a namespaced property
+ * ("set psu1:volt 5") go to the link of the namespace without the prefix,
+ * others go to the link selected on the links list.
  *
  * @code {.c++}
- * MainWindow::onReadyRead()
+ * MainWindow::sendCommand(QString command)
  * @endcode
  *
  */
 void MainWindow::sendCommand(QString command)
 {
+    QString target = command;
+    TelemetryLink *link = commandTarget(&target);
+
     // writing on the TCP Server
-    if (socket.state() == QTcpSocket::ConnectedState)
+    if (link != nullptr)
     {
         insertElementToBuffer(command); // Adding command to the memmory buffer
         prevIndex = 0;                  // reset command cycling index
 
-        // sending command to tcp socket
-        command += " \n";
-        socket.write(command.toUtf8());
-        socket.flush();
+        // sending command to the link thread
+        target += " \n";
+        QMetaObject::invokeMethod(link, "sendCommand", Qt::QueuedConnection, Q_ARG(QByteArray, target.toUtf8()));
         displayMessageConsole("Sending ->", "darkMagenta");
-        displayMessageConsole(command, "black"); // displaying on console text box
+        displayMessageConsole(command + " \n", "black"); // displaying on console text box
+        logStore.appendLine(logCommand, NoProperty, command + " \n");
     }
     else
     {
@@ -332,123 +640,262 @@ void MainWindow::sendCommand(QString command)
     }
 }
 
+/**
+ * @brief Command finished
+ *
+ * Called by the command channel of a link when the ack of a command is received or
+ * command failed after its retries. Late acks of timed out commands are shown as such.
+ * Only commands sent by user are shown on console, tagged commands belong to their senders.
+ *
+ * @code {.c++}
+ * MainWindow::onCommandFinished(commandResult result)
+ * @endcode
+ *
+ */
+void MainWindow::onCommandFinished(commandResult result)
+{
+    if (result.tag >= 0)
+        return;
 
-
-
-//  -----------      ----------------                  Internal Functions                     ----------------              ----------------  //
+    if (result.stale)
+    {
+        displayMessageConsole("Late ack <- " + result.command + " : " + result.response + " (" + QString::number(result.latency, 'f', 2) + " ms, already reported)\n", "darkOrange");
+    }
+    else if (result.ok)
+    {
+        displayMessageConsole("Ack <- " + result.command + " : " + result.response + " (" + QString::number(result.latency, 'f', 2) + " ms)\n", "darkGreen");
+    }
+    else
+    {
+        QString message = "Command failed -> " + result.command + " : " + result.response + " after " + QString::number(result.attempts) + " attempts";
+        displayMessageConsole(message + "\n", "red");
+        logStore.appendLine(logError, NoProperty, message);
+    }
+}
 
 /**
- * @brief Function for adding item to database
+ * @brief Link of the command
+ *
+ * Finds the link of the first namespaced word in the command and removes the namespace.
+ * Without namespace selected link is used, or the only link if nothing is selected.
+ * Returns nullptr if there is no connected link.
  *
- *  This function called whenever new message received to system. Saves every message received on database.
  * @code {.c++}
- * MainWindow::addElementToDatabase(QString date, QString sequence, QString note, QString property, QString value) // adding element to the database
+ * MainWindow::commandTarget(QString *command)
  * @endcode
  *
  */
-void MainWindow::addElementToDatabase(QString date, QString sequence, QString note, QString property, QString value) // adding element to the database
+TelemetryLink *MainWindow::commandTarget(QString *command)
 {
+    QStringList words = command->split(" ");
+    for (int w = 0; w < words.size(); w++) // for each word of the command
+    {
+        int separator = words[w].indexOf(':');
+        if (separator <= 0)
+            continue;
 
-    QSqlQuery query;
+        QString prefix = words[w].left(separator);
+        for (int i = 0; i < links.size(); i++)
+        {
+            if (links[i].connected && links[i].link->prefix() == prefix)
+            {
+                words[w] = words[w].mid(separator + 1); // server does not know the namespace
+                *command = words.join(" ");
+                return links[i].link;
+            }
+        }
+    }
 
-    query.prepare("INSERT INTO database ("
-                  "Timestamp, "
-                  "SequenceNumber, "
-                  "Note, "
-                  "Property, "
-                  "Value) "
-                  "VALUES (?,?,?,?,?);");
+    int row = ui->TCP_Links_listWidget->currentRow();
+    if (row < 0 && ui->TCP_Links_listWidget->count() == 1)
+        row = 0;
+    if (row < 0 || row >= ui->TCP_Links_listWidget->count())
+        return nullptr;
 
-    query.addBindValue(date);
-    query.addBindValue(sequence);
-    query.addBindValue(note);
-    query.addBindValue(property);
-    query.addBindValue(value);
+    int index = indexOfLink(ui->TCP_Links_listWidget->item(row)->data(Qt::UserRole).toInt());
+    if (index < 0 || !links[index].connected)
+        return nullptr;
+    return links[index].link;
+}
+
+
+
+
+//  -----------      ----------------                  Internal Functions                     ----------------              ----------------  //
 
-    if (!query.exec())
+/**
+ * @brief Store and publish derived samples
+ *
+ * Outputs of the derived channels are added like received samples: to the telemetry store,
+ * to the log as a telemetry line and to the bus. Every view, recorder and the alarm engine
+ * handles them as any other property. Lines are not shown on the console.
+ *
+ * @code {.c++}
+ * MainWindow::publishDerivedSamples()
+ * @endcode
+ *
+ */
+void MainWindow::publishDerivedSamples()
+{
+    for (int i = 0; i < derivedSamples.size(); i++)
     {
-        displayMessageBox("An Error occured while adding value to database ! ", "black");
+        telemetrySample &sample = derivedSamples[i];
+        telemetryStore.append(sample.property, sample.key, sample.value); // series is claimed by the derived channels, links refuse its name
+
+        // same fields as a received line -> <date> <time> <sequence> <note> <property> <value>
+        QString line = QLocale::c().toString(QDateTime::fromMSecsSinceEpoch(qint64(sample.key * 1000)), "yyyy-MMM-dd hh:mm:ss") + " - derived " +
+                       PropertyRegistry::instance().name(sample.property) + " " + QString::number(sample.value, 'g', 10);
+        sample.line = logStore.lineCount();
+        logStore.appendLine(logTelemetry, sample.property, line);
+        telemetryBus.publish(sample);
     }
+    derivedSamples.resize(0);
 }
 
 /**
- * @brief Adding data to TableView
+ * @brief Receive batch from the telemetry bus
  *
- * Function for adding data to table view. Gets input message as string list
- * and adds corresponding field to the table view as a new row.
+ * Main window is subscribed to every property. Updates the properties table
+ * and writes a database row for each sample, stored line is split again for the text columns.
  *
  * @code {.c++}
- * MainWindow::addData_tableView(QStringList datas)
+ * MainWindow::deliver(const QVector<telemetrySample> &samples)
  * @endcode
  *
  */
-void MainWindow::addData_tableView(QStringList datas)
+void MainWindow::deliver(const QVector<telemetrySample> &samples)
 {
-    QList<QStandardItem *> element;         // create new row
-    for (int i = 0; i < datas.size(); i++)  // for each elements in datas
+    for (int i = 0; i < samples.size(); i++)
     {
-        element.append(new QStandardItem(datas[i])); // add a new column to row
+        const telemetrySample &sample = samples.at(i);
+        addProperties_tableView(sample.property, sample.line); // pass property and its value
+
+        const logLine &line = logStore.line(sample.line);
+        TelemetryParser::tokenize(line.text, line.length, &ingestRecord);
+        addElementToDatabase(ingestRecord, sample.key); // add message to the database
     }
-    Data_tablewView_ItemModel->appendRow(element); // append the new row
+    updateProperties_tableView(); // table is updated once per batch
 }
 
 /**
- * @brief adding properties to the table view.
+ * @brief Function for adding item to database
  *
- * Function for adding properties to the properties table view.
- * gets the property name and value to add table view.
+ *  This function called whenever new message received to system. Saves every message received on database.
+ *  Prepared insert query is reused, commit is done once for the receive batch.
+ *  Rows still allocate: one QString per text column, which the sqlite driver binds as utf16,
+ *  and the placeholder names QSqlResult builds for every bound value.
+ * @code {.c++}
+ * MainWindow::addElementToDatabase(const telemetryRecord &record, double key) // adding element to the database
+ * @endcode
  *
- * If property already exists, it updates the last value to the current new value.
+ */
+void MainWindow::addElementToDatabase(const telemetryRecord &record, double key) // adding element to the database
+{
+    if (insertQuery == nullptr) // database is not set up
+        return;
+
+    int span = record.tokens[1] + record.lengths[1] - record.tokens[0];
+    QString timestamp = QString::fromUtf8(record.tokens[0], span);                                 // <date> <time> in one string
+    timestamp.replace(record.lengths[0], span - record.lengths[0] - record.lengths[1], QChar('-')); // stored as <date>-<time>
+
+    insertQuery->bindValue(0, timestamp);
+    insertQuery->bindValue(1, record.token(2));
+    insertQuery->bindValue(2, record.token(3));
+    insertQuery->bindValue(3, record.token(4));
+    insertQuery->bindValue(4, record.token(5));
+    insertQuery->bindValue(5, key);
+
+    if (!insertQuery->exec())
+    {
+        displayMessageBox("An Error occured while adding value to database ! ", "black");
+    }
+}
+
+/**
+ * @brief adding properties to the table view.
+ *
+ * Function for marking property value as changed. Gets the property id and
+ * log line of the received value. Table is updated once per receive batch.
  *
  * @code {.c++}
- * MainWindow::addProperties_tableView(QString property, QString value)
+ * MainWindow::addProperties_tableView(int property, int line)
  * @endcode
  *
  */
-void MainWindow::addProperties_tableView(QString property, QString value)
+void MainWindow::addProperties_tableView(int property, int line)
 {
-    if (!checkPropertyExists_tableView(property)) // if property does not exists in the table
+    while (propertyRows.size() <= property) // first sight of the property id
     {
-        QList<QStandardItem *> element;
-        element.append(new QStandardItem(property));
-        element.append(new QStandardItem(value));
-        Properties_tableView_ItemModel->appendRow(element);
+        propertyRows.append(propertyRow());
     }
-    else // if property already exists
+
+    propertyRow &entry = propertyRows[property];
+    entry.lastLine = line;
+    if (!entry.changed) // first value in this batch
     {
-        for (int i = 0; i < Properties_tableView_ItemModel->rowCount(); i++)
-        {
-            if (Properties_tableView_ItemModel->item(i, 0)->text() == property)
-            {
-                Properties_tableView_ItemModel->item(i, 1)->setText(value);
-            }
-        }
+        entry.changed = true;
+        changedProperties.append(property);
     }
 }
 
 /**
- * @brief Function for checking if proprety exists on table view
- *
- * Internal iterative method for checking if propoerty exists
- * at properties table view.
+ * @brief updating properties table view.
  *
- * return true if exists.
+ * Shows last value and statistics of each property received in the batch,
+ * properties in alarm state are highlighted with the color of the level.
+ * If property does not exists in the table, new row is added.
+ * Row of each property is kept by id, so no row is searched.
  *
  * @code {.c++}
- * MainWindow::checkPropertyExists_tableView(QString item)
+ * MainWindow::updateProperties_tableView()
  * @endcode
  *
  */
-bool MainWindow::checkPropertyExists_tableView(QString item)
+void MainWindow::updateProperties_tableView()
 {
-    for (int i = 1; i < Properties_tableView_ItemModel->rowCount(); i++) //each element in properties table view
+    for (int i = 0; i < changedProperties.size(); i++) // for each changed property
     {
-        if (Properties_tableView_ItemModel->item(i, 0)->text() == item)
+        propertyRow &entry = propertyRows[changedProperties[i]];
+        entry.changed = false;
+
+        const logLine &line = logStore.line(entry.lastLine);
+        TelemetryParser::tokenize(line.text, line.length, &ingestRecord);
+        QString value = ingestRecord.token(5);
+
+        if (entry.row < 0) // if property does not exists in the table
         {
-            return true;
+            QList<QStandardItem *> element;
+            element.append(new QStandardItem(PropertyRegistry::instance().name(changedProperties[i])));
+            element.append(new QStandardItem(value));
+            for (int column = 2; column < PropertiesColumns; column++)
+                element.append(new QStandardItem());
+            element[0]->setData(changedProperties[i], Qt::UserRole); // id used by plotting windows
+            Properties_tableView_ItemModel->appendRow(element);
+            entry.row = Properties_tableView_ItemModel->rowCount() - 1;
+        }
+        else // if property already exists
+        {
+            Properties_tableView_ItemModel->item(entry.row, 1)->setText(value);
+        }
+
+        QColor alarm = AlarmEngine::levelColor(alarmEngine.levelOf(changedProperties[i]));
+        if (alarm.isValid())
+            alarm.setAlpha(90);
+        Properties_tableView_ItemModel->item(entry.row, 0)->setBackground(alarm.isValid() ? QBrush(alarm) : QBrush());
+        Properties_tableView_ItemModel->item(entry.row, 1)->setBackground(alarm.isValid() ? QBrush(alarm) : QBrush());
+
+        const propertyStatistics *stats = telemetryStatistics.statistics(changedProperties[i]);
+        if (stats != nullptr)
+        {
+            Properties_tableView_ItemModel->item(entry.row, 2)->setText(QString::number(stats->windowMean, 'g', 6));
+            Properties_tableView_ItemModel->item(entry.row, 3)->setText(QString::number(stats->windowStddev(), 'g', 4));
+            Properties_tableView_ItemModel->item(entry.row, 4)->setText(QString::number(stats->minValue, 'g', 6));
+            Properties_tableView_ItemModel->item(entry.row, 5)->setText(QString::number(stats->maxValue, 'g', 6));
+            Properties_tableView_ItemModel->item(entry.row, 6)->setText(QString::number(stats->rate(), 'f', 2));
+            Properties_tableView_ItemModel->item(entry.row, 7)->setText(QDateTime::fromMSecsSinceEpoch(qint64(stats->lastChange * 1000)).toString("hh:mm:ss.zzz"));
         }
     }
-    return false;
+    changedProperties.resize(0); // capacity is kept for the next batch
 }
 
 /**
@@ -555,13 +1002,15 @@ void MainWindow::insertElementToBuffer(QString item)
  */
 void MainWindow::displayMessageBox(QString message, QString color)
 {
+    logStore.appendLine(logError, NoProperty, message); // keep client errors searchable
     QMessageBox::about(this, "Warning !", message);
 }
 
 /**
  * @brief Console Display function
  *
- *  Function to ddisplay given message on console
+ *  Function to ddisplay given message on console.
+ *  Message is batched by the console and drawn once per frame.
  *
  * @code {.c++}
  * MainWindow::displayMessageConsole(QString message, QString color)
@@ -570,10 +1019,7 @@ void MainWindow::displayMessageBox(QString message, QString color)
  */
 void MainWindow::displayMessageConsole(QString message, QString color)
 {
-    ui->Console_textEdit->setTextColor(QColor(color));
-    ui->Console_textEdit->insertPlainText(message);
-    ui->Console_textEdit->setTextColor(QColor("white"));
-    ui->Console_textEdit->verticalScrollBar()->setValue(ui->Console_textEdit->verticalScrollBar()->maximum()); // scrolling to bottom automatically
+    ui->Console_textEdit->appendMessage(message, QColor(color)); // queued, drawn with the next console frame
     // ui->Console_textEdit->setTextInteractionFlags(Qt::TextSelectableByMouse); // -> enables mouse intereaction
 }
 
@@ -641,8 +1087,8 @@ void MainWindow::on_TCP_EnableManualInput_checkBox_stateChanged(int arg1)
 /**
  * @brief Connect button
  *
- *  TCP connect button. Checks current state and gathers requierd port and
- *  host adrres from correspoding boxes. Then calls the internal method for connecting
+ *  TCP connect button. Gathers requierd port and host adrres from correspoding boxes.
+ *  Then calls the internal method for opening a new link. While a link is connecting, cancels it
  *
  * @code {.c++}
  *  MainWindow::on_TCP_Connect_pushButton_clicked()
@@ -651,24 +1097,40 @@ void MainWindow::on_TCP_EnableManualInput_checkBox_stateChanged(int arg1)
  */
 void MainWindow::on_TCP_Connect_pushButton_clicked()
 {
-    if (!isConnected) // if Not connected
+    if (connectingLink >= 0) // attempt running -> cancel it
     {
-        if (ui->TCP_EnableManualInput_checkBox->isChecked())
-        {
-            targetHostAdress = ui->TCP_ManualInput_IP_lineEdit->text();
-            targetPortAdress = ui->TCP_ManualInput_Port_lineEdit->text();
-        }
-        else
-        {
-            targetHostAdress = ui->TCP_Select_IP_comboBox->currentText();
-            targetPortAdress = ui->TCP_Select_Port_comboBox->currentText();
-        }
-        connectTCP(targetHostAdress, targetPortAdress);
+        int index = indexOfLink(connectingLink);
+        if (index >= 0)
+            QMetaObject::invokeMethod(links[index].link, "stop", Qt::QueuedConnection);
+        return;
     }
-    else // if Connected
+
+    if (ui->TCP_EnableManualInput_checkBox->isChecked())
     {
-        disconnectTCP();
+        targetHostAdress = ui->TCP_ManualInput_IP_lineEdit->text();
+        targetPortAdress = ui->TCP_ManualInput_Port_lineEdit->text();
     }
+    else
+    {
+        targetHostAdress = ui->TCP_Select_IP_comboBox->currentText();
+        targetPortAdress = ui->TCP_Select_Port_comboBox->currentText();
+    }
+    connectTCP(targetHostAdress, targetPortAdress); // new link, connected links are kept
+}
+
+/**
+ * @brief Disconnect button
+ *
+ *  Closes the link selected on the links list.
+ *
+ * @code {.c++}
+ *  MainWindow::on_TCP_Disconnect_pushButton_clicked()
+ * @endcode
+ *
+ */
+void MainWindow::on_TCP_Disconnect_pushButton_clicked()
+{
+    disconnectTCP();
 }
 
 /**
@@ -703,7 +1165,63 @@ void MainWindow::on_ConsoleSend_pushButton_clicked()
  */
 void MainWindow::on_Console_Clear_pushButton_clicked()
 {
-    ui->Console_textEdit->clear();
+    ui->Console_textEdit->clearConsole();
+}
+
+/**
+ * @brief Search Console
+ *
+ * Opens log viewer window for searching and filtering every line received in this session.
+ *
+ * @code {.c++}
+ * MainWindow::on_Console_Search_pushButton_clicked()
+ * @endcode
+ *
+ */
+void MainWindow::on_Console_Search_pushButton_clicked()
+{
+    LogViewerWindow *newWidget = new LogViewerWindow(&logStore, nullptr);
+    newWidget->show();
+}
+
+/**
+ * @brief Procedure Runner
+ *
+ * Opens procedure window on the selected link for running command sequences of a procedure file.
+ *
+ * @code {.c++}
+ * MainWindow::on_Console_Procedure_pushButton_clicked()
+ * @endcode
+ *
+ */
+void MainWindow::on_Console_Procedure_pushButton_clicked()
+{
+    QString command;
+    TelemetryLink *link = commandTarget(&command);
+    if (link == nullptr)
+    {
+        displayMessageBox("Not connected to any Host !", "Black");
+        return;
+    }
+
+    ProcedureWindow *newWidget = new ProcedureWindow(link, nullptr);
+    newWidget->show();
+}
+
+/**
+ * @brief Pause Console
+ *
+ * Checkbox function for pausing console. While paused, incoming messages are
+ * buffered but not drawn. Unchecking draws the buffered messages and follows the last line again.
+ *
+ * @code {.c++}
+ * MainWindow::on_Console_Pause_checkBox_stateChanged(int arg1)
+ * @endcode
+ *
+ */
+void MainWindow::on_Console_Pause_checkBox_stateChanged(int arg1)
+{
+    ui->Console_textEdit->setPaused(arg1);
 }
 
 
@@ -747,11 +1265,15 @@ void MainWindow::on_Data_tableView_doubleClicked(const QModelIndex &index)
 {
     if (index.column() == 4) // Check if double clicked on property name only
     {
-        QString targetName = Data_tablewView_ItemModel->itemFromIndex(index)->text();                                                   // Get the name of the double clicked property
-        PlottingWindow *newWidget = new PlottingWindow(Data_tablewView_ItemModel, Properties_tableView_ItemModel, targetName, nullptr); // create new plotting window using clicked property
+        int property = PropertyRegistry::instance().find(index.data().toString()); // Get the id of the double clicked property
+        if (property == NoProperty)
+        {
+            displayMessageBox("Please select Property name only.", "black");
+            return;
+        }
+        PlottingWindow *newWidget = new PlottingWindow(&telemetryStore, &telemetryBus, &telemetryStatistics, Properties_tableView_ItemModel, property, nullptr); // create new plotting window using clicked property
+        newWidget->setAttribute(Qt::WA_DeleteOnClose); // unsubscribes from the bus when closed
         newWidget->show();
-
-        temperaturePlots.append(newWidget);
     }
     else // display error message
     {
@@ -772,19 +1294,21 @@ void MainWindow::on_Data_tableView_doubleClicked(const QModelIndex &index)
  */
 void MainWindow::on_Properties_tableView_doubleClicked(const QModelIndex &index)
 {
-    QString targetName = Properties_tableView_ItemModel->itemFromIndex(index)->text(); // getting the name for table
-
-    PlottingWindow *newWidget = new PlottingWindow(Data_tablewView_ItemModel, Properties_tableView_ItemModel, targetName, nullptr);
+    QVariant property = Properties_tableView_ItemModel->item(index.row(), 0)->data(Qt::UserRole); // getting the id of the row
+    if (!property.isValid()) // header row
+        return;
 
+    PlottingWindow *newWidget = new PlottingWindow(&telemetryStore, &telemetryBus, &telemetryStatistics, Properties_tableView_ItemModel, property.toInt(), nullptr);
+    newWidget->setAttribute(Qt::WA_DeleteOnClose); // unsubscribes from the bus when closed
     newWidget->show();
-
-    temperaturePlots.append(newWidget);
 }
 
 /**
  * @brief Clear Table View Function
  *
  *  Function for cleaning all data on table view. It does not affect database.
+ *  Table only keeps line indexes, text stays in the log store, which keeps the
+ *  last LogStore::retainedLines() lines and drops older ones with their text.
  *
  * @code {.c++}
  * MainWindow::on_DataView_Clear_pushButton_clicked()
@@ -793,13 +1317,16 @@ void MainWindow::on_Properties_tableView_doubleClicked(const QModelIndex &index)
  */
 void MainWindow::on_DataView_Clear_pushButton_clicked()
 {
-    Data_tablewView_ItemModel->clear();
+    Data_tableView_Model->clearRows();
 }
 
 /**
  * @brief Create csv file at selected location by user.
  *
- *  This function creates csv file from data table.
+ *  This function creates csv file from the session database or columnar binary file
+ *  from telemetry store. User selects the format, property and time range to export,
+ *  export runs on a seperate thread and can be cancelled.
+ *  Data table view is not used, so cleared rows are also exported.
  * @code {.c++}
  * MainWindow::on_DataView_Export_exportConsole_pushButton_clicked()
  * @endcode
@@ -807,30 +1334,80 @@ void MainWindow::on_DataView_Clear_pushButton_clicked()
  */
 void MainWindow::on_DataView_Export_exportConsole_pushButton_clicked()
 {
+    if (exportThread != nullptr) // only one export at a time
+    {
+        displayMessageBox("An export is already running !", "black");
+        return;
+    }
+
+    // properties known in this session
+    QStringList properties;
+    for (int i = 1; i < Properties_tableView_ItemModel->rowCount(); i++)
+    {
+        properties.append(Properties_tableView_ItemModel->item(i, 0)->text());
+    }
+
+    ExportDialog dialog(properties, sessionStart, this);
+    if (dialog.exec() != QDialog::Accepted)
+        return;
 
     QString filename = QFileDialog::getSaveFileName(this, tr("Save Text File"), QStandardPaths::writableLocation(QStandardPaths::DesktopLocation));
-    QFile file(filename + ".csv");
-    if (file.open(QIODevice::WriteOnly))
-    {
-        QTextStream stream(&file);
-
-        stream << "<TimeStamp>"
-               << ","
-               << "<Sequence Number>"
-               << ","
-               << "<Keyword>"
-               << ","
-               << "<Property>"
-               << ","
-               << "<Value>"
-               << "\n";
-        for (int i = 1; i < Data_tablewView_ItemModel->rowCount(); i++)
-        {
-            stream << Data_tablewView_ItemModel->item(i, 0)->text() + " " + Data_tablewView_ItemModel->item(i, 1)->text() << "," << Data_tablewView_ItemModel->item(i, 2)->text() << "," << Data_tablewView_ItemModel->item(i, 3)->text() << "," << Data_tablewView_ItemModel->item(i, 4)->text() << "," << Data_tablewView_ItemModel->item(i, 5)->text();
-        }
-        stream.flush();
+    if (filename.length() == 0)
+        return;
+
+    exportOptions options = dialog.options();
+
+    // worker thread for export
+    exportThread = new QThread(this);
+    if (options.format == exportColumnar) // columnar file from telemetry store
+    {
+        options.path = filename + ".aibc";
+        exporter = new ColumnarExporter(&telemetryStore, options);
+    }
+    else // csv file from database
+    {
+        options.path = filename + ".csv";
+        exporter = new CsvExporter(db.databaseName(), options);
+    }
+    exporter->moveToThread(exportThread);
+    connect(exportThread, SIGNAL(started()), exporter, SLOT(run()));
+    connect(exporter, SIGNAL(finished(bool, QString)), this, SLOT(onExportFinished(bool, QString)));
+
+    // progress window
+    exportProgress = new QProgressDialog("Exporting session...", "Cancel", 0, 100, this);
+    exportProgress->setMinimumDuration(0);
+    connect(exporter, SIGNAL(progress(int)), exportProgress, SLOT(setValue(int)));
+    connect(exportProgress, SIGNAL(canceled()), exporter, SLOT(cancel()), Qt::DirectConnection); // worker thread is busy, flag is set directly
+
+    exportThread->start();
+}
+
+/**
+ * @brief Export finished
+ *
+ *  Called when export worker is done. Closes progress window and cleans up the worker thread.
+ * @code {.c++}
+ * MainWindow::onExportFinished(bool ok, QString message)
+ * @endcode
+ *
+ */
+void MainWindow::onExportFinished(bool ok, QString message)
+{
+    exportProgress->disconnect();
+    exportProgress->deleteLater();
+    exportProgress = nullptr;
+
+    exportThread->quit();
+    exportThread->wait();
+    delete exporter;
+    delete exportThread;
+    exporter = nullptr;
+    exportThread = nullptr;
+
+    if (!ok)
+    {
+        displayMessageBox(message, "black");
     }
-    file.close();
 }
 
 /**
@@ -849,6 +1426,23 @@ void MainWindow::on_ShowFolder_pushButton_clicked()
 }
 
 
+/**
+ * @brief Function for opening recorded sessions
+ *
+ * Opens session browser on the data folder. Recorded sessions are plotted
+ * from their archive, so they stay available after the data table is cleared.
+ * @code {.c++}
+ * MainWindow::on_OpenSession_pushButton_clicked()
+ * @endcode
+ *
+ */
+void MainWindow::on_OpenSession_pushButton_clicked()
+{
+    SessionBrowser *browser = new SessionBrowser(QDir::currentPath() + "/data", nullptr);
+    browser->show();
+}
+
+
 /**
  * @brief Function for properties click
  *
@@ -882,7 +1476,110 @@ void MainWindow::on_PropertySet_pushButton_clicked()
 {
     if (ui->PropertyValue_lineEdit->text().length() > 0)
     {
-        sendCommand("set " + ui->PropertyName_lineEdit->text() + " " + ui->PropertyValue_lineEdit->text() + " \n");
+        sendCommand("set " + ui->PropertyName_lineEdit->text() + " " + ui->PropertyValue_lineEdit->text());
+    }
+}
+
+/**
+ * @brief Button for dashboard
+ *
+ * Opens dashboard with the selected properties, each one on its own row with a shared time axis.
+ *
+ * @code {.c++}
+ * MainWindow::on_Properties_Dashboard_pushButton_clicked()
+ * @endcode
+ *
+ */
+void MainWindow::on_Properties_Dashboard_pushButton_clicked()
+{
+    QVector<int> properties;
+    QModelIndexList selected = ui->Properties_tableView->selectionModel()->selectedIndexes(); // any cell of a row selects the property
+
+    for (int i = 0; i < selected.size(); i++)
+    {
+        QVariant property = Properties_tableView_ItemModel->item(selected[i].row(), 0)->data(Qt::UserRole);
+        if (property.isValid() && !properties.contains(property.toInt())) // header row has no id
+            properties.append(property.toInt());
     }
+
+    DashboardWindow *newWidget = new DashboardWindow(&telemetryStore, &telemetryBus, Properties_tableView_ItemModel, properties, nullptr);
+    newWidget->show();
 }
 
+/**
+ * @brief Button for alarms
+ *
+ * Opens the alarm panel, panel of the session is raised if it is already open.
+ *
+ * @code {.c++}
+ * MainWindow::on_Properties_Alarms_pushButton_clicked()
+ * @endcode
+ *
+ */
+void MainWindow::on_Properties_Alarms_pushButton_clicked()
+{
+    if (alarmWindow.isNull())
+        alarmWindow = new AlarmWindow(&alarmEngine, &telemetryStore, nullptr);
+    alarmWindow->show();
+    alarmWindow->raise();
+    alarmWindow->activateWindow();
+}
+
+/**
+ * @brief Button for derived channels
+ *
+ * Channels are edited as text, one "<name> = <expression>" per line.
+ * Definitions are asked again until they compile or editing is cancelled.
+ *
+ * @code {.c++}
+ * MainWindow::on_Properties_Derived_pushButton_clicked()
+ * @endcode
+ *
+ */
+void MainWindow::on_Properties_Derived_pushButton_clicked()
+{
+    QString text = derivedChannels.definitions().join("\n");
+    QString error;
+    while (true)
+    {
+        bool ok = false;
+        QString label = "One channel per line, <name> = <expression>\nOperators + - * / ^, functions abs sqrt exp log sin cos min max, avg(<property>, <seconds>)";
+        if (!error.isEmpty())
+            label = error + "\n\n" + label;
+
+        text = QInputDialog::getMultiLineText(this, "Derived Channels", label, text, &ok);
+        if (!ok)
+            return;
+        QStringList namespaces;
+        for (int i = 0; i < links.size(); i++)
+            namespaces.append(links[i].link->prefix());
+        if (derivedChannels.setDefinitions(text.split('\n'), namespaces, &error))
+            return;
+    }
+}
+
+/**
+ * @brief Button for aligned properties
+ *
+ * Opens the selected properties resampled on a common time grid, as table and X-Y plot.
+ *
+ * @code {.c++}
+ * MainWindow::on_Properties_Resample_pushButton_clicked()
+ * @endcode
+ *
+ */
+void MainWindow::on_Properties_Resample_pushButton_clicked()
+{
+    QVector<int> properties;
+    QModelIndexList selected = ui->Properties_tableView->selectionModel()->selectedIndexes(); // any cell of a row selects the property
+
+    for (int i = 0; i < selected.size(); i++)
+    {
+        QVariant property = Properties_tableView_ItemModel->item(selected[i].row(), 0)->data(Qt::UserRole);
+        if (property.isValid() && !properties.contains(property.toInt())) // header row has no id
+            properties.append(property.toInt());
+    }
+
+    ResampleWindow *newWidget = new ResampleWindow(&telemetryStore, Properties_tableView_ItemModel, properties, nullptr);
+    newWidget->show();
+}
@@ -19,12 +19,55 @@
 #include <QTextCursor>
 #include <QKeyEvent>
 #include <QAction>
+#include <QThread>
+#include <QProgressDialog>
+#include <QPointer>
 
 //
 //***------- user Libraries ----***//
 //
 #include "plottingwindow.h"
 #include "qcustomplot.h"
+#include "consoleview.h"
+#include "logstore.h"
+#include "logviewerwindow.h"
+#include "csvexporter.h"
+#include "columnarexporter.h"
+#include "telemetrystore.h"
+#include "exportdialog.h"
+#include "telemetry.h"
+#include "sessionfile.h"
+#include "sessionbrowser.h"
+#include "propertyregistry.h"
+#include "telemetryparser.h"
+#include "datatablemodel.h"
+#include "telemetrybus.h"
+#include "telemetrylink.h"
+#include "telemetrystatistics.h"
+#include "alarmengine.h"
+#include "alarmwindow.h"
+#include "derivedchannels.h"
+
+// -> properties table state of a property
+struct propertyRow
+{
+public:
+    int row = -1;      // row in the table, -1 if not shown yet
+    int lastLine = -1; // log line of the last received value
+    bool changed = false;
+};
+
+// -> connection to an EGSE server and its ingest thread
+struct linkEntry
+{
+public:
+    TelemetryLink *link = nullptr;
+    QThread *thread = nullptr;
+    bool connected = false;
+    bool listed = false;  // shown on the links list
+    int attempt = 0;      // reconnect attempt, 0 while connected
+    qint64 lostLines = 0; // lines missing in sequence numbers
+};
 //
 //***-------------------------***//
 
@@ -33,7 +76,7 @@ namespace Ui
     class MainWindow;
 }
 
-class MainWindow : public QMainWindow
+class MainWindow : public QMainWindow, public TelemetrySubscriber
 {
     Q_OBJECT
 
@@ -67,11 +110,12 @@ public:
     void setupDataFolder(); //-> creates folder for storing data
     // Data table
     void setupData_tableView();                //-> function to setup dataTable View
-    void addData_tableView(QStringList datas); //-> function to add item to existing table View
     // Properties table
     void setupProperties_tableView();                              // -> setup for column headers in properties table view
-    void addProperties_tableView(QString property, QString value); // -> adds properties to the tableView
-    bool checkPropertyExists_tableView(QString item);              // -> returns if property exists in the table already
+    void addProperties_tableView(int property, int line);          // -> marks property value changed, line is index in the log store
+    void updateProperties_tableView();                             // -> shows last values of changed properties
+
+    void deliver(const QVector<telemetrySample> &samples) override; // -> properties table and database rows of a receive batch
 
     //
 
@@ -86,10 +130,18 @@ private slots:
 
 
     
-    void connectTCP(QString &host, QString &Port); // connects to the given port and host ip
-    void disconnectTCP();                          // Disconnects from the host
-    void onReadyRead();                            // Reading incoming bytes form TCP Port
+    void connectTCP(QString &host, QString &Port); // opens a new link to the given port and host ip
+    void disconnectTCP();                          // Disconnects the selected link
     void sendCommand(QString command);             // Sends given string as command returns if succesfull
+
+    //  ***  Links  *** //
+    void onLinkConnected(int link);                         // link is added to the links list
+    void onLinkFailed(int link, QString message);           // link could not connect, removed
+    void onLinkDisconnected(int link);                      // link closed, removed
+    void onLinkReconnecting(int link, int attempt, int delay); // connection lost, link retries
+    void onLinkGap(int link, qint64 lost, qint64 totalLost);   // lines missing in sequence numbers
+    void onBatchReady(ingestBatch batch);                   // lines received by a link
+    void onCommandFinished(commandResult result);           // ack or failure of a sent command
     /*
      */
 
@@ -98,6 +150,8 @@ private slots:
 
     void on_TCP_Connect_pushButton_clicked();
 
+    void on_TCP_Disconnect_pushButton_clicked();
+
     void on_TCP_EnableManualInput_checkBox_stateChanged(int arg1);
 
     void on_Data_tableView_doubleClicked(const QModelIndex &index);
@@ -105,30 +159,59 @@ private slots:
     void on_DataView_Clear_pushButton_clicked();
 
     void on_DataView_Export_exportConsole_pushButton_clicked();
+    void onExportFinished(bool ok, QString message); // called by export worker at the end
 
     void on_Properties_tableView_doubleClicked(const QModelIndex &index);
 
     void on_Console_Clear_pushButton_clicked();
 
+    void on_Console_Pause_checkBox_stateChanged(int arg1);
+
+    void on_Console_Search_pushButton_clicked();
+
+    void on_Console_Procedure_pushButton_clicked();
+
     void on_Console_Export_exportConsole_pushButton_clicked();
 
     void on_ShowFolder_pushButton_clicked();
 
+    void on_OpenSession_pushButton_clicked();
+
     void on_Properties_tableView_clicked(const QModelIndex &index);
 
     void on_PropertySet_pushButton_clicked();
 
+    void on_Properties_Dashboard_pushButton_clicked();
+
+    void on_Properties_Alarms_pushButton_clicked();
+
+    void on_Properties_Derived_pushButton_clicked();
+
+    void on_Properties_Resample_pushButton_clicked();
+
 private:
     //  *** Private object definitions  *** //
     QTimer *serialTimer;                                    //-> for timing applications
-    QTcpSocket socket;                                      //-> for tcp connection
+    QVector<linkEntry> links;                               //-> open connections, each with its own ingest thread
+    int nextLinkId = 0;                                     //-> id of the next link
     QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE"); //-> for database access
 
-    //*** Pointer Conteiner to the Widgets ***// -> used to store open widget
-    QList<PlottingWindow *> temperaturePlots; // stores open temperature plots pointers ->will be used when updating plots
-
-    //*** Private status Toggle ***//
-    bool isConnected = 0;
+    LogStore logStore;             //-> every line shown on console, searched by log viewer
+    TelemetryStore telemetryStore; //-> numeric samples of every property as columns
+    TelemetryBus telemetryBus;     //-> delivers received samples to views and recorders
+    SessionWriter sessionWriter{&telemetryStore}; //-> writes store to session file, declared after the store
+    TelemetryStatistics telemetryStatistics{&telemetryStore}; //-> running and windowed statistics of each property
+    AlarmEngine alarmEngine{&telemetryStore};                 //-> limit rules, state changes are marked in the store
+    QPointer<AlarmWindow> alarmWindow;                        //-> alarm panel, one for the session
+    DerivedChannels derivedChannels{&telemetryStore};         //-> channels computed from received samples, owns their series
+    QVector<telemetrySample> derivedSamples;                  //-> outputs of the current batch, capacity is kept
+    void publishDerivedSamples();                             // stores, logs and publishes outputs of the batch
+    QDateTime sessionStart;        //-> time database is created
+
+    //*** Export worker ***//
+    QThread *exportThread = nullptr;
+    SessionExporter *exporter = nullptr;
+    QProgressDialog *exportProgress = nullptr;
 
     //*** Private TCP Variables ***//
     QString targetHostAdress;
@@ -137,11 +220,24 @@ private:
     // -> Standard Model Items for the widgets in the ui
     // also acts as a data storage structure at ui
     QStandardItemModel *mainItemModel;                  // Model to store all commands
-    QStandardItemModel *Data_tablewView_ItemModel;      // Model to store all incoming respond from server
+    DataTableModel *Data_tableView_Model;               // Model showing all incoming telemetry from the log store
     QStandardItemModel *Properties_tableView_ItemModel; // Model to store all properties received from server
-
-    void setupDatabase();                                                                                     // creating database on local repo
-    void addElementToDatabase(QString date, QString sequence, QString note, QString property, QString value); // adding element to the database
+    QVector<propertyRow> propertyRows;                  // properties table state of each property id
+    QVector<int> changedProperties;                     // properties received in current batch
+
+    void setupDatabase();                                                    // creating database on local repo
+    void addElementToDatabase(const telemetryRecord &record, double key);    // adding element to the database
+    QSqlQuery *insertQuery = nullptr;                                        // prepared once, reused for every row
+
+    //  ***  Links  *** //
+    int indexOfLink(int link) const;                        // index in links, -1 if not exists
+    TelemetryLink *commandTarget(QString *command);          // link of the command, namespace is removed from the command
+    void removeLink(int index);                             // stops the thread and deletes the link
+    void updateLinkItem(int index);                         // shows state of the link on the links list
+    void setConnecting(int link);                           // shows progress of the connecting link, -1 when done
+    int connectingLink = -1;                                // link waiting for its first connection
+    telemetryRecord ingestRecord;                           // tokens of a stored line
+    QByteArray consoleBytes;                                // received lines of a batch for the console, reused between batches
 
     //  ***  Key event  *** //
     void keyPressEvent(QKeyEvent *event) override; // function to handle keypresses
@@ -1,9 +1,13 @@
 #include "plottingwindow.h"
 #include "ui_plottingwindow.h"
+#include "telemetry.h"
 
 // ---- Definitions ---- //
 
-#define DateFormat "yyyy-MMM-dd-hh:mm:ss" ///< Time Date format to sort timestamp
+#define RangeLoadDelay 30 ///< Time in ms waited after range change before loading recorded samples
+#define ValueMargin 0.05  ///< Part of the value range added above and below when fitting
+#define ExportDpi 300     ///< Output resolution assumed for pdf files, pdf sizes are in points (1/72 inch)
+#define PlotMarkerLimit 200 ///< Gap or alarm markers drawn at most, newest ones around the visible range
 
 //  -----------      ----------------                Constructor Functions                     ----------------              ---------------- //
 //
@@ -25,15 +29,18 @@ PlottingWindow::PlottingWindow(QWidget *parent) : QWidget(parent),
 /**
  * @brief Advanced Consturctor
  *
- * Called when
+ * Called when plotting live data. Received samples are copied from the telemetry store,
+ * new ones are delivered by the telemetry bus for the plotted properties only.
+ * Available properties are taken from the properties table model, window statistics
+ * of the plotted properties are read from the statistics engine.
  *
  * @code {.c++}
- * PlottingWindow::PlottingWindow(QStandardItemModel *target, QStandardItemModel *mainProperties, QString name, QWidget *parent) : QWidget(parent), ui(new Ui::PlottingWindow),
- targetModelProperties(mainProperties),targetModel(target),targetName(name)
+ * PlottingWindow::PlottingWindow(TelemetryStore *store, TelemetryBus *bus, TelemetryStatistics *statistics, QStandardItemModel *mainProperties, int property, QWidget *parent) : QWidget(parent), ui(new Ui::PlottingWindow),
+ targetStore(store), targetBus(bus), targetStatistics(statistics), targetModelProperties(mainProperties), targetProperty(property)
  * @endcode
  */
-PlottingWindow::PlottingWindow(QStandardItemModel *target, QStandardItemModel *mainProperties, QString name, QWidget *parent) : QWidget(parent), ui(new Ui::PlottingWindow),
-                                                                                                                                targetModelProperties(mainProperties), targetModel(target), targetName(name)
+PlottingWindow::PlottingWindow(TelemetryStore *store, TelemetryBus *bus, TelemetryStatistics *statistics, QStandardItemModel *mainProperties, int property, QWidget *parent) : QWidget(parent), ui(new Ui::PlottingWindow),
+                                                                                                                                                                          targetStore(store), targetBus(bus), targetStatistics(statistics), targetModelProperties(mainProperties), targetProperty(property)
 {
   ui->setupUi(this); // UI initalization
 
@@ -42,7 +49,7 @@ PlottingWindow::PlottingWindow(QStandardItemModel *target, QStandardItemModel *m
   startTime = QDateTime::currentDateTime().toTime_t(); // Save start time for the plotting
 
   //
-  dataStruct *temp = new dataStruct(name); // Data Struct for holding datas for each property
+  dataStruct *temp = new dataStruct(property); // Data Struct for holding datas for each property
   array.append(temp);                      // Add to the main properties array
 
   //  *** Setup Plotting ui and List View  *** //
@@ -52,6 +59,57 @@ PlottingWindow::PlottingWindow(QStandardItemModel *target, QStandardItemModel *m
   setupPlot();
 
   //  *** Setup Interactions  *** //
+  setupInteractions();
+}
+
+/**
+ * @brief Recorded Session Consturctor
+ *
+ * Called when plotting a recorded session. Samples are not copied into the window,
+ * only the visible range is loaded from the source whenever the time axis changes.
+ *
+ * @code {.c++}
+ * PlottingWindow::PlottingWindow(QSharedPointer<SampleSource> source, int property, QWidget *parent) : QWidget(parent), ui(new Ui::PlottingWindow),
+ archiveSource(source), targetProperty(property)
+ * @endcode
+ */
+PlottingWindow::PlottingWindow(QSharedPointer<SampleSource> source, int property, QWidget *parent) : QWidget(parent), ui(new Ui::PlottingWindow),
+                                                                                                    archiveSource(source), targetProperty(property)
+{
+  ui->setupUi(this); // UI initalization
+
+  setupSettings(); // Add necessary objects to the arrays -> used to select plotting styles
+
+  rangeTimer = new QTimer(this);
+  rangeTimer->setSingleShot(true);
+  rangeTimer->setInterval(RangeLoadDelay);
+  connect(rangeTimer, SIGNAL(timeout()), this, SLOT(loadVisibleRange()));
+
+  dataStruct *temp = new dataStruct(property); // Data Struct for the first property
+  array.append(temp);
+
+  //  *** Setup Plotting ui and List View  *** //
+  //
+  setupProperties_ListView();
+
+  setupPlot();
+
+  //  *** Setup Interactions  *** //
+  setupInteractions();
+  connect(ui->widgetCustomPlot->xAxis, SIGNAL(rangeChanged(QCPRange)), this, SLOT(onRangeChanged(QCPRange)));
+}
+
+/**
+ * @brief Setup interactions
+ *
+ * Sets up legend, context menu and mouse interactions of the plot.
+ *
+ * @code {.c++}
+ * PlottingWindow::setupInteractions()
+ * @endcode
+ */
+void PlottingWindow::setupInteractions()
+{
   ui->widgetCustomPlot->legend->setVisible(true);
 
   QFont legendFont = font();
@@ -69,31 +127,205 @@ PlottingWindow::PlottingWindow(QStandardItemModel *target, QStandardItemModel *m
  * @brief Mouse Move
  *
  * This function emitted when mouse moved on plot.
- * Checks the coordinaes and displays the corresponding values for the mouse tip display.
+ * Moves the crosshair to the cursor and shows the nearest sample of each graph.
+ * Only the overlay layer is redrawn, so hovering does not depend on the number of samples.
  * @code {.c++}
  * PlottingWindow::mouseMove(QMouseEvent *event)
  * @endcode
  */
 void PlottingWindow::mouseMove(QMouseEvent *event)
 {
-  int x = ui->widgetCustomPlot->xAxis->pixelToCoord(event->pos().x()); // get corresponding x - Axis Value
-  int y = ui->widgetCustomPlot->yAxis->pixelToCoord(event->pos().y()); // get corresponding y - Axis Value
+  if (crosshairLine == nullptr)
+    return;
+
+  bool inside = ui->widgetCustomPlot->axisRect()->rect().contains(event->pos());
+  crosshairLine->setVisible(inside);
+  crosshairText->setVisible(inside);
+  for (int i = 0; i < crosshairTracers.size(); i++)
+    crosshairTracers[i]->setVisible(false);
+
+  if (inside)
+  {
+    double key = ui->widgetCustomPlot->xAxis->pixelToCoord(event->pos().x()); // get corresponding x - Axis Value
+    crosshairLine->point1->setCoords(key, 0);
+    crosshairLine->point2->setCoords(key, 1);
+
+    QString readout = QDateTime::fromMSecsSinceEpoch(qint64(key * 1000)).toString(DateFormat);
+    for (int i = 0; i < crosshairTracers.size() && i < ui->widgetCustomPlot->graphCount(); i++) // nearest sample of each graph
+    {
+      QCPGraphData sample;
+      if (!nearestSample(ui->widgetCustomPlot->graph(i), key, &sample))
+        continue;
+
+      crosshairTracers[i]->position->setCoords(sample.key, sample.value);
+      crosshairTracers[i]->setPen(ui->widgetCustomPlot->graph(i)->pen()); // follows color changes
+      crosshairTracers[i]->setVisible(true);
+      readout += "\n" + ui->widgetCustomPlot->graph(i)->name() + " : " + QString::number(sample.value) + "  (" + QDateTime::fromMSecsSinceEpoch(qint64(sample.key * 1000)).toString("hh:mm:ss") + ")";
+    }
+    crosshairText->setText(readout);
+  }
+
+  ui->widgetCustomPlot->layer("overlay")->replot();
+}
+
+/**
+ * @brief Setup crosshair
+ *
+ * Items are removed with the other items when the plot is set up again, so they are created for each setup.
+ * @code {.c++}
+ * PlottingWindow::setupCrosshair()
+ * @endcode
+ */
+void PlottingWindow::setupCrosshair()
+{
+  crosshairLine = new QCPItemStraightLine(ui->widgetCustomPlot);
+  crosshairLine->setLayer("overlay");
+  crosshairLine->setPen(QPen(Qt::gray, 0, Qt::DashLine));
+  crosshairLine->setSelectable(false);
+  crosshairLine->setVisible(false);
+
+  crosshairText = new QCPItemText(ui->widgetCustomPlot);
+  crosshairText->setLayer("overlay");
+  crosshairText->position->setType(QCPItemPosition::ptAxisRectRatio);
+  crosshairText->position->setCoords(0.01, 0.01);
+  crosshairText->setPositionAlignment(Qt::AlignTop | Qt::AlignLeft);
+  crosshairText->setTextAlignment(Qt::AlignLeft);
+  crosshairText->setBrush(QBrush(QColor(255, 255, 255, 200)));
+  crosshairText->setPadding(QMargins(4, 2, 4, 2));
+  crosshairText->setSelectable(false);
+  crosshairText->setVisible(false);
+
+  crosshairTracers.clear();
+  for (int i = 0; i < ui->widgetCustomPlot->graphCount(); i++)
+  {
+    QCPItemTracer *tracer = new QCPItemTracer(ui->widgetCustomPlot);
+    tracer->setLayer("overlay");
+    tracer->setStyle(QCPItemTracer::tsCircle);
+    tracer->setSize(7);
+    tracer->setSelectable(false);
+    tracer->setVisible(false);
+    crosshairTracers.append(tracer);
+  }
+}
 
-  QToolTip::showText(event->globalPos(), QDateTime::fromTime_t(x).toString() + " \n Value: " + QString::number(y)); // Show value on mouse tip
+/**
+ * @brief Setup statistics bands
+ *
+ * Bands are hidden until enabled from the context menu. They are drawn on the grid layer,
+ * so graphs stay on top of them.
+ * @code {.c++}
+ * PlottingWindow::setupStatisticsBands()
+ * @endcode
+ */
+void PlottingWindow::setupStatisticsBands()
+{
+  rangeBands.clear();
+  deviationBands.clear();
+  meanLines.clear();
+  if (targetStatistics == nullptr)
+    return;
 
-  // setToolTip(QString("%1 , %2").arg(x).arg(y));
+  for (int i = 0; i < ui->widgetCustomPlot->graphCount(); i++)
+  {
+    QCPItemRect *range = new QCPItemRect(ui->widgetCustomPlot);
+    range->setLayer("grid");
+    range->setPen(Qt::NoPen);
+    range->setSelectable(false);
+    range->setVisible(false);
+    rangeBands.append(range);
+
+    QCPItemRect *deviation = new QCPItemRect(ui->widgetCustomPlot);
+    deviation->setLayer("grid");
+    deviation->setPen(Qt::NoPen);
+    deviation->setSelectable(false);
+    deviation->setVisible(false);
+    deviationBands.append(deviation);
+
+    QCPItemLine *mean = new QCPItemLine(ui->widgetCustomPlot);
+    mean->setLayer("grid");
+    mean->setSelectable(false);
+    mean->setVisible(false);
+    meanLines.append(mean);
+  }
+  updateStatisticsBands();
+}
+
+/**
+ * @brief Update statistics bands
+ *
+ * Each band covers the time of the statistics window. Outer band shows the window minimum
+ * and maximum, inner band the mean plus minus one standard deviation. Statistics are kept
+ * by the statistics engine, nothing is computed from the graph.
+ * @code {.c++}
+ * PlottingWindow::updateStatisticsBands()
+ * @endcode
+ */
+void PlottingWindow::updateStatisticsBands()
+{
+  for (int i = 0; i < rangeBands.size() && i < array.size() && i < ui->widgetCustomPlot->graphCount(); i++)
+  {
+    const propertyStatistics *stats = targetStatistics->statistics(array[i]->property);
+    bool visible = statisticsBands && stats != nullptr;
+    rangeBands[i]->setVisible(visible);
+    deviationBands[i]->setVisible(visible);
+    meanLines[i]->setVisible(visible);
+    if (!visible)
+      continue;
+
+    QColor color = ui->widgetCustomPlot->graph(i)->pen().color(); // follows color changes
+    color.setAlpha(25);
+    rangeBands[i]->setBrush(color);
+    color.setAlpha(60);
+    deviationBands[i]->setBrush(color);
+    color.setAlpha(255);
+    meanLines[i]->setPen(QPen(color, 1, Qt::DashLine));
+
+    double deviation = stats->windowStddev();
+    rangeBands[i]->topLeft->setCoords(stats->windowFirstKey, stats->windowMaxValue());
+    rangeBands[i]->bottomRight->setCoords(stats->lastKey, stats->windowMinValue());
+    deviationBands[i]->topLeft->setCoords(stats->windowFirstKey, stats->windowMean + deviation);
+    deviationBands[i]->bottomRight->setCoords(stats->lastKey, stats->windowMean - deviation);
+    meanLines[i]->start->setCoords(stats->windowFirstKey, stats->windowMean);
+    meanLines[i]->end->setCoords(stats->lastKey, stats->windowMean);
+  }
+}
+
+/**
+ * @brief Nearest sample of the graph
+ *
+ * Keys of the graph are sorted, the sample at the key is found by binary search
+ * and compared with its left neighbour.
+ * @code {.c++}
+ * PlottingWindow::nearestSample(QCPGraph *graph, double key, QCPGraphData *sample)
+ * @endcode
+ */
+bool PlottingWindow::nearestSample(QCPGraph *graph, double key, QCPGraphData *sample)
+{
+  QSharedPointer<QCPGraphDataContainer> data = graph->data();
+  if (data->isEmpty())
+    return false;
+
+  QCPGraphDataContainer::const_iterator found = data->findBegin(key, false); // first sample with key >= cursor
+  if (found == data->constEnd() || (found != data->constBegin() && key - (found - 1)->key < found->key - key))
+    --found;
+
+  *sample = *found;
+  return true;
 }
 
 /**
  * @brief Destructor
  *
- * Called when window is closed
+ * Called when window is closed, live windows are removed from the telemetry bus.
  * @code {.c++}
  * PlottingWindow::~PlottingWindow()
  * @endcode
  */
 PlottingWindow::~PlottingWindow()
 {
+  if (targetBus != nullptr)
+    targetBus->unsubscribe(this);
+  qDeleteAll(array);
   delete ui;
 }
 
@@ -145,6 +377,11 @@ void PlottingWindow::setupPlot()
 {
   // Clear graph
   ui->widgetCustomPlot->clearGraphs();
+  ui->widgetCustomPlot->clearItems(); // gap markers are added again for the new properties
+  gapItems.clear();
+  drawnGaps = -1;
+  alarmItems.clear();
+  drawnAlarms = -1;
   ui->widgetCustomPlot->replot();
   //
 
@@ -155,7 +392,7 @@ void PlottingWindow::setupPlot()
 
   // x Axis graph properties setup
   ui->widgetCustomPlot->xAxis->label();
-  ui->widgetCustomPlot->xAxis->setTickLabels(false);
+  ui->widgetCustomPlot->xAxis->setTickLabels(true); // labels are cached by the time ticker
   ui->widgetCustomPlot->xAxis->setLabel("Time");
   ui->widgetCustomPlot->xAxis2->setVisible(true);
   ui->widgetCustomPlot->xAxis2->setTickLabels(false);
@@ -165,57 +402,39 @@ void PlottingWindow::setupPlot()
   ui->widgetCustomPlot->yAxis->ticker()->setTickCount(10);
 
   // Setting x Axis as time axis
-  QSharedPointer<QCPAxisTickerDateTime> dateTicker(new QCPAxisTickerDateTime);
-  dateTicker->setDateTimeFormat(DateFormat);
+  QSharedPointer<TimeAxisTicker> dateTicker(new TimeAxisTicker);
   ui->widgetCustomPlot->xAxis->setTicker(dateTicker);
 
   // adding interaction with graph
   ui->widgetCustomPlot->setInteractions(QCP::iRangeDrag | QCP::iRangeZoom | QCP::iSelectAxes | QCP::iSelectLegend | QCP::iSelectPlottables);
 
+  if (targetBus != nullptr) // only plotted properties are delivered
+    targetBus->unsubscribe(this);
+
   for (int i = 0; i < array.size(); i++) // for each element to be plotted
   {
-
-    array[i]->x.clear(); // reset data on x axis
-    array[i]->y.clear(); // reset data on y axis
-
     ui->widgetCustomPlot->addGraph();
+    if (targetBus != nullptr)
+      targetBus->subscribe(this, array[i]->property);
 
-    for (int j = 1; j < targetModel->rowCount() - 1; j++) // for each element in database -> search element match in database
-    {
-
-      if ((targetModel->item(j, 4)->text().size() > 0) && (array[i]->name == targetModel->item(j, 4)->text())) //check time stamps
-      {
+    array[i]->copied = 0;       // graph is new -> copy every sample again
+    if (archiveSource.isNull()) // recorded sessions are loaded by visible range
+      copyNewSamples(i);
 
-        //Get time stamp
-        QString dateTemp = targetModel->item(j, 0)->text() + "-" + targetModel->item(j, 1)->text();
-        QDateTime Date = QDateTime::fromString(dateTemp, DateFormat);
-
-        //Convert into double date style -> for key struct wre gonna use at our data struct
-        double dateDouble = Date.toTime_t();
-
-        QStringList temp = targetModel->item(j, 5)->text().split("/"); //seperate with denominatior
-
-        //creating plotting data struct with value and time
-        QCPGraphData tempTimeData;
-        tempTimeData.key = dateDouble; //
-        tempTimeData.value = temp[0].toDouble(); //
-
-        array[i]->timeData.push_back(tempTimeData); //add plotting block for data to data struct
-      }
-    }
-    ui->widgetCustomPlot->graph(i)->data()->set(array[i]->timeData); //set graph data to the our data struct
-
-    ui->widgetCustomPlot->graph(i)->setName(array[i]->name); //
+    ui->widgetCustomPlot->graph(i)->setName(PropertyRegistry::instance().name(array[i]->property)); //
     ui->widgetCustomPlot->graph()->setScatterStyle(QCPScatterStyle(shapes[i], 5));
-
-    ui->widgetCustomPlot->replot();
   }
+  setupCrosshair();
+  setupStatisticsBands();
+  if (targetStore != nullptr)
+  {
+    markGaps();
+    markAlarms();
+  }
+  ui->widgetCustomPlot->replot();
 
   if(array.size() > 0 ) //if setup array is not empty
   {
-      // -> saving the previous index
-      prevIndex = targetModel->rowCount();
-      //
       // Style Options
       QColor color(20 + 200 / 4.0, 70 * (1.6 / 4.0), 150, 150);
       ui->widgetCustomPlot->graph()->setLineStyle(QCPGraph::lsLine);
@@ -237,60 +456,203 @@ void PlottingWindow::setupPlot()
 
 
 /**
- * @brief Update graphs.
+ * @brief Copy new samples to the graph
  *
+ * Only samples received after the last copy are read from the telemetry store,
+ * so updating does not depend on the amount of received data. Value bounds of the
+ * property are updated with the new samples, fitting never scans the graph.
  *
  * @code {.c++}
- * PlottingWindow::updatePlot()
+ * PlottingWindow::copyNewSamples(int index)
  * @endcode
  */
-void PlottingWindow::updatePlot()
+void PlottingWindow::copyNewSamples(int index)
 {
-  // O(n^2) on large property set !
+  dataStruct *data = array[index];
+  int count = targetStore->sampleCount(data->property); // count first, every counted sample is inside the snapshot
+  if (count <= data->copied)
+    return;
 
-  //for each item in plotting array
-  for (int i = 0; i < array.size(); i++)
+  QVector<QSharedPointer<sampleChunk>> chunks = targetStore->snapshot(data->property);
+  int chunkSize = TelemetryStore::chunkSize();
+
+  if (data->copied == 0) // bounds start with the first sample
   {
+    data->minValue = chunks.at(0)->values[0];
+    data->maxValue = data->minValue;
+  }
 
-    int prevSize = array[i]->y.size(); //get where it left on target array
+  QVector<QCPGraphData> samples;
+  samples.reserve(count - data->copied);
+  for (int i = data->copied; i < count; i++)
+  {
+    const sampleChunk *chunk = chunks.at(i / chunkSize).data();
+    double value = chunk->values[i % chunkSize];
+    samples.append(QCPGraphData(chunk->keys[i % chunkSize], value));
+    data->minValue = qMin(data->minValue, value);
+    data->maxValue = qMax(data->maxValue, value);
+  }
 
-    for (int j = prevIndex; j < targetModel->rowCount(); j++) //for each new item in main data
-    {
+  ui->widgetCustomPlot->graph(index)->data()->add(samples, true);
+  data->copied = count;
+}
 
-      if ((targetModel->item(j, 4)->text().size() > 0) && (targetModel->item(j, 4)->text() == array[i]->name)) //check if not empty
-      {
-        //handling time data
-        QString dateTemp = targetModel->item(j, 0)->text() + "-" + targetModel->item(j, 1)->text(); //Get time stamp
-        QDateTime Date = QDateTime::fromString(dateTemp, DateFormat); // convert string to time struct
-        double dateDouble = Date.toTime_t(); //convert time to key value
+/**
+ * @brief Receive batch from the telemetry bus
+ *
+ * Only samples of the plotted properties are delivered. Link threads append to the
+ * store before the batch reaches the ui, so new samples are copied from the store
+ * by count, samples already copied at setup are not added twice.
+ * Plot is redrawn once with the next frame.
+ *
+ * @code {.c++}
+ * PlottingWindow::deliver(const QVector<telemetrySample> &samples)
+ * @endcode
+ */
+void PlottingWindow::deliver(const QVector<telemetrySample> &samples)
+{
+  int lastProperty = NoProperty;
+  for (int i = 0; i < samples.size(); i++)
+  {
+    if (samples.at(i).property == lastProperty) // consecutive samples of the same property
+      continue;
+    lastProperty = samples.at(i).property;
 
-        //handling value
-        QStringList temp = targetModel->item(j, 5)->text().split("/");
+    int index = indexOfPropertyOnArray(lastProperty);
+    if (index >= 0)
+      copyNewSamples(index);
+  }
+  markGaps();
+  markAlarms();
+  if (statisticsBands)
+    updateStatisticsBands();
+  if (autoScale)
+    autoScaleValues();
+  ui->widgetCustomPlot->replot(QCustomPlot::rpQueuedReplot);
+}
 
-        //Create data struct and assign values
-        QCPGraphData tempTimeData;
-        tempTimeData.key = dateDouble;
-        tempTimeData.value = temp[0].toDouble();
+/**
+ * @brief Mark lost lines on the plot
+ *
+ * Gaps found by the links are shaded over the whole plot height when the link
+ * sends one of the plotted properties. Link of a property is found by the namespace of its name.
+ * Only gaps around the visible range are drawn, at most PlotMarkerLimit of them, newest first.
+ * Markers are drawn again when new gaps arrive or the visible range leaves the marked range.
+ *
+ * @code {.c++}
+ * PlottingWindow::markGaps()
+ * @endcode
+ */
+void PlottingWindow::markGaps()
+{
+  QCPRange range = ui->widgetCustomPlot->xAxis->range();
+  if (targetStore->gapCount() == drawnGaps && gapRange.contains(range.lower) && gapRange.contains(range.upper)) // nothing new -> no copy
+    return;
 
-        //push new data to plotting array
-        array[i]->timeData.push_back(tempTimeData);
-      }
-    }
+  for (int i = 0; i < gapItems.size(); i++)
+    ui->widgetCustomPlot->removeItem(gapItems[i]);
+  gapItems.clear();
 
-    //set data
-    ui->widgetCustomPlot->graph(i)->data()->set(array[i]->timeData);
+  QVector<telemetryGap> gaps = targetStore->gaps();
+  drawnGaps = gaps.size();
+  gapRange = QCPRange(range.lower - range.size(), range.upper + range.size()); // panning by a screen does not redraw
 
-    //replot
-    ui->widgetCustomPlot->replot();
+  QStringList prefixes; // namespaces of the plotted properties
+  for (int i = 0; i < array.size(); i++)
+  {
+    QString name = PropertyRegistry::instance().name(array[i]->property);
+    prefixes.append(name.contains(':') ? name.section(':', 0, 0) : QString());
+  }
+
+  int marked = 0;
+  for (int i = gaps.size() - 1; i >= 0 && marked < PlotMarkerLimit; i--)
+  {
+    if (!prefixes.contains(gaps[i].prefix) || gaps[i].toKey < gapRange.lower || gaps[i].fromKey > gapRange.upper)
+      continue;
+
+    QCPItemRect *marker = new QCPItemRect(ui->widgetCustomPlot);
+    marker->setSelectable(false);
+    marker->setPen(Qt::NoPen);
+    marker->setBrush(QColor(255, 0, 0, 40));
+    marker->topLeft->setTypeY(QCPItemPosition::ptAxisRectRatio); // whole plot height
+    marker->bottomRight->setTypeY(QCPItemPosition::ptAxisRectRatio);
+    marker->topLeft->setCoords(gaps[i].fromKey, 0);
+    marker->bottomRight->setCoords(gaps[i].toKey, 1);
+
+    QCPItemText *label = new QCPItemText(ui->widgetCustomPlot);
+    label->setSelectable(false);
+    label->setColor(Qt::red);
+    label->setText(QString::number(gaps[i].lost) + " lost");
+    label->setPositionAlignment(Qt::AlignHCenter | Qt::AlignTop);
+    label->position->setTypeY(QCPItemPosition::ptAxisRectRatio);
+    label->position->setCoords((gaps[i].fromKey + gaps[i].toKey) / 2, 0.02);
+
+    gapItems.append(marker);
+    gapItems.append(label);
+    marked++;
   }
-  prevIndex = targetModel->rowCount();
 }
 
+/**
+ * @brief Mark alarm state changes on the plot
+ *
+ * Changes raised by the alarm engine for the plotted properties are drawn as vertical
+ * lines with the color of the new level, green when the property is back to normal.
+ * Like the gap markers, only changes around the visible range are drawn, at most
+ * PlotMarkerLimit of them, newest first.
+ *
+ * @code {.c++}
+ * PlottingWindow::markAlarms()
+ * @endcode
+ */
+void PlottingWindow::markAlarms()
+{
+  QCPRange range = ui->widgetCustomPlot->xAxis->range();
+  if (targetStore->alarmCount() == drawnAlarms && alarmRange.contains(range.lower) && alarmRange.contains(range.upper)) // nothing new -> no copy
+    return;
+
+  for (int i = 0; i < alarmItems.size(); i++)
+    ui->widgetCustomPlot->removeItem(alarmItems[i]);
+  alarmItems.clear();
+
+  QVector<telemetryAlarm> alarms = targetStore->alarms();
+  drawnAlarms = alarms.size();
+  alarmRange = QCPRange(range.lower - range.size(), range.upper + range.size());
+
+  int marked = 0;
+  for (int i = alarms.size() - 1; i >= 0 && marked < PlotMarkerLimit; i--)
+  {
+    if (alarms[i].key < alarmRange.lower || alarms[i].key > alarmRange.upper || !checkPropertyExistOnArray(alarms[i].property))
+      continue;
+
+    QColor color = alarms[i].level == alarmNormal ? QColor(0, 150, 0) : AlarmEngine::levelColor(alarms[i].level);
+
+    QCPItemStraightLine *marker = new QCPItemStraightLine(ui->widgetCustomPlot);
+    marker->setSelectable(false);
+    marker->setPen(QPen(color, 1, Qt::DotLine));
+    marker->point1->setCoords(alarms[i].key, 0);
+    marker->point2->setCoords(alarms[i].key, 1);
+
+    QCPItemText *label = new QCPItemText(ui->widgetCustomPlot);
+    label->setSelectable(false);
+    label->setColor(color);
+    label->setText(PropertyRegistry::instance().name(alarms[i].property) + " " + alarms[i].reason);
+    label->setPositionAlignment(Qt::AlignLeft | Qt::AlignBottom);
+    label->position->setTypeY(QCPItemPosition::ptAxisRectRatio);
+    label->position->setCoords(alarms[i].key, 0.98);
+
+    alarmItems.append(marker);
+    alarmItems.append(label);
+    marked++;
+  }
+}
 
 /**
  * @brief Save button for graph.
  *
- * Saves the plot as an png format to desired location
+ * Saves the plot as png, pdf or jpg to desired location, format is selected by the file suffix.
+ * Graphs are min/max decimated to the output resolution first, see ExportDecimation.
+ * Batch reports of recorded sessions are rendered by ReportRenderer.
  *
  * @code {.c++}
  * PlottingWindow::on_pushButton_clicked()
@@ -298,8 +660,19 @@ void PlottingWindow::updatePlot()
  */
 void PlottingWindow::on_pushButton_clicked()
 {
-  QString saveFilePath = QFileDialog::getSaveFileName(this, "Select file path so save graph.");
-  ui->widgetCustomPlot->saveJpg(saveFilePath + ".jpg");
+  QString saveFilePath = QFileDialog::getSaveFileName(this, "Select file path so save graph.", QString(), "PNG Image (*.png);;PDF Document (*.pdf);;JPG Image (*.jpg)");
+  if (saveFilePath.isEmpty())
+    return;
+
+  bool pdf = saveFilePath.endsWith(".pdf", Qt::CaseInsensitive);
+  ExportDecimation decimation(ui->widgetCustomPlot, pdf ? ExportDpi / 72.0 : 1.0); // only samples visible at the output resolution are written
+
+  if (pdf)
+    ui->widgetCustomPlot->savePdf(saveFilePath);
+  else if (saveFilePath.endsWith(".png", Qt::CaseInsensitive))
+    ui->widgetCustomPlot->savePng(saveFilePath);
+  else
+    ui->widgetCustomPlot->saveJpg(saveFilePath.endsWith(".jpg", Qt::CaseInsensitive) ? saveFilePath : saveFilePath + ".jpg");
 }
 
 /**
@@ -312,25 +685,139 @@ void PlottingWindow::on_pushButton_clicked()
  */
 void PlottingWindow::on_FitScreen_pushButton_clicked()
 {
-  // Getting the pointer to the graph
+  if (ui->widgetCustomPlot->graphCount() == 0)
+    return;
+
+  // Getting the pointer to the graph -> selected one or the first one
+  QCPGraph *ptr = ui->widgetCustomPlot->graph(0);
   if (ui->widgetCustomPlot->selectedGraphs().size() > 0)
-  {
-    QCPGraph *ptr = nullptr; // ptr to graph
     ptr = ui->widgetCustomPlot->selectedGraphs().first();
-    // ptr = ui->widgetCustomPlot->graph(0); //get the first selected graph
 
-    ui->widgetCustomPlot->xAxis->setRange(ptr->data()->at(0)->key - 1, ptr->data()->at(ptr->dataCount() - 1)->key + 1);
-    // ui->widgetCustomPlot->xAxis->setRange(array[0]->timeData[0].key - 1, array[0]->timeData[array[0]->timeData.size() - 1].key + 1);
+  if (!archiveSource.isNull()) // recorded session -> range from the source index, samples are loaded afterwards
+  {
+    int index = 0;
+    while (index < array.size() && ui->widgetCustomPlot->graph(index) != ptr)
+      index++;
+    if (index == array.size())
+      return;
+
+    QCPRange range = archiveSource->keyRange(PropertyRegistry::instance().name(array[index]->property));
+    ui->widgetCustomPlot->xAxis->setRange(range.lower - 1, range.upper + 1);
+    loadVisibleRange();
+
+    bool found = false; // loaded samples are limited by the plot width
+    QCPRange values = ptr->data()->valueRange(found);
+    if (found)
+      fitValueAxis(values.lower, values.upper);
     ui->widgetCustomPlot->replot();
+    return;
   }
-  else
+
+  if (ptr->dataCount() == 0) // nothing received yet
+    return;
+
+  int index = 0;
+  while (index < array.size() && ui->widgetCustomPlot->graph(index) != ptr)
+    index++;
+
+  ui->widgetCustomPlot->xAxis->setRange(ptr->data()->at(0)->key - 1, ptr->data()->at(ptr->dataCount() - 1)->key + 1);
+  if (index < array.size()) // bounds kept while copying
+    fitValueAxis(array[index]->minValue, array[index]->maxValue);
+  ui->widgetCustomPlot->replot();
+}
+
+/**
+ * @brief Set value axis range
+ *
+ * A small margin is added so the extremes are not drawn on the axis lines.
+ * @code {.c++}
+ * PlottingWindow::fitValueAxis(double minValue, double maxValue)
+ * @endcode
+ */
+void PlottingWindow::fitValueAxis(double minValue, double maxValue)
+{
+  double margin = (maxValue - minValue) * ValueMargin;
+  if (margin <= 0) // constant value
+    margin = qMax(1.0, qAbs(minValue) * ValueMargin);
+  ui->widgetCustomPlot->yAxis->setRange(minValue - margin, maxValue + margin);
+}
+
+/**
+ * @brief Fit value axis to the visible samples
+ *
+ * Live data -> bounds of the visible range are taken from the chunk summaries of the store,
+ * only the chunks at the ends of the range are scanned.
+ * Recorded session -> loaded samples are already limited by the plot width.
+ * @code {.c++}
+ * PlottingWindow::autoScaleValues()
+ * @endcode
+ */
+void PlottingWindow::autoScaleValues()
+{
+  QCPRange visible = ui->widgetCustomPlot->xAxis->range();
+  bool found = false;
+  double minValue = 0;
+  double maxValue = 0;
+
+  for (int i = 0; i < array.size() && i < ui->widgetCustomPlot->graphCount(); i++)
+  {
+    double low = 0;
+    double high = 0;
+    if (targetStore != nullptr)
+    {
+      if (!targetStore->valueRange(array[i]->property, visible.lower, visible.upper, &low, &high))
+        continue;
+    }
+    else
+    {
+      bool inGraph = false;
+      QCPRange range = ui->widgetCustomPlot->graph(i)->data()->valueRange(inGraph, QCP::sdBoth, visible);
+      if (!inGraph)
+        continue;
+      low = range.lower;
+      high = range.upper;
+    }
+
+    minValue = found ? qMin(minValue, low) : low;
+    maxValue = found ? qMax(maxValue, high) : high;
+    found = true;
+  }
+
+  if (found)
+    fitValueAxis(minValue, maxValue);
+}
+
+/**
+ * @brief Auto scale toggled
+ *
+ * @code {.c++}
+ * PlottingWindow::setAutoScale(bool state)
+ * @endcode
+ */
+void PlottingWindow::setAutoScale(bool state)
+{
+  autoScale = state;
+  if (autoScale)
   {
-    qDebug() << "-> \"on_FitScreen_pushButton_clicked()\" not in selected graph mode." << endl;
-    ui->widgetCustomPlot->xAxis->setRange(array[0]->timeData[0].key - 1, array[0]->timeData[array[0]->timeData.size() - 1].key + 1);
+    autoScaleValues();
     ui->widgetCustomPlot->replot();
   }
 }
 
+/**
+ * @brief Statistics bands toggled
+ *
+ * @code {.c++}
+ * PlottingWindow::setStatisticsBands(bool state)
+ * @endcode
+ */
+void PlottingWindow::setStatisticsBands(bool state)
+{
+  statisticsBands = state;
+  updateStatisticsBands();
+  ui->widgetCustomPlot->replot();
+}
+
 //  -----------      ----------------                Internal Methods                     ----------------              ---------------- //
 //
 
@@ -341,14 +828,14 @@ void PlottingWindow::on_FitScreen_pushButton_clicked()
  * True -> if exists
  * False -> if not exists
  * @code {.c++}
- * PlottingWindow::checkPropertyExistOnArray(QString property)
+ * PlottingWindow::checkPropertyExistOnArray(int property)
  * @endcode
  */
-bool PlottingWindow::checkPropertyExistOnArray(QString property)
+bool PlottingWindow::checkPropertyExistOnArray(int property)
 {
   for (int i = 0; i < array.size(); i++) // iterate over array
   {
-    if (property == array[i]->name) // if equals to current
+    if (property == array[i]->property) // if equals to current
     {
       return true;
     }
@@ -362,14 +849,14 @@ bool PlottingWindow::checkPropertyExistOnArray(QString property)
  * Returns the index of property on array as a integer.
  * Returns -1 if not exists.
  * @code {.c++}
- * PlottingWindow::indexOfPropertyOnArray(QString property)
+ * PlottingWindow::indexOfPropertyOnArray(int property)
  * @endcode
  */
-int PlottingWindow::indexOfPropertyOnArray(QString property)
+int PlottingWindow::indexOfPropertyOnArray(int property)
 {
   for (int i = 0; i < array.size(); i++) // iterate over array
   {
-    if (array[i]->name == property) // if equals to current
+    if (array[i]->property == property) // if equals to current
     {
       return i;
     }
@@ -422,6 +909,17 @@ void PlottingWindow::contextMenuRequest(QPoint pos)
     // if graph selected -> also add fit graph selection
     if (ui->widgetCustomPlot->selectedGraphs().size() > 0)
       menu->addAction("Fit Graph", this, SLOT(on_FitScreen_pushButton_clicked()));
+
+    QAction *autoScaleAction = menu->addAction("Auto Scale", this, SLOT(setAutoScale(bool)));
+    autoScaleAction->setCheckable(true);
+    autoScaleAction->setChecked(autoScale);
+
+    if (targetStatistics != nullptr) // statistics are kept for live data only
+    {
+      QAction *bandsAction = menu->addAction("Statistics Bands", this, SLOT(setStatisticsBands(bool)));
+      bandsAction->setCheckable(true);
+      bandsAction->setChecked(statisticsBands);
+    }
   }
 
   menu->popup(ui->widgetCustomPlot->mapToGlobal(pos)); // Show context menu to user
@@ -540,7 +1038,8 @@ void PlottingWindow::moveLegend()
 void PlottingWindow::setupProperties_ListView()
 {
   // creating temp item for first property
-  QStandardItem *tempProperty = new QStandardItem(targetName);
+  QStandardItem *tempProperty = new QStandardItem(PropertyRegistry::instance().name(targetProperty));
+  tempProperty->setData(targetProperty, Qt::UserRole);
 
   // setup properties of the list view table
   tempProperty->setCheckable(true);         // adding check boxes property
@@ -551,18 +1050,7 @@ void PlottingWindow::setupProperties_ListView()
   propertiesListModel->appendRow(tempProperty);
   ui->properties_listView->setModel(propertiesListModel);
 
-  for (int i = 0; i < targetModelProperties->rowCount(); i++) // for each element in the target models properties list
-  {
-    if (!checkPropertyExistOnListView(targetModelProperties->item(i, 0)->text())) // check if its exists
-    {
-      QStandardItem *tempProperty = new QStandardItem(targetModelProperties->item(i, 0)->text()); // create new item for property
-
-      // setup properties the created item & append to the list view model
-      tempProperty->setCheckable(true);
-      tempProperty->setCheckState(Qt::Unchecked);
-      propertiesListModel->appendRow(tempProperty);
-    }
-  }
+  updateProperties_ListView(); // add remaining properties unchecked
 }
 
 /**
@@ -581,19 +1069,37 @@ void PlottingWindow::on_refreshProperties_pushButton_clicked()
 /**
  * @brief update function for properties list view
  *
- * Updated the existing properties list view for new data in target model. Iterates from where setup function left and
- * adds the new properties if they don't already exists.
+ * Updated the existing properties list view for new data in target model or recorded session.
+ * Adds the new properties if they don't already exists.
  * @code {.c++}
  * PlottingWindow::updateProperties_ListView()
  * @endcode
  */
 void PlottingWindow::updateProperties_ListView()
 {
-  for (int i = 0; i < targetModelProperties->rowCount(); i++) // iterate over target models properties list
+  QVector<int> available; // properties of the target model or recorded session
+  if (!archiveSource.isNull())
   {
-    if (!checkPropertyExistOnListView(targetModelProperties->item(i, 0)->text())) // check if its exists
+    QStringList names = archiveSource->properties();
+    for (int i = 0; i < names.size(); i++)
+      available.append(PropertyRegistry::instance().intern(names[i]));
+  }
+  else
+  {
+    for (int i = 0; i < targetModelProperties->rowCount(); i++)
     {
-      QStandardItem *tempProperty = new QStandardItem(targetModelProperties->item(i, 0)->text()); // create new item for property
+      QVariant id = targetModelProperties->item(i, 0)->data(Qt::UserRole); // header row has no id
+      if (id.isValid())
+        available.append(id.toInt());
+    }
+  }
+
+  for (int i = 0; i < available.size(); i++) // iterate over available properties
+  {
+    if (!checkPropertyExistOnListView(available[i])) // check if its exists
+    {
+      QStandardItem *tempProperty = new QStandardItem(PropertyRegistry::instance().name(available[i])); // create new item for property
+      tempProperty->setData(available[i], Qt::UserRole);
 
       // setup properties the created item & append to the list view model
       tempProperty->setCheckable(true);
@@ -611,11 +1117,11 @@ void PlottingWindow::updateProperties_ListView()
  * PlottingWindow::on_FitScreen_pushButton_clicked()
  * @endcode
  */
-bool PlottingWindow::checkPropertyExistOnListView(QString property)
+bool PlottingWindow::checkPropertyExistOnListView(int property)
 {
   for (int i = 0; i < propertiesListModel->rowCount(); i++) // Iterate over properties
   {
-    if ((propertiesListModel->item(i, 0)->text() == property) || (property == "<Property Name>")) // If matches
+    if (propertiesListModel->item(i, 0)->data(Qt::UserRole).toInt() == property) // If matches
       return true;
   }
   return false;
@@ -636,17 +1142,70 @@ void PlottingWindow::on_properties_listView_clicked(const QModelIndex &index)
   bool changed = false;                                     // state false at beginning
   for (int i = 0; i < propertiesListModel->rowCount(); i++) // Iterate over properties list
   {
-    if (propertiesListModel->item(i, 0)->checkState() == Qt::Checked && !checkPropertyExistOnArray(propertiesListModel->item(i, 0)->text())) // If item Checked
+    int property = propertiesListModel->item(i, 0)->data(Qt::UserRole).toInt();
+    if (propertiesListModel->item(i, 0)->checkState() == Qt::Checked && !checkPropertyExistOnArray(property)) // If item Checked
     {
-      array.push_back(new dataStruct(propertiesListModel->item(i, 0)->text())); // add properties to be plotted array
-      changed = true;                                                           // mark that state changed
+      array.push_back(new dataStruct(property)); // add properties to be plotted array
+      changed = true;                            // mark that state changed
     }
-    else if (propertiesListModel->item(i, 0)->checkState() != Qt::Checked && checkPropertyExistOnArray(propertiesListModel->item(i, 0)->text())) // If item Unchecked
+    else if (propertiesListModel->item(i, 0)->checkState() != Qt::Checked && checkPropertyExistOnArray(property)) // If item Unchecked
     {
-      changed = true;                                                                  // mark state changed
-      array.removeAt(indexOfPropertyOnArray(propertiesListModel->item(i, 0)->text())); // remove selected item from to be plotted array
+      changed = true;                                            // mark state changed
+      int index = indexOfPropertyOnArray(property);
+      delete array[index];
+      array.removeAt(index); // remove selected item from to be plotted array
     }
   }
   if (changed)   // if new elementd added
     setupPlot(); // setup again
 }
+
+//  -----------      ----------------                Recorded Session Functions                     ----------------              ---------------- //
+//
+
+/**
+ * @brief Time axis range changed
+ *
+ * Called on every drag or zoom step. Live markers are checked against the new range,
+ * recorded sessions are loaded delayed a little so it happens once for a series of changes.
+ * @code {.c++}
+ * PlottingWindow::onRangeChanged(const QCPRange &range)
+ * @endcode
+ */
+void PlottingWindow::onRangeChanged(const QCPRange &range)
+{
+  Q_UNUSED(range);
+  if (targetStore != nullptr) // markers follow the visible range
+  {
+    markGaps();
+    markAlarms();
+  }
+  rangeTimer->start();
+}
+
+/**
+ * @brief Load visible samples
+ *
+ * Loads the visible range of each plotted property from the recorded session.
+ * Amount of samples is limited to two per horizontal pixel, so loading time
+ * depends on the window size and not on the session size.
+ * @code {.c++}
+ * PlottingWindow::loadVisibleRange()
+ * @endcode
+ */
+void PlottingWindow::loadVisibleRange()
+{
+  if (archiveSource.isNull())
+    return;
+
+  QCPRange range = ui->widgetCustomPlot->xAxis->range();
+  int maxPoints = 2 * qMax(100, ui->widgetCustomPlot->axisRect()->width());
+
+  for (int i = 0; i < array.size() && i < ui->widgetCustomPlot->graphCount(); i++) // for each plotted property
+  {
+    ui->widgetCustomPlot->graph(i)->data()->set(archiveSource->loadRange(PropertyRegistry::instance().name(array[i]->property), range.lower, range.upper, maxPoints), true);
+  }
+  if (autoScale)
+    autoScaleValues();
+  ui->widgetCustomPlot->replot();
+}
@@ -9,6 +9,15 @@
 #include "qcustomplot.h"
 #include <QInputDialog>
 #include <QAction>
+#include <QSharedPointer>
+#include <QTimer>
+#include "samplesource.h"
+#include "telemetrystore.h"
+#include "telemetrybus.h"
+#include "telemetrystatistics.h"
+#include "alarmengine.h"
+#include "propertyregistry.h"
+#include "timeaxisticker.h"
 
 // ->  data structure for the plot
 struct dataStruct
@@ -16,13 +25,12 @@ struct dataStruct
 
 public:
     dataStruct() {}
-    dataStruct(QString nm) : name(nm) {}
+    dataStruct(int id) : property(id) {}
 
-    QString name;
-    QVector<QString> dates;
-    QVector<double> x;
-    QVector<double> y;
-    QVector<QCPGraphData> timeData;
+    int property = NoProperty; // property registry id, name is only used for the legend
+    int copied = 0;            // samples already copied from the telemetry store to the graph
+    double minValue = 0;       // bounds of the copied samples, updated while copying
+    double maxValue = 0;
 };
 //
 //
@@ -31,31 +39,42 @@ namespace Ui
     class PlottingWindow;
 }
 
-class PlottingWindow : public QWidget
+class PlottingWindow : public QWidget, public TelemetrySubscriber
 {
     Q_OBJECT
 
 public:
     explicit PlottingWindow(QWidget *parent = nullptr);
-    PlottingWindow(QStandardItemModel *target, QStandardItemModel *mainProperties, QString name, QWidget *parent = nullptr);
+    PlottingWindow(TelemetryStore *store, TelemetryBus *bus, TelemetryStatistics *statistics, QStandardItemModel *mainProperties, int property, QWidget *parent = nullptr);
+    PlottingWindow(QSharedPointer<SampleSource> source, int property, QWidget *parent = nullptr); // plotting recorded session
     ~PlottingWindow();
 
     void setup();
     void setupPlot();
     void setupSettings();
+    void setupInteractions();
 
     // ***  Properties list View Functions  *** //
     void setupProperties_ListView();                     // checks the target model and adds property to the list view
     void updateProperties_ListView();                    // updated the available properties and adds to the list view
-    bool checkPropertyExistOnListView(QString property); // check property already exists on the list view
+    bool checkPropertyExistOnListView(int property);     // check property already exists on the list view
 
     // *** Properties array *** //
     // -> array used for LUT table for plotting function
     // -> if item exists in the array plotter will plot it
-    bool checkPropertyExistOnArray(QString property); // Checks if property exists in the aray
-    int indexOfPropertyOnArray(QString property);     //-> returns the index of element in the array
+    bool checkPropertyExistOnArray(int property); // Checks if property exists in the aray
+    int indexOfPropertyOnArray(int property);     //-> returns the index of element in the array
     // Continious data adding
-    void updatePlot();
+    void copyNewSamples(int index);                                  // appends samples received since last copy to the graph
+    void deliver(const QVector<telemetrySample> &samples) override; // new samples of the plotted properties
+    void markGaps();                                                 // shades lost lines of the plotted links around the visible range
+    void markAlarms();                                               // marks alarm state changes of the plotted properties around the visible range
+    void fitValueAxis(double minValue, double maxValue);             // value axis with a small margin
+    void autoScaleValues();                                          // value axis follows the visible samples
+    void setupCrosshair();                                           // creates crosshair items for the current graphs
+    void setupStatisticsBands();                                     // creates band items for the current graphs
+    void updateStatisticsBands();                                    // moves bands to the statistics of the last window
+    static bool nearestSample(QCPGraph *graph, double key, QCPGraphData *sample); // binary search on the sorted keys
 
     void setupContexMenu(QMenu *menu);
 private slots:
@@ -73,20 +92,48 @@ private slots:
     void mouseMove(QMouseEvent *event);
 
     void on_FitScreen_pushButton_clicked();
+    void setAutoScale(bool state);
+    void setStatisticsBands(bool state);
 
     void on_refreshProperties_pushButton_clicked();
 
+    //  *** Recorded Session Functions  ***   //
+    void onRangeChanged(const QCPRange &range); // schedules loading of the visible range
+    void loadVisibleRange();                    // loads only the visible samples from the source
+
 private:
     Ui::PlottingWindow *ui;
 
     QStandardItemModel *propertiesListModel; // properties model for the list view for all available properties
-    QStandardItemModel *targetModel;         //  main item model -> received at setup
-    QStandardItemModel *targetModelProperties;
+    TelemetryStore *targetStore = nullptr;     //  live samples of the session -> received at setup
+    TelemetryBus *targetBus = nullptr;         //  new samples of the plotted properties
+    TelemetryStatistics *targetStatistics = nullptr; // statistics of the live properties, shown as bands
+    QStandardItemModel *targetModelProperties = nullptr;
 
-    QVector<dataStruct *> array;
-    int prevIndex = 0; // to store where program left when iterating over the main target model
+    QSharedPointer<SampleSource> archiveSource; // recorded session -> set when not plotting live data
+    QTimer *rangeTimer = nullptr;               //-> delays loading while user drags or zooms
 
-    QString targetName;
+    QVector<dataStruct *> array;
+    int drawnGaps = -1; // gaps of the store already checked, -1 -> markers are drawn again
+    QCPRange gapRange;  // key range covered by the gap markers
+    QVector<QCPAbstractItem *> gapItems; // gap markers and labels
+    int drawnAlarms = -1; // alarm changes of the store already checked, -1 -> markers are drawn again
+    QCPRange alarmRange;  // key range covered by the alarm markers
+    QVector<QCPAbstractItem *> alarmItems; // alarm markers and labels
+    bool autoScale = false; // value axis follows the visible samples
+
+    // *** Crosshair -> drawn on the buffered overlay layer, graphs are not redrawn while hovering *** //
+    QCPItemStraightLine *crosshairLine = nullptr;
+    QCPItemText *crosshairText = nullptr;
+    QVector<QCPItemTracer *> crosshairTracers; // one per graph
+
+    // *** Statistics bands -> window min..max and mean +- stddev over the time the window covers *** //
+    bool statisticsBands = false;
+    QVector<QCPItemRect *> rangeBands;     // one per graph
+    QVector<QCPItemRect *> deviationBands; // one per graph
+    QVector<QCPItemLine *> meanLines;      // one per graph
+
+    int targetProperty = NoProperty;
     int verticalMax = 300;
     int verticalMin = 100;
 
@@ -0,0 +1,229 @@
+#include "procedurerunner.h"
+
+#include <QAtomicInt>
+
+// ---- Definitions ---- //
+
+#define RunTagShift 20 ///< Tags of a run are runTag + step, runs are 2^20 tags apart
+
+static QAtomicInt runCounter; ///< Number of runs created, gives each run its own tags
+
+//  -----------      ----------------                Constructor Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Constructor
+ *
+ * Created on the ui thread and moved to the runner thread.
+ *
+ * @code {.c++}
+ * ProcedureRunner::ProcedureRunner(const QVector<procedureStep> &steps, procedureMode mode)
+ * @endcode
+ */
+ProcedureRunner::ProcedureRunner(const QVector<procedureStep> &steps, procedureMode mode) : procedure(steps), runMode(mode)
+{
+    runTag = (runCounter.fetchAndAddRelaxed(1) % 1024 + 1) << RunTagShift;
+}
+
+/**
+ * @brief Most steps of a single run
+ *
+ * @code {.c++}
+ * ProcedureRunner::stepLimit()
+ * @endcode
+ */
+int ProcedureRunner::stepLimit()
+{
+    return 1 << RunTagShift;
+}
+
+/**
+ * @brief First tag of this run
+ *
+ * @code {.c++}
+ * ProcedureRunner::tagBase()
+ * @endcode
+ */
+int ProcedureRunner::tagBase() const
+{
+    return runTag;
+}
+
+/**
+ * @brief Steps of a command tree
+ *
+ * Model is created by readCommandsFromFile, groups are run in file order.
+ * Command item of each step is added to items when given.
+ *
+ * @code {.c++}
+ * ProcedureRunner::stepsFromModel(QStandardItemModel *model, QVector<QStandardItem *> *items)
+ * @endcode
+ */
+QVector<procedureStep> ProcedureRunner::stepsFromModel(QStandardItemModel *model, QVector<QStandardItem *> *items)
+{
+    QVector<procedureStep> steps;
+    for (int group = 0; group < model->rowCount(); group++)
+    {
+        QStandardItem *groupItem = model->item(group, 0);
+        for (int row = 0; row < groupItem->rowCount(); row++)
+        {
+            procedureStep step;
+            step.group = groupItem->text();
+            step.command = groupItem->child(row, 0)->text();
+            step.description = groupItem->child(row, 1) != nullptr ? groupItem->child(row, 1)->text() : QString();
+
+            QString schedule = groupItem->child(row, 2) != nullptr ? groupItem->child(row, 2)->text() : QString();
+            bool ok = false;
+            double at = schedule.mid(1).toDouble(&ok); // "@<seconds>"
+            if (schedule.startsWith('@') && ok && at >= 0)
+                step.at = at;
+
+            if (step.command.isEmpty())
+                continue;
+
+            steps.append(step);
+            if (items != nullptr)
+                items->append(groupItem->child(row, 0));
+        }
+    }
+    return steps;
+}
+
+//  -----------      ----------------                Run Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Start the procedure
+ *
+ * Back to back -> every command is queued at once.
+ * Sequential -> first command is sent, the others follow their previous ack.
+ * Scheduled -> commands are sent by the schedule timer, steps without time follow the previous one.
+ *
+ * @code {.c++}
+ * ProcedureRunner::run()
+ * @endcode
+ */
+void ProcedureRunner::run()
+{
+    clock.start();
+
+    if (runMode == procedureBackToBack)
+    {
+        while (nextStep < procedure.size())
+            send(nextStep++);
+        checkFinished();
+        return;
+    }
+
+    if (runMode == procedureSequential)
+    {
+        if (nextStep < procedure.size())
+            send(nextStep++);
+        checkFinished();
+        return;
+    }
+
+    scheduleTimer = new QTimer(this);
+    scheduleTimer->setSingleShot(true);
+    scheduleTimer->setTimerType(Qt::PreciseTimer);
+    connect(scheduleTimer, SIGNAL(timeout()), this, SLOT(sendDue()));
+    sendDue();
+}
+
+/**
+ * @brief Send steps whose time has come
+ *
+ * Timer is started again for the remaining time of the next step.
+ *
+ * @code {.c++}
+ * ProcedureRunner::sendDue()
+ * @endcode
+ */
+void ProcedureRunner::sendDue()
+{
+    if (cancelled)
+        return;
+
+    double elapsed = clock.nsecsElapsed() / 1e9;
+    while (nextStep < procedure.size() && procedure[nextStep].at <= elapsed)
+        send(nextStep++);
+
+    if (nextStep < procedure.size())
+    {
+        int wait = (int)((procedure[nextStep].at - elapsed) * 1000);
+        scheduleTimer->start(qMax(0, wait));
+    }
+    checkFinished();
+}
+
+/**
+ * @brief Send single step
+ *
+ * @code {.c++}
+ * ProcedureRunner::send(int step)
+ * @endcode
+ */
+void ProcedureRunner::send(int step)
+{
+    emit sendRequested(procedure[step].command.trimmed().toUtf8() + " \n", runTag + step);
+    emit stepSent(step, clock.nsecsElapsed() / 1e9);
+}
+
+/**
+ * @brief Stop the procedure
+ *
+ * @code {.c++}
+ * ProcedureRunner::cancel()
+ * @endcode
+ */
+void ProcedureRunner::cancel()
+{
+    if (cancelled || reported)
+        return;
+
+    cancelled = true;
+    if (scheduleTimer != nullptr)
+        scheduleTimer->stop();
+
+    procedure.resize(nextStep); // unsent steps are dropped
+    checkFinished();
+}
+
+/**
+ * @brief Result of a command
+ *
+ * @code {.c++}
+ * ProcedureRunner::onCommandFinished(commandResult result)
+ * @endcode
+ */
+void ProcedureRunner::onCommandFinished(commandResult result)
+{
+    int step = result.tag - runTag;
+    if (step < 0 || step >= nextStep || result.stale) // not a command of this run, or late ack of a reported step
+        return;
+
+    finishedSteps++;
+    if (!result.ok)
+        failedSteps++;
+    emit stepFinished(step, result);
+
+    if (runMode == procedureSequential && !cancelled && nextStep < procedure.size())
+        send(nextStep++);
+    checkFinished();
+}
+
+/**
+ * @brief Report the end of the run
+ *
+ * Run is over when every step is sent and every sent step has its result.
+ *
+ * @code {.c++}
+ * ProcedureRunner::checkFinished()
+ * @endcode
+ */
+void ProcedureRunner::checkFinished()
+{
+    if (reported || nextStep < procedure.size() || finishedSteps < nextStep)
+        return;
+
+    reported = true;
+    emit finished(finishedSteps - failedSteps, failedSteps, clock.nsecsElapsed() / 1e9);
+}
@@ -0,0 +1,83 @@
+#ifndef PROCEDURERUNNER_H
+#define PROCEDURERUNNER_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QStandardItemModel>
+#include "commandchannel.h"
+
+// -> single command of a procedure
+struct procedureStep
+{
+public:
+    QString group;       // group of the command in the procedure file
+    QString command;     // command sent to the server
+    QString description;
+    double at = -1;      // seconds after the procedure start, -1 -> right after the previous step
+};
+
+// ---- Run modes of a procedure ---- //
+enum procedureMode
+{
+    procedureBackToBack = 0, // every command queued at once, pipelined by the command channel
+    procedureSequential = 1, // next command is sent after the ack of the previous one, for latency measurements
+    procedureScheduled = 2   // commands sent at their scheduled times
+};
+
+QStandardItemModel *readCommandsFromFile(QString &fileName); // procedure file -> command tree model, treeviewcommands.cpp
+
+/*
+ * Runs the commands of a procedure on its own thread.
+ *
+ * Back to back runs queue every command at once, the command channel of the link
+ * pipelines them and matches the acks. Sequential runs keep a single command in flight,
+ * so latency of a command does not include the commands before it. Scheduled runs send
+ * each command at its time with a precise timer. Result and latency of each command is reported.
+ * Runner only talks to the link through queued signals, so a closed link only stops the results.
+ */
+class ProcedureRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    ProcedureRunner(const QVector<procedureStep> &steps, procedureMode mode);
+
+    static QVector<procedureStep> stepsFromModel(QStandardItemModel *model, QVector<QStandardItem *> *items = nullptr); // steps of the command tree in file order
+    static int stepLimit();                                                  // steps of a single run
+    int tagBase() const;                                                     // tags of this run start here
+
+public slots:
+    void run();                                 // starts sending
+    void cancel();                              // stops sending, commands already queued on the link are not recalled
+    void onCommandFinished(commandResult result); // results of the link, other tags are ignored
+
+signals:
+    void sendRequested(QByteArray command, int tag); // connected to the link
+    void stepSent(int step, double elapsed);          // seconds after start
+    void stepFinished(int step, commandResult result);
+    void finished(int succeeded, int failed, double elapsed);
+
+private slots:
+    void sendDue(); // sends every step whose time has come
+
+private:
+    void send(int step);
+    void checkFinished();
+
+    QVector<procedureStep> procedure;
+    procedureMode runMode;
+    int runTag;          // first tag of this run
+    int nextStep = 0;    // first step not sent yet
+    int finishedSteps = 0;
+    int failedSteps = 0;
+    bool cancelled = false;
+    bool reported = false; // finished is emitted once
+
+    QTimer *scheduleTimer = nullptr; // created on the runner thread
+    QElapsedTimer clock;
+};
+
+#endif // PROCEDURERUNNER_H
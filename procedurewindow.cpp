@@ -0,0 +1,347 @@
+#include "procedurewindow.h"
+#include "ui_procedurewindow.h"
+
+#include <QFileDialog>
+#include <QFile>
+#include <QTextStream>
+#include <QMessageBox>
+#include <algorithm>
+
+// ---- Definitions ---- //
+
+#define CommandColumn 0  ///< Columns of the procedure model, first three are read from the file
+#define ScheduleColumn 2
+#define StatusColumn 3
+#define LatencyColumn 4
+#define ResponseColumn 5
+
+//  -----------      ----------------                Constructor Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Constructor
+ *
+ * @code {.c++}
+ * ProcedureWindow::ProcedureWindow(TelemetryLink *link, QWidget *parent)
+ * @endcode
+ */
+ProcedureWindow::ProcedureWindow(TelemetryLink *link, QWidget *parent) : QWidget(parent), ui(new Ui::ProcedureWindow), targetLink(link)
+{
+    ui->setupUi(this);
+    setAttribute(Qt::WA_DeleteOnClose);
+    setWindowTitle("Procedure - " + link->description());
+
+    ui->Steps_treeView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    setRunning(false);
+    ui->Run_pushButton->setEnabled(false);
+    ui->Save_pushButton->setEnabled(false);
+}
+
+/**
+ * @brief Destructor
+ *
+ * @code {.c++}
+ * ProcedureWindow::~ProcedureWindow()
+ * @endcode
+ */
+ProcedureWindow::~ProcedureWindow()
+{
+    stopRunner();
+    delete procedureModel;
+    delete ui;
+}
+
+//  -----------      ----------------                Procedure Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Load procedure file
+ *
+ * @code {.c++}
+ * ProcedureWindow::loadProcedure(QString fileName)
+ * @endcode
+ */
+void ProcedureWindow::loadProcedure(QString fileName)
+{
+    QStandardItemModel *model = readCommandsFromFile(fileName);
+    stepItems.clear();
+    QVector<procedureStep> steps = ProcedureRunner::stepsFromModel(model, &stepItems);
+    if (steps.isEmpty())
+    {
+        delete model;
+        stepItems.clear();
+        QMessageBox::warning(this, "Procedure", "No commands found in " + fileName);
+        return;
+    }
+
+    model->setHorizontalHeaderLabels({"Command", "Description", "Schedule", "Status", "Latency (ms)", "Response"});
+    ui->Steps_treeView->setModel(model);
+    ui->Steps_treeView->expandAll();
+    ui->Steps_treeView->resizeColumnToContents(CommandColumn);
+
+    delete procedureModel; // view uses the new model already
+    procedureModel = model;
+
+    ui->Status_label->setText(QString::number(steps.size()) + " commands loaded");
+    ui->Run_pushButton->setEnabled(true);
+    ui->Save_pushButton->setEnabled(false);
+}
+
+/**
+ * @brief Stop runner thread
+ *
+ * @code {.c++}
+ * ProcedureWindow::stopRunner()
+ * @endcode
+ */
+void ProcedureWindow::stopRunner()
+{
+    if (runner == nullptr)
+        return;
+
+    runnerThread.quit();
+    runnerThread.wait();
+    delete runner;
+    runner = nullptr;
+}
+
+/**
+ * @brief Enable buttons of the running state
+ *
+ * @code {.c++}
+ * ProcedureWindow::setRunning(bool state)
+ * @endcode
+ */
+void ProcedureWindow::setRunning(bool state)
+{
+    ui->Load_pushButton->setEnabled(!state);
+    ui->Run_pushButton->setEnabled(!state && procedureModel != nullptr);
+    ui->Stop_pushButton->setEnabled(state);
+    ui->Mode_comboBox->setEnabled(!state);
+    ui->Repeat_spinBox->setEnabled(!state && ui->Mode_comboBox->currentIndex() != procedureScheduled);
+    ui->Save_pushButton->setEnabled(!state && procedureModel != nullptr);
+}
+
+/**
+ * @brief Step was sent
+ *
+ * @code {.c++}
+ * ProcedureWindow::onStepSent(int step, double elapsed)
+ * @endcode
+ */
+void ProcedureWindow::onStepSent(int step, double elapsed)
+{
+    QStandardItem *item = stepItems[step % stepItems.size()];
+    item->parent()->child(item->row(), StatusColumn)->setText("sent at " + QString::number(elapsed, 'f', 3) + " s");
+    ui->Steps_treeView->scrollTo(item->index());
+}
+
+/**
+ * @brief Step finished
+ *
+ * @code {.c++}
+ * ProcedureWindow::onStepFinished(int step, commandResult result)
+ * @endcode
+ */
+void ProcedureWindow::onStepFinished(int step, commandResult result)
+{
+    if (result.ok)
+        latencies.append(result.latency);
+
+    QStandardItem *item = stepItems[step % stepItems.size()];
+    QStandardItem *parent = item->parent();
+
+    parent->child(item->row(), StatusColumn)->setText(result.ok ? "ok" : "failed after " + QString::number(result.attempts) + " attempts");
+    parent->child(item->row(), StatusColumn)->setForeground(QColor(result.ok ? "darkGreen" : "red"));
+    parent->child(item->row(), LatencyColumn)->setText(result.ok ? QString::number(result.latency, 'f', 2) : QString());
+    parent->child(item->row(), ResponseColumn)->setText(result.response);
+}
+
+/**
+ * @brief Procedure finished
+ *
+ * @code {.c++}
+ * ProcedureWindow::onFinished(int succeeded, int failed, double elapsed)
+ * @endcode
+ */
+void ProcedureWindow::onFinished(int succeeded, int failed, double elapsed)
+{
+    stopRunner();
+    setRunning(false);
+    ui->Status_label->setText(QString::number(succeeded) + " succeeded, " + QString::number(failed) + " failed in " + QString::number(elapsed, 'f', 3) + " s" + latencySummary());
+}
+
+/**
+ * @brief Latency statistics
+ *
+ * @code {.c++}
+ * ProcedureWindow::latencySummary()
+ * @endcode
+ */
+QString ProcedureWindow::latencySummary()
+{
+    if (latencies.isEmpty())
+        return QString();
+
+    std::sort(latencies.begin(), latencies.end());
+    double sum = 0;
+    for (int i = 0; i < latencies.size(); i++)
+        sum += latencies[i];
+
+    auto percentile = [this](double part) { return latencies[qMin(latencies.size() - 1, (int)(part * latencies.size()))]; };
+    return QString(", latency ms  min %1  mean %2  median %3  p99 %4  max %5")
+        .arg(latencies.first(), 0, 'f', 3)
+        .arg(sum / latencies.size(), 0, 'f', 3)
+        .arg(percentile(0.5), 0, 'f', 3)
+        .arg(percentile(0.99), 0, 'f', 3)
+        .arg(latencies.last(), 0, 'f', 3);
+}
+
+//  -----------      ----------------                Button Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Load button
+ *
+ * @code {.c++}
+ * ProcedureWindow::on_Load_pushButton_clicked()
+ * @endcode
+ */
+void ProcedureWindow::on_Load_pushButton_clicked()
+{
+    QString path = QFileDialog::getOpenFileName(this, tr("Select Procedure File"), QDir::rootPath(), "Text File (*.txt)");
+    if (!path.isEmpty())
+        loadProcedure(path);
+}
+
+/**
+ * @brief Run button
+ *
+ * Runner talks to the link with queued connections, results of every tag
+ * are delivered to it and filtered by its tag range.
+ *
+ * @code {.c++}
+ * ProcedureWindow::on_Run_pushButton_clicked()
+ * @endcode
+ */
+void ProcedureWindow::on_Run_pushButton_clicked()
+{
+    if (targetLink.isNull())
+    {
+        QMessageBox::warning(this, "Procedure", "Link is closed");
+        return;
+    }
+
+    // clearing results of the previous run
+    for (int i = 0; i < stepItems.size(); i++)
+    {
+        QStandardItem *parent = stepItems[i]->parent();
+        for (int column = StatusColumn; column <= ResponseColumn; column++)
+            parent->setChild(stepItems[i]->row(), column, new QStandardItem());
+    }
+
+    procedureMode mode = (procedureMode)ui->Mode_comboBox->currentIndex();
+    QVector<procedureStep> steps = ProcedureRunner::stepsFromModel(procedureModel);
+    int repeat = mode == procedureScheduled ? 1 : ui->Repeat_spinBox->value();
+    if ((qint64)steps.size() * repeat > ProcedureRunner::stepLimit())
+    {
+        QMessageBox::warning(this, "Procedure", "Too many commands, at most " + QString::number(ProcedureRunner::stepLimit()) + " can be sent in a run");
+        return;
+    }
+
+    QVector<procedureStep> run;
+    run.reserve(steps.size() * repeat);
+    for (int i = 0; i < repeat; i++)
+        run += steps;
+    latencies.clear();
+    latencies.reserve(run.size());
+
+    runner = new ProcedureRunner(run, mode);
+    runner->moveToThread(&runnerThread);
+    connect(&runnerThread, SIGNAL(started()), runner, SLOT(run()));
+    connect(runner, SIGNAL(sendRequested(QByteArray, int)), targetLink.data(), SLOT(sendCommand(QByteArray, int)));
+    connect(targetLink.data(), SIGNAL(commandFinished(commandResult)), runner, SLOT(onCommandFinished(commandResult)));
+    connect(runner, SIGNAL(stepSent(int, double)), this, SLOT(onStepSent(int, double)));
+    connect(runner, SIGNAL(stepFinished(int, commandResult)), this, SLOT(onStepFinished(int, commandResult)));
+    connect(runner, SIGNAL(finished(int, int, double)), this, SLOT(onFinished(int, int, double)));
+
+    setRunning(true);
+    ui->Status_label->setText("Running...");
+    runnerThread.start();
+}
+
+/**
+ * @brief Stop button
+ *
+ * Unsent commands are dropped, runner finishes when the sent ones are answered or timed out.
+ * If the link is closed meanwhile, runner is stopped at once.
+ *
+ * @code {.c++}
+ * ProcedureWindow::on_Stop_pushButton_clicked()
+ * @endcode
+ */
+void ProcedureWindow::on_Stop_pushButton_clicked()
+{
+    if (targetLink.isNull()) // results of the sent commands will not come
+    {
+        stopRunner();
+        setRunning(false);
+        ui->Status_label->setText("Link is closed");
+        return;
+    }
+
+    if (runner != nullptr)
+        QMetaObject::invokeMethod(runner, "cancel", Qt::QueuedConnection);
+    ui->Stop_pushButton->setEnabled(false);
+    ui->Status_label->setText("Stopping...");
+}
+
+/**
+ * @brief Mode combo box
+ *
+ * Scheduled commands have fixed times, so they are run once.
+ *
+ * @code {.c++}
+ * ProcedureWindow::on_Mode_comboBox_currentIndexChanged(int index)
+ * @endcode
+ */
+void ProcedureWindow::on_Mode_comboBox_currentIndexChanged(int index)
+{
+    ui->Repeat_spinBox->setEnabled(index != procedureScheduled);
+}
+
+/**
+ * @brief Save button
+ *
+ * Saves result of each command as csv.
+ *
+ * @code {.c++}
+ * ProcedureWindow::on_Save_pushButton_clicked()
+ * @endcode
+ */
+void ProcedureWindow::on_Save_pushButton_clicked()
+{
+    QString path = QFileDialog::getSaveFileName(this, tr("Save Procedure Results"), QDir::rootPath(), "CSV File (*.csv)");
+    if (path.isEmpty())
+        return;
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        QMessageBox::warning(this, "Procedure", "Cannot write " + path);
+        return;
+    }
+
+    QTextStream stream(&file);
+    stream << "Group,Command,Schedule,Status,Latency (ms),Response\n";
+    for (int i = 0; i < stepItems.size(); i++)
+    {
+        QStandardItem *parent = stepItems[i]->parent();
+        int row = stepItems[i]->row();
+        stream << "\"" << parent->text() << "\"";
+        for (int column : {CommandColumn, ScheduleColumn, StatusColumn, LatencyColumn, ResponseColumn})
+        {
+            QString text = parent->child(row, column) != nullptr ? parent->child(row, column)->text() : QString();
+            stream << ",\"" << text.replace('"', "\"\"") << "\"";
+        }
+        stream << "\n";
+    }
+    file.close();
+}
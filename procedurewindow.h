@@ -0,0 +1,58 @@
+#ifndef PROCEDUREWINDOW_H
+#define PROCEDUREWINDOW_H
+
+#include <QWidget>
+#include <QThread>
+#include <QPointer>
+#include <QVector>
+#include <QStandardItemModel>
+#include "procedurerunner.h"
+#include "telemetrylink.h"
+
+namespace Ui
+{
+    class ProcedureWindow;
+}
+
+/*
+ * Loads a procedure file and runs its commands on a link.
+ * Status, latency and response of each command are shown next to it and can be saved as csv.
+ * Repeating the procedure one command at a time measures command to ack latency of the link.
+ */
+class ProcedureWindow : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ProcedureWindow(TelemetryLink *link, QWidget *parent = nullptr);
+    ~ProcedureWindow();
+
+private slots:
+    void onStepSent(int step, double elapsed);
+    void onStepFinished(int step, commandResult result);
+    void onFinished(int succeeded, int failed, double elapsed);
+
+    void on_Load_pushButton_clicked();
+    void on_Run_pushButton_clicked();
+    void on_Stop_pushButton_clicked();
+    void on_Save_pushButton_clicked();
+    void on_Mode_comboBox_currentIndexChanged(int index);
+
+private:
+    void loadProcedure(QString fileName);
+    void stopRunner(); // waits for the runner thread and deletes the runner
+    void setRunning(bool state);
+    QString latencySummary(); // statistics of the latencies of the last run
+
+    Ui::ProcedureWindow *ui;
+
+    QPointer<TelemetryLink> targetLink; // link may be closed while the window is open
+    QStandardItemModel *procedureModel = nullptr;
+    QVector<QStandardItem *> stepItems; // command item of each step, repeated runs use the same items
+    QVector<double> latencies;          // ms, acked commands of the last run
+
+    QThread runnerThread;
+    ProcedureRunner *runner = nullptr;
+};
+
+#endif // PROCEDUREWINDOW_H
@@ -0,0 +1,180 @@
+#include "propertyregistry.h"
+
+#include <QReadLocker>
+#include <QWriteLocker>
+#include <cstring>
+
+//  -----------      ----------------                Constructor Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Default Constructor
+ *
+ * @code {.c++}
+ * PropertyRegistry::PropertyRegistry()
+ * @endcode
+ */
+PropertyRegistry::PropertyRegistry()
+{
+}
+
+/**
+ * @brief Global registry
+ *
+ * Created at first use.
+ *
+ * @code {.c++}
+ * PropertyRegistry::instance()
+ * @endcode
+ */
+PropertyRegistry &PropertyRegistry::instance()
+{
+    static PropertyRegistry registry;
+    return registry;
+}
+
+//  -----------      ----------------                Registry Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Id of the property name
+ *
+ * Known names only take the read lock and do not allocate, so it can be called
+ * for every received message. New names get the next id.
+ *
+ * @code {.c++}
+ * PropertyRegistry::intern(const char *name, int length)
+ * @endcode
+ */
+int PropertyRegistry::intern(const char *name, int length)
+{
+    {
+        QReadLocker locker(&lock);
+        int id = findLocked(name, length);
+        if (id != NoProperty)
+            return id;
+    }
+
+    QWriteLocker locker(&lock);
+    int id = findLocked(name, length); // added by another thread meanwhile
+    if (id != NoProperty)
+        return id;
+
+    QByteArray utf8(name, length); // deep copy, name may point into a receive buffer
+    names.append(QString::fromUtf8(utf8));
+    utf8Names.append(utf8);
+    lookup.insert(qHashBits(name, length), names.size() - 1);
+    return names.size() - 1;
+}
+
+/**
+ * @brief Id of the property name
+ *
+ * @code {.c++}
+ * PropertyRegistry::intern(const QByteArray &name)
+ * @endcode
+ */
+int PropertyRegistry::intern(const QByteArray &name)
+{
+    return intern(name.constData(), name.size());
+}
+
+/**
+ * @brief Id of the property name
+ *
+ * @code {.c++}
+ * PropertyRegistry::intern(const QString &name)
+ * @endcode
+ */
+int PropertyRegistry::intern(const QString &name)
+{
+    return intern(name.toUtf8());
+}
+
+/**
+ * @brief Find property name
+ *
+ * Returns NoProperty if the name was never seen.
+ *
+ * @code {.c++}
+ * PropertyRegistry::find(const char *name, int length)
+ * @endcode
+ */
+int PropertyRegistry::find(const char *name, int length) const
+{
+    QReadLocker locker(&lock);
+    return findLocked(name, length);
+}
+
+/**
+ * @brief Find property name
+ *
+ * @code {.c++}
+ * PropertyRegistry::find(const QByteArray &name)
+ * @endcode
+ */
+int PropertyRegistry::find(const QByteArray &name) const
+{
+    return find(name.constData(), name.size());
+}
+
+/**
+ * @brief Find property name, lock must be held
+ *
+ * Ids with the same hash are compared byte by byte.
+ *
+ * @code {.c++}
+ * PropertyRegistry::findLocked(const char *name, int length)
+ * @endcode
+ */
+int PropertyRegistry::findLocked(const char *name, int length) const
+{
+    uint hash = qHashBits(name, length);
+    QMultiHash<uint, int>::const_iterator found = lookup.constFind(hash);
+    while (found != lookup.constEnd() && found.key() == hash)
+    {
+        const QByteArray &candidate = utf8Names.at(found.value());
+        if (candidate.size() == length && memcmp(candidate.constData(), name, length) == 0)
+            return found.value();
+        ++found;
+    }
+    return NoProperty;
+}
+
+/**
+ * @brief Find property name
+ *
+ * @code {.c++}
+ * PropertyRegistry::find(const QString &name)
+ * @endcode
+ */
+int PropertyRegistry::find(const QString &name) const
+{
+    return find(name.toUtf8());
+}
+
+/**
+ * @brief Name of the property
+ *
+ * @code {.c++}
+ * PropertyRegistry::name(int id)
+ * @endcode
+ */
+QString PropertyRegistry::name(int id) const
+{
+    QReadLocker locker(&lock);
+    if (id < 0 || id >= names.size())
+        return QString();
+    return names.at(id);
+}
+
+/**
+ * @brief Number of assigned ids
+ *
+ * @code {.c++}
+ * PropertyRegistry::count()
+ * @endcode
+ */
+int PropertyRegistry::count() const
+{
+    QReadLocker locker(&lock);
+    return names.size();
+}
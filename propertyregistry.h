@@ -0,0 +1,48 @@
+#ifndef PROPERTYREGISTRY_H
+#define PROPERTYREGISTRY_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QReadWriteLock>
+#include <QString>
+#include <QVector>
+
+// ---- Definitions ---- //
+
+#define NoProperty -1 ///< Id used for lines and items without property
+
+/*
+ * Global registry of property names.
+ *
+ * Every property name gets a dense integer id at first sight. Stores, plots,
+ * filters and tables use ids, names are only needed when shown on the ui or
+ * written to files. Ids are never reused, so they can be used as vector indexes.
+ * Can be used from any thread.
+ */
+class PropertyRegistry
+{
+public:
+    static PropertyRegistry &instance();
+
+    int intern(const char *name, int length); // id of the name, assigned at first sight
+    int intern(const QByteArray &name);
+    int intern(const QString &name);
+    int find(const char *name, int length) const; // id of the name, NoProperty if never seen
+    int find(const QByteArray &name) const;
+    int find(const QString &name) const;
+    QString name(int id) const;          // name of the id, empty for NoProperty
+    int count() const;                   // number of assigned ids
+
+private:
+    PropertyRegistry();
+    Q_DISABLE_COPY(PropertyRegistry)
+
+    int findLocked(const char *name, int length) const;
+
+    mutable QReadWriteLock lock;
+    QVector<QString> names;        // name of each id
+    QVector<QByteArray> utf8Names; // utf8 name of each id, compared while looking up
+    QMultiHash<uint, int> lookup;  // hash of utf8 name -> ids, bytes in a receive buffer are looked up without copy
+};
+
+#endif // PROPERTYREGISTRY_H
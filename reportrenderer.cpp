@@ -0,0 +1,350 @@
+#include "reportrenderer.h"
+#include "sessionbrowser.h"
+#include "databasesource.h"
+#include "telemetry.h"
+#include "timeaxisticker.h"
+
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+#include <QThreadPool>
+#include <QThreadStorage>
+#include <QAtomicInt>
+
+// ---- Definitions ---- //
+
+#define ReportImageWidth 1600  ///< Default image size in pixels
+#define ReportImageHeight 900
+#define ReportValueMargin 0.05 ///< Part of the value range added above and below
+
+// -> archive opened by a pool thread, kept until the thread ends
+struct threadArchive
+{
+public:
+    QString path;
+    QSharedPointer<SampleSource> source;
+};
+
+static QThreadStorage<threadArchive> threadArchives; ///< Sources are not shared between threads
+
+/**
+ * @brief Time of a figure list entry
+ *
+ * DateFormat text or seconds since epoch, empty text -> 0.
+ */
+static double figureTime(const QString &text, bool *ok)
+{
+    *ok = true;
+    if (text.isEmpty())
+        return 0;
+
+    double seconds = text.toDouble(ok);
+    if (*ok)
+        return seconds;
+
+    QDateTime time = QDateTime::fromString(text, DateFormat);
+    *ok = time.isValid();
+    return time.toMSecsSinceEpoch() / 1000.0;
+}
+
+//  -----------      ----------------                Constructor Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Constructor
+ *
+ * @code {.c++}
+ * ReportRenderer::ReportRenderer(const QString &archive, const QString &folder, QObject *parent)
+ * @endcode
+ */
+ReportRenderer::ReportRenderer(const QString &archive, const QString &folder, QObject *parent)
+    : QObject(parent), archivePath(archive), outputFolder(folder), imageWidth(ReportImageWidth), imageHeight(ReportImageHeight)
+{
+}
+
+/**
+ * @brief Set image size
+ *
+ * @code {.c++}
+ * ReportRenderer::setImageSize(int width, int height)
+ * @endcode
+ */
+void ReportRenderer::setImageSize(int width, int height)
+{
+    imageWidth = qMax(100, width);
+    imageHeight = qMax(100, height);
+}
+
+/**
+ * @brief Select pdf output
+ *
+ * @code {.c++}
+ * ReportRenderer::setPdf(bool state)
+ * @endcode
+ */
+void ReportRenderer::setPdf(bool state)
+{
+    usePdf = state;
+}
+
+/**
+ * @brief Read figure list
+ *
+ * Empty lines and lines starting with '#' are skipped.
+ *
+ * @code {.c++}
+ * ReportRenderer::readFigures(const QString &path, QString *error)
+ * @endcode
+ */
+QVector<reportFigure> ReportRenderer::readFigures(const QString &path, QString *error)
+{
+    QVector<reportFigure> figures;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        *error = "Cannot open " + path;
+        return figures;
+    }
+
+    QTextStream stream(&file);
+    int lineNumber = 0;
+    while (!stream.atEnd())
+    {
+        QString line = stream.readLine().trimmed();
+        lineNumber++;
+        if (line.isEmpty() || line.startsWith('#'))
+            continue;
+
+        QStringList fields = line.split(';');
+        bool fromOk = false;
+        bool toOk = false;
+        reportFigure figure;
+        if (fields.size() == 4)
+        {
+            figure.name = fields[0].trimmed();
+            figure.lower = figureTime(fields[1].trimmed(), &fromOk);
+            figure.upper = figureTime(fields[2].trimmed(), &toOk);
+            QStringList properties = fields[3].split(',');
+            for (int i = 0; i < properties.size(); i++)
+            {
+                if (!properties[i].trimmed().isEmpty())
+                    figure.properties.append(properties[i].trimmed());
+            }
+        }
+
+        if (figure.name.isEmpty() || figure.properties.isEmpty() || !fromOk || !toOk || figure.upper < figure.lower)
+        {
+            *error = path + " line " + QString::number(lineNumber) + " : expected <name> ; <from> ; <to> ; <properties>";
+            return QVector<reportFigure>();
+        }
+        figures.append(figure);
+    }
+    return figures;
+}
+
+//  -----------      ----------------                Render Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Render figures
+ *
+ * Archive is opened once on this thread before any load, so a broken archive fails
+ * every figure with the same error. Loading of every figure is then queued to the pool
+ * at once, each pool thread opens its own read only connection. Old databases have their
+ * keys computed by the connection which opened them, their figures are loaded here from
+ * the source opened first instead of converting the archive again on every thread.
+ * Figures are drawn on this thread in the order they finish loading, png images are
+ * encoded and written by the pool.
+ *
+ * @code {.c++}
+ * ReportRenderer::render(const QVector<reportFigure> &figures)
+ * @endcode
+ */
+int ReportRenderer::render(const QVector<reportFigure> &figures)
+{
+    QDir().mkpath(outputFolder);
+
+    QSharedPointer<SampleSource> archive = SessionBrowser::openSource(archivePath);
+    if (archive.isNull())
+    {
+        for (int i = 0; i < figures.size(); i++)
+        {
+            emit figureFailed(figures[i].name, "Cannot open " + archivePath);
+            emit progress(i + 1, figures.size());
+        }
+        return 0;
+    }
+    QSharedPointer<DatabaseSource> database = archive.dynamicCast<DatabaseSource>();
+    bool shared = !database.isNull() && database->convertedKeys();
+
+    QThreadPool pool; // threads end with the pool, their archives are closed on them
+    QVector<loadedFigure> loaded(figures.size());
+    loadedOrder.clear();
+
+    for (int i = 0; i < figures.size(); i++)
+    {
+        loadedFigure *target = &loaded[i]; // vector is not resized while loading
+        if (shared) // connection of the computed keys stays on this thread
+        {
+            loadFigure(figures[i], archive.data(), target);
+            QMutexLocker locker(&loadedLock);
+            loadedOrder.enqueue(i);
+            loadedCount.release();
+            continue;
+        }
+
+        pool.start([this, &figures, target, i]() {
+            threadArchive &local = threadArchives.localData();
+            if (local.source.isNull() || local.path != archivePath)
+            {
+                local.path = archivePath;
+                local.source = SessionBrowser::openSource(archivePath);
+            }
+            if (local.source.isNull())
+                target->error = "Cannot open " + archivePath;
+            else
+                loadFigure(figures[i], local.source.data(), target);
+
+            QMutexLocker locker(&loadedLock);
+            loadedOrder.enqueue(i);
+            loadedCount.release();
+        });
+    }
+    database.clear(); // shared loads are done, pool threads use their own connections
+    archive.clear();
+
+    // one hidden plot draws every figure
+    QCustomPlot plot;
+    plot.setGeometry(0, 0, imageWidth, imageHeight);
+    plot.plotLayout()->insertRow(0);
+    QCPTextElement *title = new QCPTextElement(&plot, QString(), QFont("sans", 12, QFont::Bold));
+    plot.plotLayout()->addElement(0, 0, title);
+    plot.xAxis->setTicker(QSharedPointer<TimeAxisTicker>(new TimeAxisTicker));
+    plot.xAxis->setLabel("Time");
+    plot.legend->setVisible(true);
+
+    QAtomicInt written;
+    for (int done = 0; done < figures.size(); done++)
+    {
+        loadedCount.acquire();
+        int index;
+        {
+            QMutexLocker locker(&loadedLock);
+            index = loadedOrder.dequeue();
+        }
+
+        const reportFigure &figure = figures[index];
+        if (!loaded[index].error.isEmpty())
+        {
+            emit figureFailed(figure.name, loaded[index].error);
+            emit progress(done + 1, figures.size());
+            continue;
+        }
+
+        drawFigure(&plot, title, figure, loaded[index]);
+        loaded[index].series.clear(); // samples are in the plot now
+
+        QString path = QDir(outputFolder).filePath(figure.name + (usePdf ? ".pdf" : ".png"));
+        if (usePdf) // painter of the pdf writer must stay on this thread
+        {
+            if (plot.savePdf(path, imageWidth, imageHeight))
+                written.ref();
+            else
+                emit figureFailed(figure.name, "Cannot write " + path);
+        }
+        else
+        {
+            QImage image = plot.toPixmap(imageWidth, imageHeight).toImage();
+            QString name = figure.name;
+            pool.start([this, image, path, name, &written]() {
+                if (image.save(path, "PNG"))
+                    written.ref();
+                else
+                    emit figureFailed(name, "Cannot write " + path);
+            });
+        }
+        emit progress(done + 1, figures.size());
+    }
+
+    pool.waitForDone();
+    return written.loadAcquire();
+}
+
+/**
+ * @brief Load samples of a figure
+ *
+ * Runs on the thread which opened the source, samples are decimated to
+ * two per horizontal pixel by the source.
+ *
+ * @code {.c++}
+ * ReportRenderer::loadFigure(const reportFigure &figure, SampleSource *source, loadedFigure *loaded)
+ * @endcode
+ */
+void ReportRenderer::loadFigure(const reportFigure &figure, SampleSource *source, loadedFigure *loaded)
+{
+    QStringList recorded = source->properties();
+    QCPRange range(figure.lower, figure.upper);
+    if (figure.lower == figure.upper) // whole recorded range of the properties
+    {
+        bool found = false;
+        for (int i = 0; i < figure.properties.size(); i++)
+        {
+            if (!recorded.contains(figure.properties[i]))
+                continue;
+            QCPRange keys = source->keyRange(figure.properties[i]);
+            range = found ? QCPRange(qMin(range.lower, keys.lower), qMax(range.upper, keys.upper)) : keys;
+            found = true;
+        }
+        range.lower -= 1; // single samples stay visible
+        range.upper += 1;
+    }
+    loaded->range = range;
+
+    for (int i = 0; i < figure.properties.size(); i++)
+    {
+        if (!recorded.contains(figure.properties[i]))
+        {
+            loaded->error = "Property not recorded : " + figure.properties[i];
+            return;
+        }
+        loaded->series.append(source->loadRange(figure.properties[i], range.lower, range.upper, 2 * imageWidth));
+    }
+}
+
+/**
+ * @brief Draw figure on the hidden plot
+ *
+ * @code {.c++}
+ * ReportRenderer::drawFigure(QCustomPlot *plot, QCPTextElement *title, const reportFigure &figure, const loadedFigure &loaded)
+ * @endcode
+ */
+void ReportRenderer::drawFigure(QCustomPlot *plot, QCPTextElement *title, const reportFigure &figure, const loadedFigure &loaded)
+{
+    static const QColor colors[] = {QColor(31, 119, 180), QColor(214, 39, 40), QColor(44, 160, 44), QColor(255, 127, 14), QColor(148, 103, 189), QColor(140, 86, 75)};
+
+    plot->clearGraphs();
+    title->setText(figure.name);
+
+    bool found = false;
+    QCPRange values;
+    for (int i = 0; i < loaded.series.size(); i++)
+    {
+        QCPGraph *graph = plot->addGraph();
+        graph->setName(figure.properties[i]);
+        graph->setPen(QPen(colors[i % 6]));
+        graph->data()->set(loaded.series[i], true);
+
+        bool inGraph = false;
+        QCPRange range = graph->data()->valueRange(inGraph);
+        if (inGraph)
+        {
+            values = found ? QCPRange(qMin(values.lower, range.lower), qMax(values.upper, range.upper)) : range;
+            found = true;
+        }
+    }
+
+    plot->xAxis->setRange(loaded.range);
+    if (found)
+    {
+        double margin = values.size() > 0 ? values.size() * ReportValueMargin : qMax(1.0, qAbs(values.lower) * ReportValueMargin);
+        plot->yAxis->setRange(values.lower - margin, values.upper + margin);
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef REPORTRENDERER_H
+#define REPORTRENDERER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QImage>
+#include <QMutex>
+#include <QSemaphore>
+#include <QQueue>
+#include "qcustomplot.h"
+#include "samplesource.h"
+
+// -> single figure of a report
+struct reportFigure
+{
+public:
+    QString name;          // output file name without suffix
+    QStringList properties; // plotted properties, one graph each
+    double lower = 0;      // time range, lower == upper -> whole range of the properties
+    double upper = 0;
+};
+
+/*
+ * Renders figures of a recorded session to png or pdf files without showing any window.
+ *
+ * Samples of the figures are loaded and decimated to the image width on a thread pool,
+ * archive is opened once before the loads and once more by each worker thread. Widgets can only be used on the ui thread,
+ * so figures are drawn there with one hidden plot, png encoding is done by the pool again.
+ * Used with the offscreen platform for batch reports:
+ *
+ *   AIB_ClIENT_SW -platform offscreen --report <archive> <figure list> <output folder> [--pdf]
+ *
+ * Figure list has one figure per line, times are DateFormat or seconds since epoch,
+ * empty times plot the whole recorded range:
+ *
+ *   <name> ; <from> ; <to> ; <property>, <property> ...
+ */
+class ReportRenderer : public QObject
+{
+    Q_OBJECT
+
+public:
+    ReportRenderer(const QString &archive, const QString &folder, QObject *parent = nullptr);
+
+    static QVector<reportFigure> readFigures(const QString &path, QString *error); // figure list file
+    void setImageSize(int width, int height);
+    void setPdf(bool state);               // pdf instead of png
+
+    int render(const QVector<reportFigure> &figures); // blocks until every figure is written, returns number of written figures
+
+signals:
+    void progress(int done, int total);
+    void figureFailed(QString name, QString message);
+
+private:
+    // -> samples of a figure, filled by a pool thread
+    struct loadedFigure
+    {
+        QVector<QVector<QCPGraphData>> series; // one per property
+        QCPRange range;
+        QString error;
+    };
+
+    void loadFigure(const reportFigure &figure, SampleSource *source, loadedFigure *loaded); // runs on the thread of the source
+    void drawFigure(QCustomPlot *plot, QCPTextElement *title, const reportFigure &figure, const loadedFigure &loaded);
+
+    QString archivePath;
+    QString outputFolder;
+    int imageWidth;
+    int imageHeight;
+    bool usePdf = false;
+
+    // *** Loaded figures waiting for the ui thread *** //
+    QMutex loadedLock;
+    QQueue<int> loadedOrder; // indexes of loaded figures in completion order
+    QSemaphore loadedCount;  // released once per loaded figure
+};
+
+#endif // REPORTRENDERER_H
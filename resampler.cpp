@@ -0,0 +1,194 @@
+#include "resampler.h"
+
+#include <cmath>
+#include <limits>
+
+//  -----------      ----------------                Constructor Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Constructor
+ *
+ * @code {.c++}
+ * Resampler::Resampler(const TelemetryStore *store)
+ * @endcode
+ */
+Resampler::Resampler(const TelemetryStore *store) : targetStore(store)
+{
+}
+
+//  -----------      ----------------                Resample Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Resample properties on a common time grid
+ *
+ * Grid points are lower + i * step up to upper. The grid is walked once, every cursor is
+ * advanced up to the current grid point before the row is filled, so each sample of the
+ * range is read once. Properties without a value at a grid point are NaN: before their
+ * first sample, outside their samples for linear, and in empty bins for mean.
+ *
+ * @code {.c++}
+ * Resampler::resample(const QVector<int> &properties, double lower, double upper, double step, int mode, resampledTable *table, QString *error)
+ * @endcode
+ */
+bool Resampler::resample(const QVector<int> &properties, double lower, double upper, double step, int mode, resampledTable *table, QString *error) const
+{
+    if (properties.isEmpty())
+    {
+        *error = "No properties selected";
+        return false;
+    }
+    if (!(step > 0) || std::isinf(step))
+    {
+        *error = "Step has to be a positive number of seconds";
+        return false;
+    }
+    if (!(upper >= lower))
+    {
+        *error = "End of the time range is before its start";
+        return false;
+    }
+
+    double rows = std::floor((upper - lower) / step) + 1;
+    if (rows > ResampleRowLimit)
+    {
+        *error = QString::number(rows, 'f', 0) + " grid points, at most " + QString::number(ResampleRowLimit) + " are allowed, increase the step";
+        return false;
+    }
+    int rowCount = int(rows);
+
+    // cursors start at the first sample needed by the first grid point
+    QVector<resampleCursor> cursors(properties.size());
+    for (int p = 0; p < properties.size(); p++)
+    {
+        resampleCursor &cursor = cursors[p];
+        cursor.count = targetStore->sampleCount(properties[p]); // count first, every counted sample is inside the snapshot
+        cursor.chunks = targetStore->snapshot(properties[p]);
+        cursor.chunkSize = TelemetryStore::chunkSize();
+        cursor.next = firstAfter(cursor, lower, mode == resampleMean);
+    }
+
+    table->properties = properties;
+    table->keys.resize(rowCount);
+    table->columns = QVector<QVector<double>>(properties.size(), QVector<double>(rowCount));
+
+    for (int i = 0; i < rowCount; i++)
+    {
+        double key = lower + i * step; // not accumulated, no drift over long ranges
+        table->keys[i] = key;
+        for (int p = 0; p < cursors.size(); p++)
+            table->columns[p][i] = advance(cursors[p], key, key + step, mode);
+    }
+    return true;
+}
+
+/**
+ * @brief Union of the key ranges of the properties
+ *
+ * @code {.c++}
+ * Resampler::keyRange(const QVector<int> &properties, double *firstKey, double *lastKey)
+ * @endcode
+ */
+bool Resampler::keyRange(const QVector<int> &properties, double *firstKey, double *lastKey) const
+{
+    bool found = false;
+    for (int p = 0; p < properties.size(); p++)
+    {
+        double first = 0;
+        double last = 0;
+        if (!targetStore->keyRange(properties[p], &first, &last))
+            continue;
+
+        *firstKey = found ? qMin(*firstKey, first) : first;
+        *lastKey = found ? qMax(*lastKey, last) : last;
+        found = true;
+    }
+    return found;
+}
+
+/**
+ * @brief Name of the mode
+ */
+QString Resampler::modeName(int mode)
+{
+    switch (mode)
+    {
+    case resampleLast:
+        return "Last Value";
+    case resampleLinear:
+        return "Linear";
+    case resampleMean:
+        return "Mean in Bin";
+    default:
+        return QString();
+    }
+}
+
+/**
+ * @brief First sample with key above the given key, at or above it if inclusive
+ *
+ * @code {.c++}
+ * Resampler::firstAfter(const resampleCursor &cursor, double key, bool inclusive)
+ * @endcode
+ */
+int Resampler::firstAfter(const resampleCursor &cursor, double key, bool inclusive)
+{
+    int low = 0;
+    int high = cursor.count;
+    while (low < high)
+    {
+        int middle = (low + high) / 2;
+        double middleKey = cursor.keyAt(middle);
+        if (middleKey < key || (!inclusive && middleKey == key))
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+/**
+ * @brief Value of the cursor's property at a grid point
+ *
+ * Consumes the samples up to the grid point, up to the next grid point for mean.
+ * Grid points have to be given in ascending order.
+ *
+ * @code {.c++}
+ * Resampler::advance(resampleCursor &cursor, double key, double nextKey, int mode)
+ * @endcode
+ */
+double Resampler::advance(resampleCursor &cursor, double key, double nextKey, int mode)
+{
+    const double missing = std::numeric_limits<double>::quiet_NaN();
+
+    if (mode == resampleMean)
+    {
+        while (cursor.next < cursor.count && cursor.keyAt(cursor.next) < key)
+            cursor.next++;
+
+        double sum = 0;
+        int count = 0;
+        while (cursor.next < cursor.count && cursor.keyAt(cursor.next) < nextKey)
+        {
+            sum += cursor.valueAt(cursor.next);
+            count++;
+            cursor.next++;
+        }
+        return count > 0 ? sum / count : missing;
+    }
+
+    while (cursor.next < cursor.count && cursor.keyAt(cursor.next) <= key)
+        cursor.next++;
+    if (cursor.next == 0) // before the first sample
+        return missing;
+
+    int last = cursor.next - 1;
+    if (mode == resampleLast || cursor.keyAt(last) == key)
+        return cursor.valueAt(last);
+    if (cursor.next == cursor.count) // after the last sample, not extrapolated
+        return missing;
+
+    double fromKey = cursor.keyAt(last);
+    double toKey = cursor.keyAt(cursor.next);
+    double ratio = (key - fromKey) / (toKey - fromKey);
+    return cursor.valueAt(last) + ratio * (cursor.valueAt(cursor.next) - cursor.valueAt(last));
+}
@@ -0,0 +1,70 @@
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include <QString>
+#include <QVector>
+#include <QSharedPointer>
+#include "telemetrystore.h"
+
+// ---- Definitions ---- //
+
+#define ResampleRowLimit 1000000 ///< Largest number of grid points of one resampling
+
+// ---- Value of a property at a grid point ---- //
+enum resampleMode
+{
+    resampleLast,   // last sample at or before the grid point
+    resampleLinear, // interpolated between the samples around the grid point
+    resampleMean    // mean of the samples in [grid point, next grid point)
+};
+
+// -> properties aligned on a common time grid, NaN where a property has no value
+struct resampledTable
+{
+public:
+    QVector<double> keys;             // grid points, seconds since epoch
+    QVector<int> properties;          // property registry id of each column
+    QVector<QVector<double>> columns; // one value per grid point for each property
+
+    int rowCount() const { return keys.size(); }
+};
+
+/*
+ * Time aligned join of several properties.
+ *
+ * Every property is read from a snapshot of its store columns through a cursor which
+ * only moves forward. Cursors start at the beginning of the range by binary search,
+ * then the grid is walked once and each cursor is advanced past the samples of the
+ * current grid point, so the cost is one pass over the samples of the range.
+ * Reads snapshots only, safe to run while the links append.
+ */
+class Resampler
+{
+public:
+    explicit Resampler(const TelemetryStore *store);
+
+    bool resample(const QVector<int> &properties, double lower, double upper, double step, int mode, resampledTable *table, QString *error) const;
+    bool keyRange(const QVector<int> &properties, double *firstKey, double *lastKey) const; // union of the key ranges
+
+    static QString modeName(int mode);
+
+private:
+    // -> read position of one property
+    struct resampleCursor
+    {
+        QVector<QSharedPointer<sampleChunk>> chunks;
+        int count = 0; // samples of the snapshot
+        int next = 0;  // first sample not consumed
+        int chunkSize = 1;
+
+        double keyAt(int i) const { return chunks.at(i / chunkSize)->keys[i % chunkSize]; }
+        double valueAt(int i) const { return chunks.at(i / chunkSize)->values[i % chunkSize]; }
+    };
+
+    static int firstAfter(const resampleCursor &cursor, double key, bool inclusive); // first sample with key > (or >=) given key
+    static double advance(resampleCursor &cursor, double key, double nextKey, int mode);
+
+    const TelemetryStore *targetStore;
+};
+
+#endif // RESAMPLER_H
@@ -0,0 +1,448 @@
+#include "resamplewindow.h"
+#include "ui_resamplewindow.h"
+#include "propertyregistry.h"
+
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QDateTime>
+#include <QTextStream>
+#include <QHeaderView>
+#include <cmath>
+
+// ---- Definitions ---- //
+
+#define DefaultGridPoints 1000 ///< Grid points of the default step over the full range
+#define TimeFormat "yyyy-MM-dd hh:mm:ss.zzz" ///< Time column of the table and the csv
+
+/**
+ * @brief Text of a resampled value, empty where the property has no value
+ */
+static inline QString valueText(double value)
+{
+    return std::isnan(value) ? QString() : QString::number(value, 'g', 10);
+}
+
+//  -----------      ----------------                Table Model Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Constructor
+ *
+ * @code {.c++}
+ * ResampledTableModel::ResampledTableModel(QObject *parent)
+ * @endcode
+ */
+ResampledTableModel::ResampledTableModel(QObject *parent) : QAbstractTableModel(parent)
+{
+}
+
+/**
+ * @brief Number of grid points
+ *
+ * @code {.c++}
+ * ResampledTableModel::rowCount(const QModelIndex &parent)
+ * @endcode
+ */
+int ResampledTableModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return table.rowCount();
+}
+
+/**
+ * @brief Time column and one column per property
+ *
+ * @code {.c++}
+ * ResampledTableModel::columnCount(const QModelIndex &parent)
+ * @endcode
+ */
+int ResampledTableModel::columnCount(const QModelIndex &parent) const
+{
+    if (parent.isValid() || table.rowCount() == 0)
+        return 0;
+    return table.columns.size() + 1;
+}
+
+/**
+ * @brief Data of the cell
+ *
+ * Called by the view for visible cells only.
+ *
+ * @code {.c++}
+ * ResampledTableModel::data(const QModelIndex &index, int role)
+ * @endcode
+ */
+QVariant ResampledTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || role != Qt::DisplayRole)
+        return QVariant();
+
+    if (index.column() == 0)
+        return QDateTime::fromMSecsSinceEpoch(qint64(table.keys.at(index.row()) * 1000)).toString(TimeFormat);
+    return valueText(table.columns.at(index.column() - 1).at(index.row()));
+}
+
+/**
+ * @brief Column names
+ *
+ * @code {.c++}
+ * ResampledTableModel::headerData(int section, Qt::Orientation orientation, int role)
+ * @endcode
+ */
+QVariant ResampledTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal)
+        return QAbstractTableModel::headerData(section, orientation, role);
+
+    if (section == 0)
+        return "Time";
+    if (section - 1 < table.properties.size())
+        return PropertyRegistry::instance().name(table.properties.at(section - 1));
+    return QVariant();
+}
+
+/**
+ * @brief Show a new table
+ *
+ * @code {.c++}
+ * ResampledTableModel::setTable(const resampledTable &newTable)
+ * @endcode
+ */
+void ResampledTableModel::setTable(const resampledTable &newTable)
+{
+    beginResetModel();
+    table = newTable; // columns are shared with the window, not copied
+    endResetModel();
+}
+
+//  -----------      ----------------                Constructor Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Constructor
+ *
+ * Given properties are checked and resampled over their full range,
+ * other properties of the main window are listed unchecked.
+ *
+ * @code {.c++}
+ * ResampleWindow::ResampleWindow(TelemetryStore *store, QStandardItemModel *mainProperties, const QVector<int> &properties, QWidget *parent)
+ * @endcode
+ */
+ResampleWindow::ResampleWindow(TelemetryStore *store, QStandardItemModel *mainProperties, const QVector<int> &properties, QWidget *parent)
+    : QWidget(parent), ui(new Ui::ResampleWindow), targetModelProperties(mainProperties), resampler(store)
+{
+    ui->setupUi(this);
+    setAttribute(Qt::WA_DeleteOnClose);
+
+    channelsModel = new QStandardItemModel(this);
+    for (int i = 0; i < properties.size(); i++)
+    {
+        QStandardItem *item = new QStandardItem(PropertyRegistry::instance().name(properties[i]));
+        item->setData(properties[i], Qt::UserRole);
+        item->setCheckable(true);
+        item->setCheckState(Qt::Checked);
+        channelsModel->appendRow(item);
+    }
+    ui->Channels_listView->setModel(channelsModel);
+    updateChannels();
+
+    for (int mode : {resampleLast, resampleLinear, resampleMean})
+        ui->Mode_comboBox->addItem(Resampler::modeName(mode), mode);
+
+    tableModel = new ResampledTableModel(this);
+    ui->Resampled_tableView->setModel(tableModel);
+    ui->Resampled_tableView->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+
+    QCustomPlot *plot = ui->Scatter_customPlot;
+    plot->setInteractions(QCP::iRangeDrag | QCP::iRangeZoom);
+    scatter = new QCPCurve(plot->xAxis, plot->yAxis);
+    scatter->setLineStyle(QCPCurve::lsNone);
+    scatter->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssDisc, 4));
+    scatter->setPen(QPen(QColor(20 + 200 / 4.0, 70 * (1.6 / 4.0), 150)));
+
+    on_Range_pushButton_clicked();
+    if (!properties.isEmpty())
+        on_Compute_pushButton_clicked();
+}
+
+/**
+ * @brief Destructor
+ *
+ * @code {.c++}
+ * ResampleWindow::~ResampleWindow()
+ * @endcode
+ */
+ResampleWindow::~ResampleWindow()
+{
+    delete ui;
+}
+
+//  -----------      ----------------                Channel Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Add new properties to the channel list
+ *
+ * @code {.c++}
+ * ResampleWindow::updateChannels()
+ * @endcode
+ */
+void ResampleWindow::updateChannels()
+{
+    for (int i = 0; i < targetModelProperties->rowCount(); i++)
+    {
+        QVariant id = targetModelProperties->item(i, 0)->data(Qt::UserRole); // header row has no id
+        if (!id.isValid())
+            continue;
+
+        bool listed = false;
+        for (int j = 0; j < channelsModel->rowCount() && !listed; j++)
+            listed = channelsModel->item(j)->data(Qt::UserRole).toInt() == id.toInt();
+        if (listed)
+            continue;
+
+        QStandardItem *item = new QStandardItem(PropertyRegistry::instance().name(id.toInt()));
+        item->setData(id, Qt::UserRole);
+        item->setCheckable(true);
+        item->setCheckState(Qt::Unchecked);
+        channelsModel->appendRow(item);
+    }
+}
+
+/**
+ * @brief Properties checked on the channel list, in list order
+ *
+ * @code {.c++}
+ * ResampleWindow::checkedProperties()
+ * @endcode
+ */
+QVector<int> ResampleWindow::checkedProperties() const
+{
+    QVector<int> properties;
+    for (int i = 0; i < channelsModel->rowCount(); i++)
+    {
+        if (channelsModel->item(i)->checkState() == Qt::Checked)
+            properties.append(channelsModel->item(i)->data(Qt::UserRole).toInt());
+    }
+    return properties;
+}
+
+//  -----------      ----------------                Button Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Full range button
+ *
+ * Time range is set to the stored samples of the checked properties,
+ * step is set to divide the range into about DefaultGridPoints points.
+ *
+ * @code {.c++}
+ * ResampleWindow::on_Range_pushButton_clicked()
+ * @endcode
+ */
+void ResampleWindow::on_Range_pushButton_clicked()
+{
+    updateChannels();
+
+    double firstKey = 0;
+    double lastKey = 0;
+    if (!resampler.keyRange(checkedProperties(), &firstKey, &lastKey))
+    {
+        ui->From_dateTimeEdit->setDateTime(QDateTime::currentDateTime());
+        ui->To_dateTimeEdit->setDateTime(QDateTime::currentDateTime());
+        return;
+    }
+
+    ui->From_dateTimeEdit->setDateTime(QDateTime::fromMSecsSinceEpoch(qint64(std::floor(firstKey)) * 1000));
+    ui->To_dateTimeEdit->setDateTime(QDateTime::fromMSecsSinceEpoch(qint64(std::ceil(lastKey)) * 1000)); // edits show whole seconds
+    ui->Step_doubleSpinBox->setValue(qMax(ui->Step_doubleSpinBox->minimum(), std::ceil((lastKey - firstKey) / DefaultGridPoints * 1000) / 1000));
+}
+
+/**
+ * @brief Compute button
+ *
+ * Resamples the checked properties, X-Y selections are kept when their columns are still present.
+ *
+ * @code {.c++}
+ * ResampleWindow::on_Compute_pushButton_clicked()
+ * @endcode
+ */
+void ResampleWindow::on_Compute_pushButton_clicked()
+{
+    updateChannels();
+
+    double lower = ui->From_dateTimeEdit->dateTime().toMSecsSinceEpoch() / 1000.0;
+    double upper = ui->To_dateTimeEdit->dateTime().toMSecsSinceEpoch() / 1000.0;
+    int mode = ui->Mode_comboBox->currentData().toInt();
+
+    resampledTable newTable;
+    QString error;
+    if (!resampler.resample(checkedProperties(), lower, upper, ui->Step_doubleSpinBox->value(), mode, &newTable, &error))
+    {
+        ui->Status_label->setText(error);
+        return;
+    }
+
+    table = newTable;
+    tableModel->setTable(table);
+
+    int xProperty = ui->X_comboBox->currentData().isValid() ? ui->X_comboBox->currentData().toInt() : NoProperty;
+    int yProperty = ui->Y_comboBox->currentData().isValid() ? ui->Y_comboBox->currentData().toInt() : NoProperty;
+    ui->X_comboBox->blockSignals(true);
+    ui->Y_comboBox->blockSignals(true);
+    ui->X_comboBox->clear();
+    ui->Y_comboBox->clear();
+    for (int p = 0; p < table.properties.size(); p++)
+    {
+        QString name = PropertyRegistry::instance().name(table.properties[p]);
+        ui->X_comboBox->addItem(name, table.properties[p]);
+        ui->Y_comboBox->addItem(name, table.properties[p]);
+    }
+    int xIndex = ui->X_comboBox->findData(xProperty);
+    int yIndex = ui->Y_comboBox->findData(yProperty);
+    ui->X_comboBox->setCurrentIndex(xIndex >= 0 ? xIndex : 0);
+    ui->Y_comboBox->setCurrentIndex(yIndex >= 0 ? yIndex : qMin(1, table.properties.size() - 1));
+    ui->X_comboBox->blockSignals(false);
+    ui->Y_comboBox->blockSignals(false);
+
+    ui->Status_label->setText(QString::number(table.rowCount()) + " rows, " + QString::number(table.properties.size()) + " properties, " + Resampler::modeName(mode).toLower());
+    updateScatter();
+}
+
+/**
+ * @brief Save button
+ *
+ * Saves the aligned columns as csv, properties without a value at a grid point are empty cells.
+ *
+ * @code {.c++}
+ * ResampleWindow::on_Save_pushButton_clicked()
+ * @endcode
+ */
+void ResampleWindow::on_Save_pushButton_clicked()
+{
+    if (table.rowCount() == 0)
+    {
+        QMessageBox::warning(this, "Resample", "Nothing to save, compute the table first");
+        return;
+    }
+
+    QString path = QFileDialog::getSaveFileName(this, tr("Save Resampled Table"), QDir::currentPath(), "CSV File (*.csv)");
+    if (path.isEmpty())
+        return;
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        QMessageBox::warning(this, "Resample", "Cannot write " + path);
+        return;
+    }
+
+    QTextStream stream(&file);
+    stream << "<TimeStamp>,<Time Key>";
+    for (int p = 0; p < table.properties.size(); p++)
+        stream << ",\"" << PropertyRegistry::instance().name(table.properties[p]).replace('"', "\"\"") << "\"";
+    stream << "\n";
+
+    for (int i = 0; i < table.rowCount(); i++)
+    {
+        double key = table.keys[i];
+        stream << QDateTime::fromMSecsSinceEpoch(qint64(key * 1000)).toString(TimeFormat) << "," << QString::number(key, 'f', 3);
+        for (int p = 0; p < table.columns.size(); p++)
+            stream << "," << valueText(table.columns[p][i]);
+        stream << "\n";
+    }
+    file.close();
+}
+
+//  -----------      ----------------                X-Y Functions                     ----------------              ---------------- //
+
+/**
+ * @brief X property changed
+ *
+ * @code {.c++}
+ * ResampleWindow::on_X_comboBox_currentIndexChanged(int index)
+ * @endcode
+ */
+void ResampleWindow::on_X_comboBox_currentIndexChanged(int index)
+{
+    Q_UNUSED(index);
+    updateScatter();
+}
+
+/**
+ * @brief Y property changed
+ *
+ * @code {.c++}
+ * ResampleWindow::on_Y_comboBox_currentIndexChanged(int index)
+ * @endcode
+ */
+void ResampleWindow::on_Y_comboBox_currentIndexChanged(int index)
+{
+    Q_UNUSED(index);
+    updateScatter();
+}
+
+/**
+ * @brief Update X-Y curve and correlation
+ *
+ * Curve parameter is the grid time, so the points keep their time order.
+ * Correlation is Pearson's r over the rows with a value on both axes.
+ *
+ * @code {.c++}
+ * ResampleWindow::updateScatter()
+ * @endcode
+ */
+void ResampleWindow::updateScatter()
+{
+    QCustomPlot *plot = ui->Scatter_customPlot;
+    int xColumn = ui->X_comboBox->currentIndex();
+    int yColumn = ui->Y_comboBox->currentIndex();
+    if (xColumn < 0 || yColumn < 0 || xColumn >= table.columns.size() || yColumn >= table.columns.size())
+    {
+        scatter->data()->clear();
+        ui->Correlation_label->setText("r = -");
+        plot->replot();
+        return;
+    }
+
+    const QVector<double> &xValues = table.columns[xColumn];
+    const QVector<double> &yValues = table.columns[yColumn];
+    QVector<double> t, x, y;
+    t.reserve(table.rowCount());
+    x.reserve(table.rowCount());
+    y.reserve(table.rowCount());
+    for (int i = 0; i < table.rowCount(); i++)
+    {
+        if (std::isnan(xValues[i]) || std::isnan(yValues[i]))
+            continue;
+        t.append(table.keys[i]);
+        x.append(xValues[i]);
+        y.append(yValues[i]);
+    }
+    scatter->setData(t, x, y, true);
+
+    // two passes, sums of deviations from the means
+    double xMean = 0;
+    double yMean = 0;
+    for (int i = 0; i < x.size(); i++)
+    {
+        xMean += x[i];
+        yMean += y[i];
+    }
+    xMean /= qMax(1, x.size());
+    yMean /= qMax(1, y.size());
+
+    double xy = 0;
+    double xx = 0;
+    double yy = 0;
+    for (int i = 0; i < x.size(); i++)
+    {
+        xy += (x[i] - xMean) * (y[i] - yMean);
+        xx += (x[i] - xMean) * (x[i] - xMean);
+        yy += (y[i] - yMean) * (y[i] - yMean);
+    }
+    QString correlation = (x.size() > 1 && xx > 0 && yy > 0) ? QString::number(xy / std::sqrt(xx * yy), 'f', 4) : "-";
+    ui->Correlation_label->setText("r = " + correlation + " (" + QString::number(x.size()) + " points)");
+
+    plot->xAxis->setLabel(ui->X_comboBox->currentText());
+    plot->yAxis->setLabel(ui->Y_comboBox->currentText());
+    plot->rescaleAxes();
+    plot->replot();
+}
@@ -0,0 +1,78 @@
+#ifndef RESAMPLEWINDOW_H
+#define RESAMPLEWINDOW_H
+
+#include <QWidget>
+#include <QVector>
+#include <QAbstractTableModel>
+#include <QStandardItemModel>
+#include "qcustomplot.h"
+#include "telemetrystore.h"
+#include "resampler.h"
+
+namespace Ui
+{
+    class ResampleWindow;
+}
+
+/*
+ * Table model of a resampled table.
+ * Time column followed by one column per property, cells are formatted when the view asks.
+ */
+class ResampledTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit ResampledTableModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    void setTable(const resampledTable &newTable);
+
+private:
+    resampledTable table;
+};
+
+/*
+ * Cross property analysis of stored telemetry.
+ *
+ * Checked properties are resampled on a common time grid, the aligned columns are shown
+ * as a table, saved as csv and plotted against each other. X-Y plot uses a curve with
+ * the grid time as parameter, rows without a value on either axis are left out.
+ * Works on the store only, results are updated with Compute.
+ */
+class ResampleWindow : public QWidget
+{
+    Q_OBJECT
+
+public:
+    ResampleWindow(TelemetryStore *store, QStandardItemModel *mainProperties, const QVector<int> &properties, QWidget *parent = nullptr);
+    ~ResampleWindow();
+
+private slots:
+    void on_Range_pushButton_clicked();
+    void on_Compute_pushButton_clicked();
+    void on_Save_pushButton_clicked();
+    void on_X_comboBox_currentIndexChanged(int index);
+    void on_Y_comboBox_currentIndexChanged(int index);
+
+private:
+    void updateChannels();            // adds new properties of the main window to the list
+    QVector<int> checkedProperties() const;
+    void updateScatter();             // X-Y curve and correlation of the selected columns
+
+    Ui::ResampleWindow *ui;
+
+    QStandardItemModel *targetModelProperties;
+    QStandardItemModel *channelsModel;
+    ResampledTableModel *tableModel;
+    QCPCurve *scatter;
+
+    Resampler resampler;
+    resampledTable table;
+};
+
+#endif // RESAMPLEWINDOW_H
@@ -0,0 +1,189 @@
+#include "samplesource.h"
+
+#include <cmath>
+
+//  -----------      ----------------                Decimation Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Constructor
+ *
+ * Splits [lower, upper] into given number of equally sized buckets.
+ * Results are appended to the output vector.
+ *
+ * @code {.c++}
+ * MinMaxDecimator::MinMaxDecimator(double lower, double upper, int buckets, QVector<QCPGraphData> *output)
+ * @endcode
+ */
+MinMaxDecimator::MinMaxDecimator(double lower, double upper, int buckets, QVector<QCPGraphData> *output) : rangeLower(lower), bucketCount(qMax(1, buckets)), target(output)
+{
+    bucketWidth = (upper - lower) / bucketCount;
+    if (bucketWidth <= 0)
+        bucketWidth = 1;
+}
+
+/**
+ * @brief Bucket index of the key
+ *
+ * Keys outside of the range are clamped to the first or last bucket.
+ *
+ * @code {.c++}
+ * MinMaxDecimator::bucketOf(double key)
+ * @endcode
+ */
+int MinMaxDecimator::bucketOf(double key) const
+{
+    int bucket = (int)std::floor((key - rangeLower) / bucketWidth);
+    return qBound(0, bucket, bucketCount - 1);
+}
+
+/**
+ * @brief Add single sample
+ *
+ * @code {.c++}
+ * MinMaxDecimator::add(double key, double value)
+ * @endcode
+ */
+void MinMaxDecimator::add(double key, double value)
+{
+    int bucket = bucketOf(key);
+    if (bucket != currentBucket) // new bucket -> write previous one
+    {
+        flush();
+        currentBucket = bucket;
+        minSample = QCPGraphData(key, value);
+        maxSample = minSample;
+        return;
+    }
+
+    if (value < minSample.value)
+        minSample = QCPGraphData(key, value);
+    if (value > maxSample.value)
+        maxSample = QCPGraphData(key, value);
+}
+
+/**
+ * @brief Add block summary
+ *
+ * Used when a whole block of samples falls into one bucket, so the block
+ * itself does not need to be read. Position of minimum and maximum inside the
+ * block is not known, they are placed in the middle of the block.
+ *
+ * @code {.c++}
+ * MinMaxDecimator::addSummary(double firstKey, double lastKey, double minValue, double maxValue)
+ * @endcode
+ */
+void MinMaxDecimator::addSummary(double firstKey, double lastKey, double minValue, double maxValue)
+{
+    double middle = (firstKey + lastKey) / 2;
+    add(middle, minValue);
+    add(middle, maxValue);
+}
+
+/**
+ * @brief Write the last bucket
+ *
+ * @code {.c++}
+ * MinMaxDecimator::finish()
+ * @endcode
+ */
+void MinMaxDecimator::finish()
+{
+    flush();
+    currentBucket = -1;
+}
+
+/**
+ * @brief Write current bucket to output
+ *
+ * Minimum and maximum are written in key order, only once if they are the same sample.
+ *
+ * @code {.c++}
+ * MinMaxDecimator::flush()
+ * @endcode
+ */
+void MinMaxDecimator::flush()
+{
+    if (currentBucket < 0)
+        return;
+
+    if (minSample.key == maxSample.key && minSample.value == maxSample.value)
+    {
+        target->append(minSample);
+    }
+    else if (minSample.key <= maxSample.key)
+    {
+        target->append(minSample);
+        target->append(maxSample);
+    }
+    else
+    {
+        target->append(maxSample);
+        target->append(minSample);
+    }
+}
+
+//  -----------      ----------------                Export Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Constructor
+ *
+ * Graphs with fewer visible samples than buckets are left as they are. One sample on each
+ * side of the visible range is kept, so lines reach the plot borders.
+ *
+ * @code {.c++}
+ * ExportDecimation::ExportDecimation(QCustomPlot *plot, double scale)
+ * @endcode
+ */
+ExportDecimation::ExportDecimation(QCustomPlot *plot, double scale)
+{
+    for (int i = 0; i < plot->graphCount(); i++)
+    {
+        QCPGraph *graph = plot->graph(i);
+        QSharedPointer<QCPGraphDataContainer> full = graph->data();
+        QCPRange range = graph->keyAxis()->range();
+        int buckets = qMax(1, (int)(graph->keyAxis()->axisRect()->width() * scale));
+
+        QCPGraphDataContainer::const_iterator begin = full->findBegin(range.lower, true); // includes sample before the range
+        QCPGraphDataContainer::const_iterator end = full->findEnd(range.upper, true);     // includes sample after the range
+        if (end - begin <= 2 * buckets)
+            continue;
+
+        QVector<QCPGraphData> samples;
+        samples.reserve(2 * buckets + 2);
+        if (begin->key < range.lower)
+            samples.append(*begin++);
+
+        bool after = (end - 1)->key > range.upper;
+        if (after)
+            --end;
+
+        MinMaxDecimator decimator(range.lower, range.upper, buckets, &samples);
+        for (QCPGraphDataContainer::const_iterator it = begin; it != end; ++it)
+            decimator.add(it->key, it->value);
+        decimator.finish();
+
+        if (after)
+            samples.append(*end);
+
+        QSharedPointer<QCPGraphDataContainer> decimated(new QCPGraphDataContainer);
+        decimated->set(samples, true);
+        graph->setData(decimated);
+        savedData.append(qMakePair(QPointer<QCPGraph>(graph), full));
+    }
+}
+
+/**
+ * @brief Destructor
+ *
+ * @code {.c++}
+ * ExportDecimation::~ExportDecimation()
+ * @endcode
+ */
+ExportDecimation::~ExportDecimation()
+{
+    for (int i = 0; i < savedData.size(); i++)
+    {
+        if (!savedData[i].first.isNull())
+            savedData[i].first->setData(savedData[i].second);
+    }
+}
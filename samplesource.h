@@ -0,0 +1,76 @@
+#ifndef SAMPLESOURCE_H
+#define SAMPLESOURCE_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QList>
+#include <QPair>
+#include <QPointer>
+#include "qcustomplot.h"
+
+/*
+ * Interface for recorded sessions that can be plotted without loading them.
+ *
+ * Plotting window asks only for the visible key range. Implementations return
+ * at most maxPoints samples, larger ranges are reduced with min/max decimation
+ * so the shape of the signal is kept on the screen.
+ */
+class SampleSource
+{
+public:
+    virtual ~SampleSource() {}
+
+    virtual QStringList properties() const = 0;                        // names of the recorded properties
+    virtual QCPRange keyRange(const QString &property) const = 0;      // first and last key of the property
+    virtual QVector<QCPGraphData> loadRange(const QString &property, double lower, double upper, int maxPoints) = 0;
+};
+
+/*
+ * Min/max decimation into fixed number of buckets.
+ *
+ * Samples must be added in key order. For each bucket, minimum and maximum
+ * samples are kept in key order, so peaks are never lost.
+ */
+class MinMaxDecimator
+{
+public:
+    MinMaxDecimator(double lower, double upper, int buckets, QVector<QCPGraphData> *output);
+
+    int bucketOf(double key) const;
+    void add(double key, double value);                                                // single sample
+    void addSummary(double firstKey, double lastKey, double minValue, double maxValue); // pre computed block inside one bucket
+    void finish();                                                                      // writes the last bucket
+
+private:
+    void flush();
+
+    double rangeLower;
+    double bucketWidth;
+    int bucketCount;
+    QVector<QCPGraphData> *target;
+
+    int currentBucket = -1;
+    QCPGraphData minSample;
+    QCPGraphData maxSample;
+};
+
+/*
+ * Decimated graph data while exporting a plot.
+ *
+ * Vector formats write every drawn sample as a path segment. While this object exists, graphs of
+ * the plot only hold the min/max decimated visible samples, two per output pixel of the axis rect,
+ * so file size and export time depend on the output resolution and not on the sample count.
+ * Full data is restored when it is destroyed.
+ */
+class ExportDecimation
+{
+public:
+    ExportDecimation(QCustomPlot *plot, double scale); // scale -> output pixels per plot pixel
+    ~ExportDecimation();
+
+private:
+    QList<QPair<QPointer<QCPGraph>, QSharedPointer<QCPGraphDataContainer>>> savedData; // full data of each decimated graph
+};
+
+#endif // SAMPLESOURCE_H
@@ -0,0 +1,196 @@
+#include "sessionbrowser.h"
+#include "ui_sessionbrowser.h"
+#include "databasesource.h"
+#include "sessionfile.h"
+#include "plottingwindow.h"
+#include "propertyregistry.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QTableWidgetItem>
+
+//  -----------      ----------------                Constructor Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Constructor
+ *
+ * @code {.c++}
+ * SessionBrowser::SessionBrowser(QString folder, QWidget *parent)
+ * @endcode
+ */
+SessionBrowser::SessionBrowser(QString folder, QWidget *parent) : QWidget(parent), ui(new Ui::SessionBrowser), sessionFolder(folder)
+{
+    ui->setupUi(this);
+    setAttribute(Qt::WA_DeleteOnClose);
+
+    setupSessions_tableWidget();
+}
+
+/**
+ * @brief Destructor
+ *
+ * Open plots keep their own reference to the archive.
+ *
+ * @code {.c++}
+ * SessionBrowser::~SessionBrowser()
+ * @endcode
+ */
+SessionBrowser::~SessionBrowser()
+{
+    delete ui;
+}
+
+/**
+ * @brief Open archive as sample source
+ *
+ * Source type is selected by the file suffix.
+ *
+ * @code {.c++}
+ * SessionBrowser::openSource(const QString &path)
+ * @endcode
+ */
+QSharedPointer<SampleSource> SessionBrowser::openSource(const QString &path)
+{
+    if (path.endsWith(".aibs"))
+    {
+        QSharedPointer<SessionFile> session(new SessionFile());
+        if (session->open(path))
+            return session;
+    }
+    else
+    {
+        QSharedPointer<DatabaseSource> database(new DatabaseSource());
+        if (database->open(path))
+            return database;
+    }
+    return QSharedPointer<SampleSource>();
+}
+
+//  -----------      ----------------                Setup Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Setup sessions table
+ *
+ * Lists archives of the session folder, newest first.
+ *
+ * @code {.c++}
+ * SessionBrowser::setupSessions_tableWidget()
+ * @endcode
+ */
+void SessionBrowser::setupSessions_tableWidget()
+{
+    QFileInfoList files = QDir(sessionFolder).entryInfoList(QStringList() << "*.db" << "*.aibs", QDir::Files, QDir::Time);
+
+    ui->Sessions_tableWidget->clearContents();
+    ui->Sessions_tableWidget->setRowCount(files.size());
+    ui->Sessions_tableWidget->setColumnCount(3);
+    ui->Sessions_tableWidget->setHorizontalHeaderLabels(QStringList() << "Session" << "Size" << "Modified");
+
+    for (int i = 0; i < files.size(); i++) // for each archive in the folder
+    {
+        QTableWidgetItem *name = new QTableWidgetItem(files[i].fileName());
+        name->setData(Qt::UserRole, files[i].absoluteFilePath());
+        ui->Sessions_tableWidget->setItem(i, 0, name);
+        ui->Sessions_tableWidget->setItem(i, 1, new QTableWidgetItem(QString::number(files[i].size() / 1024) + " KB"));
+        ui->Sessions_tableWidget->setItem(i, 2, new QTableWidgetItem(files[i].lastModified().toString("yyyy-MM-dd hh:mm:ss")));
+    }
+    ui->Sessions_tableWidget->resizeColumnsToContents();
+    ui->Status_label->setText(QString::number(files.size()) + " sessions in " + sessionFolder);
+}
+
+//  -----------      ----------------                UI Slots                     ----------------              ---------------- //
+
+/**
+ * @brief Session selected
+ *
+ * Opens the selected archive and lists its properties.
+ *
+ * @code {.c++}
+ * SessionBrowser::on_Sessions_tableWidget_itemSelectionChanged()
+ * @endcode
+ */
+void SessionBrowser::on_Sessions_tableWidget_itemSelectionChanged()
+{
+    ui->Properties_listWidget->clear();
+    source.clear();
+
+    int row = ui->Sessions_tableWidget->currentRow();
+    if (row < 0 || ui->Sessions_tableWidget->item(row, 0) == nullptr)
+        return;
+
+    sessionPath = ui->Sessions_tableWidget->item(row, 0)->data(Qt::UserRole).toString();
+    source = openSource(sessionPath);
+    if (source.isNull())
+    {
+        ui->Status_label->setText("Session could not be opened !");
+        return;
+    }
+
+    ui->Properties_listWidget->addItems(source->properties());
+    ui->Status_label->setText(QString::number(source->properties().size()) + " properties in " + QFileInfo(sessionPath).fileName());
+}
+
+/**
+ * @brief Property double clicked
+ *
+ * @code {.c++}
+ * SessionBrowser::on_Properties_listWidget_itemDoubleClicked()
+ * @endcode
+ */
+void SessionBrowser::on_Properties_listWidget_itemDoubleClicked()
+{
+    on_Plot_pushButton_clicked();
+}
+
+/**
+ * @brief Plot selected property
+ *
+ * Plotting window shares the archive of the browser, so its loaded windows
+ * are reused when several properties of the same session are plotted.
+ *
+ * @code {.c++}
+ * SessionBrowser::on_Plot_pushButton_clicked()
+ * @endcode
+ */
+void SessionBrowser::on_Plot_pushButton_clicked()
+{
+    if (source.isNull() || ui->Properties_listWidget->currentItem() == nullptr)
+        return;
+
+    int property = PropertyRegistry::instance().intern(ui->Properties_listWidget->currentItem()->text());
+    PlottingWindow *plot = new PlottingWindow(source, property, nullptr);
+    plot->setWindowTitle(QFileInfo(sessionPath).fileName());
+    plot->setAttribute(Qt::WA_DeleteOnClose);
+    plot->show();
+}
+
+/**
+ * @brief Refresh session list
+ *
+ * @code {.c++}
+ * SessionBrowser::on_Refresh_pushButton_clicked()
+ * @endcode
+ */
+void SessionBrowser::on_Refresh_pushButton_clicked()
+{
+    setupSessions_tableWidget();
+}
+
+/**
+ * @brief Select another session folder
+ *
+ * @code {.c++}
+ * SessionBrowser::on_Browse_pushButton_clicked()
+ * @endcode
+ */
+void SessionBrowser::on_Browse_pushButton_clicked()
+{
+    QString folder = QFileDialog::getExistingDirectory(this, "Session Folder", sessionFolder);
+    if (folder.isEmpty()) // dialog cancelled
+        return;
+
+    sessionFolder = folder;
+    setupSessions_tableWidget();
+}
@@ -0,0 +1,46 @@
+#ifndef SESSIONBROWSER_H
+#define SESSIONBROWSER_H
+
+#include <QWidget>
+#include <QSharedPointer>
+#include <QString>
+#include "samplesource.h"
+
+namespace Ui
+{
+    class SessionBrowser;
+}
+
+/*
+ * Lists recorded sessions in the data folder and opens plotting windows for them.
+ * Database (*.db) and session file (*.aibs) archives are both supported,
+ * plots load only their visible range from the archive.
+ */
+class SessionBrowser : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit SessionBrowser(QString folder, QWidget *parent = nullptr);
+    ~SessionBrowser();
+
+    static QSharedPointer<SampleSource> openSource(const QString &path); // null if archive can not be opened
+
+    void setupSessions_tableWidget();
+
+private slots:
+    void on_Sessions_tableWidget_itemSelectionChanged();
+    void on_Properties_listWidget_itemDoubleClicked();
+    void on_Plot_pushButton_clicked();
+    void on_Refresh_pushButton_clicked();
+    void on_Browse_pushButton_clicked();
+
+private:
+    Ui::SessionBrowser *ui;
+
+    QString sessionFolder;                // folder listed in the table
+    QString sessionPath;                  // selected archive
+    QSharedPointer<SampleSource> source;  // shared by plots of the selected archive
+};
+
+#endif // SESSIONBROWSER_H
@@ -0,0 +1,39 @@
+#include "sessionexporter.h"
+
+/**
+ * @brief Constructor
+ *
+ * @code {.c++}
+ * SessionExporter::SessionExporter(exportOptions options, QObject *parent)
+ * @endcode
+ */
+SessionExporter::SessionExporter(exportOptions options, QObject *parent) : QObject(parent), targetOptions(options)
+{
+}
+
+/**
+ * @brief Cancel export
+ *
+ * Can be called from any thread. Export stops after the chunk being written
+ * and partial file is removed.
+ *
+ * @code {.c++}
+ * SessionExporter::cancel()
+ * @endcode
+ */
+void SessionExporter::cancel()
+{
+    cancelled.storeRelease(1);
+}
+
+/**
+ * @brief Returns if export is cancelled
+ *
+ * @code {.c++}
+ * SessionExporter::isCancelled()
+ * @endcode
+ */
+bool SessionExporter::isCancelled() const
+{
+    return cancelled.loadAcquire() != 0;
+}
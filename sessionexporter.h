@@ -0,0 +1,55 @@
+#ifndef SESSIONEXPORTER_H
+#define SESSIONEXPORTER_H
+
+#include <QObject>
+#include <QString>
+#include <QAtomicInt>
+
+// ---- Supported export formats ---- //
+enum exportFormat
+{
+    exportCsv = 0,     // text file from session database
+    exportColumnar = 1 // compressed columnar binary file from telemetry store
+};
+
+// -> options selected by user for the export
+struct exportOptions
+{
+public:
+    QString path;              // output file
+    int format = exportCsv;    // exportFormat
+    QString property;          // empty -> all properties
+    bool useTimeRange = false; // only export rows between fromKey and toKey
+    double fromKey = 0;        // seconds since epoch
+    double toKey = 0;
+};
+
+/*
+ * Base class of export workers.
+ *
+ * Exporters run on their own thread, report progress and can be
+ * cancelled from the ui thread at any time.
+ */
+class SessionExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    SessionExporter(exportOptions options, QObject *parent = nullptr);
+
+public slots:
+    virtual void run() = 0; // exports the session, emits finished at the end
+    void cancel();          // thread safe, stops export after current chunk
+
+signals:
+    void progress(int percent);
+    void finished(bool ok, QString message);
+
+protected:
+    bool isCancelled() const;
+
+    exportOptions targetOptions;
+    QAtomicInt cancelled;
+};
+
+#endif // SESSIONEXPORTER_H
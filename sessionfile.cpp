@@ -0,0 +1,572 @@
+#include "sessionfile.h"
+#include "propertyregistry.h"
+
+#include <algorithm>
+#include <cstring>
+
+// ---- Definitions ---- //
+
+#define SessionMagic "AIBSES01"   ///< First 8 bytes of session file
+#define SessionEndMagic "AIBSEND1" ///< Last 8 bytes of a properly closed session file
+#define RecordHeaderSize 16       ///< Bytes of each record header
+#define IndexBlockSize 48         ///< Bytes of each block entry in the index
+
+/**
+ * @brief Size rounded up to 8 bytes
+ */
+static inline qint64 padded(qint64 size)
+{
+    return (size + 7) & ~qint64(7);
+}
+
+/**
+ * @brief Reads value of type T from unaligned position
+ */
+template <typename T>
+static inline T readValue(const uchar *position)
+{
+    T value;
+    std::memcpy(&value, position, sizeof(T));
+    return value;
+}
+
+//  -----------      ----------------                Session Writer Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Constructor
+ *
+ * @code {.c++}
+ * SessionWriter::SessionWriter(TelemetryStore *store)
+ * @endcode
+ */
+SessionWriter::SessionWriter(TelemetryStore *store) : sourceStore(store)
+{
+}
+
+/**
+ * @brief Destructor
+ *
+ * Closes the file properly, so it can be opened without recovery.
+ *
+ * @code {.c++}
+ * SessionWriter::~SessionWriter()
+ * @endcode
+ */
+SessionWriter::~SessionWriter()
+{
+    close();
+}
+
+/**
+ * @brief Create session file
+ *
+ * @code {.c++}
+ * SessionWriter::open(const QString &path)
+ * @endcode
+ */
+bool SessionWriter::open(const QString &path)
+{
+    file.setFileName(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    file.write(SessionMagic, 8);
+    return true;
+}
+
+/**
+ * @brief New sample added to the store
+ *
+ * Series are indexed by property id, name record is written at first sight of the property. When the current chunk of
+ * the series is full, it is written as one block.
+ *
+ * @code {.c++}
+ * SessionWriter::sampleAppended(int series)
+ * @endcode
+ */
+void SessionWriter::sampleAppended(int series)
+{
+    if (!file.isOpen())
+        return;
+
+    while (written.size() <= series) // new property -> name record
+    {
+        writtenSeries entry;
+        entry.name = PropertyRegistry::instance().name(written.size());
+        written.append(entry);
+
+        QByteArray name = entry.name.toUtf8();
+        writeHeader(sessionNameRecord, written.size() - 1, name.size());
+        writePadded(name);
+    }
+
+    int chunkSize = TelemetryStore::chunkSize();
+    if (sourceStore->sampleCount(series) - written[series].writtenSamples >= chunkSize) // chunk full -> write as block
+    {
+        QVector<QSharedPointer<sampleChunk>> chunks = sourceStore->snapshot(series);
+        writeSamples(series, chunks.at(written[series].writtenSamples / chunkSize).data(), 0, chunkSize);
+    }
+}
+
+/**
+ * @brief Receive batch from the telemetry bus
+ *
+ * Samples are delivered after they are added to the store, full chunks of their series are written.
+ *
+ * @code {.c++}
+ * SessionWriter::deliver(const QVector<telemetrySample> &samples)
+ * @endcode
+ */
+void SessionWriter::deliver(const QVector<telemetrySample> &samples)
+{
+    for (int i = 0; i < samples.size(); i++)
+        sampleAppended(samples.at(i).property);
+}
+
+/**
+ * @brief Close session file
+ *
+ * Writes samples of the chunks which are not full yet, then the index
+ * and trailer pointing to the index.
+ *
+ * @code {.c++}
+ * SessionWriter::close()
+ * @endcode
+ */
+void SessionWriter::close()
+{
+    if (!file.isOpen())
+        return;
+
+    int chunkSize = TelemetryStore::chunkSize();
+    for (int series = 0; series < written.size(); series++) // write remaining samples
+    {
+        int count = sourceStore->sampleCount(series);
+        QVector<QSharedPointer<sampleChunk>> chunks = sourceStore->snapshot(series);
+        while (written[series].writtenSamples < count)
+        {
+            int from = written[series].writtenSamples % chunkSize;
+            int amount = qMin(count - written[series].writtenSamples, chunkSize - from);
+            writeSamples(series, chunks.at(written[series].writtenSamples / chunkSize).data(), from, amount);
+        }
+    }
+
+    // index
+    quint64 indexOffset = file.pos();
+    writeHeader(sessionIndexRecord, 0, written.size());
+    for (int series = 0; series < written.size(); series++)
+    {
+        QByteArray name = written[series].name.toUtf8();
+        quint32 sizes[2] = {(quint32)name.size(), (quint32)written[series].blocks.size()};
+        file.write(reinterpret_cast<const char *>(sizes), sizeof(sizes));
+        writePadded(name);
+
+        for (int b = 0; b < written[series].blocks.size(); b++)
+        {
+            const writtenBlock &block = written[series].blocks[b];
+            quint32 counts[2] = {block.count, 0};
+            double summary[4] = {block.firstKey, block.lastKey, block.minValue, block.maxValue};
+            file.write(reinterpret_cast<const char *>(&block.offset), sizeof(quint64));
+            file.write(reinterpret_cast<const char *>(counts), sizeof(counts));
+            file.write(reinterpret_cast<const char *>(summary), sizeof(summary));
+        }
+    }
+
+    // trailer
+    file.write(reinterpret_cast<const char *>(&indexOffset), sizeof(quint64));
+    file.write(SessionEndMagic, 8);
+    file.close();
+}
+
+/**
+ * @brief Write record header
+ *
+ * @code {.c++}
+ * SessionWriter::writeHeader(quint32 type, quint32 property, quint32 count)
+ * @endcode
+ */
+void SessionWriter::writeHeader(quint32 type, quint32 property, quint32 count)
+{
+    quint32 header[4] = {type, property, count, 0};
+    file.write(reinterpret_cast<const char *>(header), RecordHeaderSize);
+}
+
+/**
+ * @brief Write data padded to 8 bytes
+ *
+ * @code {.c++}
+ * SessionWriter::writePadded(const QByteArray &data)
+ * @endcode
+ */
+void SessionWriter::writePadded(const QByteArray &data)
+{
+    static const char zeros[8] = {0};
+    file.write(data);
+    file.write(zeros, padded(data.size()) - data.size());
+}
+
+/**
+ * @brief Write samples as block
+ *
+ * Key and value columns are written directly from the chunk memory.
+ * Block summary is stored for the index.
+ *
+ * @code {.c++}
+ * SessionWriter::writeSamples(int series, const sampleChunk *chunk, int from, int count)
+ * @endcode
+ */
+void SessionWriter::writeSamples(int series, const sampleChunk *chunk, int from, int count)
+{
+    writtenBlock block;
+    block.offset = file.pos();
+    block.count = count;
+    block.firstKey = chunk->keys[from];
+    block.lastKey = chunk->keys[from + count - 1];
+    block.minValue = chunk->values[from];
+    block.maxValue = chunk->values[from];
+    for (int i = from + 1; i < from + count; i++)
+    {
+        block.minValue = qMin(block.minValue, chunk->values[i]);
+        block.maxValue = qMax(block.maxValue, chunk->values[i]);
+    }
+
+    writeHeader(sessionBlockRecord, series, count);
+    file.write(reinterpret_cast<const char *>(&chunk->keys[from]), count * sizeof(double));
+    file.write(reinterpret_cast<const char *>(&chunk->values[from]), count * sizeof(double));
+
+    written[series].blocks.append(block);
+    written[series].writtenSamples += count;
+}
+
+//  -----------      ----------------                Session File Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Constructor
+ *
+ * @code {.c++}
+ * SessionFile::SessionFile()
+ * @endcode
+ */
+SessionFile::SessionFile()
+{
+}
+
+/**
+ * @brief Destructor
+ *
+ * @code {.c++}
+ * SessionFile::~SessionFile()
+ * @endcode
+ */
+SessionFile::~SessionFile()
+{
+    if (mapped != nullptr)
+        file.unmap(mapped);
+}
+
+/**
+ * @brief Open session file
+ *
+ * Maps the whole file into memory. Only the index is read here, sample
+ * pages are loaded by the operating system when they are plotted.
+ *
+ * @code {.c++}
+ * SessionFile::open(const QString &path)
+ * @endcode
+ */
+bool SessionFile::open(const QString &path)
+{
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    mappedSize = file.size();
+    if (mappedSize < 8)
+        return false;
+
+    mapped = file.map(0, mappedSize);
+    if (mapped == nullptr || std::memcmp(mapped, SessionMagic, 8) != 0)
+        return false;
+
+    if (mappedSize >= 24 && std::memcmp(mapped + mappedSize - 8, SessionEndMagic, 8) == 0) // properly closed file
+    {
+        if (readIndex(readValue<quint64>(mapped + mappedSize - 16)))
+            return true;
+    }
+
+    propertyList.clear();
+    propertyLookup.clear();
+    return scanRecords();
+}
+
+/**
+ * @brief Read index of the file
+ *
+ * @code {.c++}
+ * SessionFile::readIndex(quint64 indexOffset)
+ * @endcode
+ */
+bool SessionFile::readIndex(quint64 indexOffset)
+{
+    qint64 end = mappedSize - 16; // index ends where trailer starts
+    qint64 position = indexOffset;
+    if (position + RecordHeaderSize > end || readValue<quint32>(mapped + position) != sessionIndexRecord)
+        return false;
+
+    quint32 propertyCount = readValue<quint32>(mapped + position + 8);
+    position += RecordHeaderSize;
+
+    for (quint32 p = 0; p < propertyCount; p++)
+    {
+        if (position + 8 > end)
+            return false;
+        quint32 nameBytes = readValue<quint32>(mapped + position);
+        quint32 blockCount = readValue<quint32>(mapped + position + 4);
+        position += 8;
+
+        if (position + padded(nameBytes) + (qint64)blockCount * IndexBlockSize > end)
+            return false;
+
+        mappedProperty &property = propertyAt(p);
+        property.name = QString::fromUtf8(reinterpret_cast<const char *>(mapped + position), nameBytes);
+        propertyLookup.insert(property.name, p);
+        position += padded(nameBytes);
+
+        property.blocks.reserve(blockCount);
+        for (quint32 b = 0; b < blockCount; b++)
+        {
+            const uchar *entry = mapped + position;
+            if (!addBlock(p, readValue<quint64>(entry), readValue<quint32>(entry + 8), true,
+                          readValue<double>(entry + 16), readValue<double>(entry + 24), readValue<double>(entry + 32), readValue<double>(entry + 40)))
+                return false;
+            position += IndexBlockSize;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Scan records of the file
+ *
+ * Used when the file has no index. Reads every record header and computes block
+ * summaries, stops at the first incomplete record.
+ *
+ * @code {.c++}
+ * SessionFile::scanRecords()
+ * @endcode
+ */
+bool SessionFile::scanRecords()
+{
+    qint64 position = 8;
+    while (position + RecordHeaderSize <= mappedSize)
+    {
+        quint32 type = readValue<quint32>(mapped + position);
+        quint32 property = readValue<quint32>(mapped + position + 4);
+        quint32 count = readValue<quint32>(mapped + position + 8);
+
+        if (type == sessionNameRecord)
+        {
+            if (position + RecordHeaderSize + padded(count) > mappedSize)
+                break;
+            mappedProperty &entry = propertyAt(property);
+            entry.name = QString::fromUtf8(reinterpret_cast<const char *>(mapped + position + RecordHeaderSize), count);
+            propertyLookup.insert(entry.name, property);
+            position += RecordHeaderSize + padded(count);
+        }
+        else if (type == sessionBlockRecord)
+        {
+            if (!addBlock(property, position, count, false, 0, 0, 0, 0))
+                break;
+            position += RecordHeaderSize + (qint64)count * 2 * sizeof(double);
+        }
+        else // index or broken record
+        {
+            break;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Add block to the property
+ *
+ * Checks that the block is inside the mapping. If summary is not given,
+ * it is computed from the samples.
+ *
+ * @code {.c++}
+ * SessionFile::addBlock(int property, quint64 offset, int count, bool summary, double firstKey, double lastKey, double minValue, double maxValue)
+ * @endcode
+ */
+bool SessionFile::addBlock(int property, quint64 offset, int count, bool summary, double firstKey, double lastKey, double minValue, double maxValue)
+{
+    if (count <= 0 || (qint64)offset + RecordHeaderSize + (qint64)count * 2 * sizeof(double) > mappedSize)
+        return false;
+
+    mappedBlock block;
+    block.keys = reinterpret_cast<const double *>(mapped + offset + RecordHeaderSize);
+    block.values = block.keys + count;
+    block.count = count;
+
+    if (summary)
+    {
+        block.firstKey = firstKey;
+        block.lastKey = lastKey;
+        block.minValue = minValue;
+        block.maxValue = maxValue;
+    }
+    else
+    {
+        block.firstKey = block.keys[0];
+        block.lastKey = block.keys[count - 1];
+        block.minValue = *std::min_element(block.values, block.values + count);
+        block.maxValue = *std::max_element(block.values, block.values + count);
+    }
+
+    mappedProperty &entry = propertyAt(property);
+    entry.blocks.append(block);
+    entry.sampleCount += count;
+    return true;
+}
+
+/**
+ * @brief Property entry, created if not exists
+ *
+ * @code {.c++}
+ * SessionFile::propertyAt(int property)
+ * @endcode
+ */
+SessionFile::mappedProperty &SessionFile::propertyAt(int property)
+{
+    while (propertyList.size() <= property)
+        propertyList.append(mappedProperty());
+    return propertyList[property];
+}
+
+//  -----------      ----------------                Sample Source Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Names of recorded properties
+ *
+ * @code {.c++}
+ * SessionFile::properties()
+ * @endcode
+ */
+QStringList SessionFile::properties() const
+{
+    QStringList names;
+    for (int i = 0; i < propertyList.size(); i++)
+    {
+        if (!propertyList[i].blocks.isEmpty())
+            names.append(propertyList[i].name);
+    }
+    return names;
+}
+
+/**
+ * @brief Key range of the property
+ *
+ * Taken from the index, no sample is read.
+ *
+ * @code {.c++}
+ * SessionFile::keyRange(const QString &property)
+ * @endcode
+ */
+QCPRange SessionFile::keyRange(const QString &property) const
+{
+    int index = propertyLookup.value(property, -1);
+    if (index < 0 || propertyList[index].blocks.isEmpty())
+        return QCPRange();
+    return QCPRange(propertyList[index].blocks.first().firstKey, propertyList[index].blocks.last().lastKey);
+}
+
+/**
+ * @brief Load samples of visible range
+ *
+ * Finds the blocks overlapping the range with binary search on the index.
+ * If the range has more samples than maxPoints, samples are decimated. Blocks
+ * falling into a single bucket are added using their summary, so their pages are never read.
+ * One sample before and after the range is added for continuous lines.
+ *
+ * @code {.c++}
+ * SessionFile::loadRange(const QString &property, double lower, double upper, int maxPoints)
+ * @endcode
+ */
+QVector<QCPGraphData> SessionFile::loadRange(const QString &property, double lower, double upper, int maxPoints)
+{
+    QVector<QCPGraphData> result;
+    int index = propertyLookup.value(property, -1);
+    if (index < 0)
+        return result;
+
+    const QVector<mappedBlock> &blocks = propertyList[index].blocks;
+
+    // blocks overlapping [lower, upper] -> [first, last)
+    int first = std::lower_bound(blocks.constBegin(), blocks.constEnd(), lower, [](const mappedBlock &block, double key) { return block.lastKey < key; }) - blocks.constBegin();
+    int last = std::upper_bound(blocks.constBegin(), blocks.constEnd(), upper, [](double key, const mappedBlock &block) { return key < block.firstKey; }) - blocks.constBegin();
+
+    qint64 inRange = 0;
+    for (int b = first; b < last; b++)
+        inRange += blocks[b].count;
+
+    // sample before the range
+    if (first < blocks.size())
+    {
+        const mappedBlock &block = blocks[first];
+        int start = std::lower_bound(block.keys, block.keys + block.count, lower) - block.keys;
+        if (start > 0)
+            result.append(QCPGraphData(block.keys[start - 1], block.values[start - 1]));
+        else if (first > 0)
+            result.append(QCPGraphData(blocks[first - 1].keys[blocks[first - 1].count - 1], blocks[first - 1].values[blocks[first - 1].count - 1]));
+    }
+    else if (!blocks.isEmpty()) // whole range is after the last sample
+    {
+        result.append(QCPGraphData(blocks.last().keys[blocks.last().count - 1], blocks.last().values[blocks.last().count - 1]));
+    }
+
+    if (inRange > maxPoints) // decimated
+    {
+        MinMaxDecimator decimator(lower, upper, maxPoints / 2, &result);
+        for (int b = first; b < last; b++)
+        {
+            const mappedBlock &block = blocks[b];
+            if (block.firstKey >= lower && block.lastKey <= upper && decimator.bucketOf(block.firstKey) == decimator.bucketOf(block.lastKey))
+            {
+                decimator.addSummary(block.firstKey, block.lastKey, block.minValue, block.maxValue);
+                continue;
+            }
+
+            int start = std::lower_bound(block.keys, block.keys + block.count, lower) - block.keys;
+            for (int i = start; i < block.count && block.keys[i] <= upper; i++)
+                decimator.add(block.keys[i], block.values[i]);
+        }
+        decimator.finish();
+    }
+    else // every sample
+    {
+        result.reserve(result.size() + inRange + 1);
+        for (int b = first; b < last; b++)
+        {
+            const mappedBlock &block = blocks[b];
+            int start = std::lower_bound(block.keys, block.keys + block.count, lower) - block.keys;
+            for (int i = start; i < block.count && block.keys[i] <= upper; i++)
+                result.append(QCPGraphData(block.keys[i], block.values[i]));
+        }
+    }
+
+    // sample after the range
+    if (last > 0)
+    {
+        const mappedBlock &block = blocks[last - 1];
+        int end = std::upper_bound(block.keys, block.keys + block.count, upper) - block.keys;
+        if (end < block.count)
+            result.append(QCPGraphData(block.keys[end], block.values[end]));
+        else if (last < blocks.size())
+            result.append(QCPGraphData(blocks[last].keys[0], blocks[last].values[0]));
+    }
+    else if (!blocks.isEmpty()) // whole range is before the first sample
+    {
+        result.append(QCPGraphData(blocks.first().keys[0], blocks.first().values[0]));
+    }
+
+    return result;
+}
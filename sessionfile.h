@@ -0,0 +1,137 @@
+#ifndef SESSIONFILE_H
+#define SESSIONFILE_H
+
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "samplesource.h"
+#include "telemetrystore.h"
+#include "telemetrybus.h"
+
+/*
+ * Native session file (*.aibs).
+ *
+ * Append only file written while receiving data, opened later with QFile::map
+ * so only the pages of the plotted range are read from disk.
+ * Numbers are stored in native byte order (little endian on supported hosts),
+ * all records are 8 byte aligned so columns can be used directly from the mapping.
+ *
+ *   header  : "AIBSES01"
+ *   records : 16 byte record header -> u32 type, u32 property, u32 count, u32 reserved
+ *             type 1 (name)  : property name, count bytes utf8, padded to 8 bytes
+ *             type 2 (block) : f64 keys[count] followed by f64 values[count]
+ *             type 3 (index) : written once at close, count = number of properties
+ *                              per property : u32 nameBytes, u32 blockCount, name padded to 8 bytes,
+ *                              per block    : u64 offset, u32 count, u32 reserved,
+ *                                             f64 firstKey, f64 lastKey, f64 minValue, f64 maxValue
+ *   trailer : u64 index offset, "AIBSEND1"
+ *
+ * Files without trailer (client closed unexpectedly) are recovered by scanning the records.
+ */
+
+// ---- Record types of the session file ---- //
+enum sessionRecordType
+{
+    sessionNameRecord = 1,
+    sessionBlockRecord = 2,
+    sessionIndexRecord = 3
+};
+
+/*
+ * Writes telemetry store to session file while data is received.
+ * Each chunk of the store is written as one block as soon as it is full.
+ * Subscribed to every property on the telemetry bus.
+ */
+class SessionWriter : public TelemetrySubscriber
+{
+public:
+    SessionWriter(TelemetryStore *store);
+    ~SessionWriter();
+
+    bool open(const QString &path);
+    void sampleAppended(int series); // called after each append, writes full chunks
+    void close();                    // writes remaining samples and the index
+
+    void deliver(const QVector<telemetrySample> &samples) override; // samples are already in the store
+
+private:
+    // -> index entry of a written block
+    struct writtenBlock
+    {
+        quint64 offset;
+        quint32 count;
+        double firstKey;
+        double lastKey;
+        double minValue;
+        double maxValue;
+    };
+
+    // -> write state of a series
+    struct writtenSeries
+    {
+        QString name;
+        int writtenSamples = 0;
+        QVector<writtenBlock> blocks;
+    };
+
+    void writeHeader(quint32 type, quint32 property, quint32 count);
+    void writePadded(const QByteArray &data);
+    void writeSamples(int series, const sampleChunk *chunk, int from, int count);
+
+    TelemetryStore *sourceStore;
+    QFile file;
+    QVector<writtenSeries> written;
+};
+
+/*
+ * Read only access to a session file through memory mapping.
+ */
+class SessionFile : public SampleSource
+{
+public:
+    SessionFile();
+    ~SessionFile();
+
+    bool open(const QString &path); // maps the file and reads the index
+
+    QStringList properties() const override;
+    QCPRange keyRange(const QString &property) const override;
+    QVector<QCPGraphData> loadRange(const QString &property, double lower, double upper, int maxPoints) override;
+
+private:
+    // -> block of samples inside the mapping
+    struct mappedBlock
+    {
+        const double *keys;
+        const double *values;
+        int count;
+        double firstKey;
+        double lastKey;
+        double minValue;
+        double maxValue;
+    };
+
+    // -> blocks of a property in key order
+    struct mappedProperty
+    {
+        QString name;
+        qint64 sampleCount = 0;
+        QVector<mappedBlock> blocks;
+    };
+
+    bool readIndex(quint64 indexOffset); // uses index written at close
+    bool scanRecords();                  // recovery for files without index
+    bool addBlock(int property, quint64 offset, int count, bool summary, double firstKey, double lastKey, double minValue, double maxValue);
+    mappedProperty &propertyAt(int property);
+
+    QFile file;
+    uchar *mapped = nullptr;
+    qint64 mappedSize = 0;
+
+    QVector<mappedProperty> propertyList;
+    QHash<QString, int> propertyLookup;
+};
+
+#endif // SESSIONFILE_H
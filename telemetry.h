@@ -0,0 +1,20 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <QString>
+#include <QDateTime>
+
+// ---- Definitions shared by all telemetry users ---- //
+
+#define DateFormat "yyyy-MMM-dd-hh:mm:ss" ///< Time Date format to sort timestamp
+
+/*
+ * Converts server timestamp (<date>-<time>) into plotting key.
+ * Key is seconds since epoch, same as used on the time axis of the plots.
+ */
+inline double timeKeyFromString(const QString &timestamp)
+{
+    return QDateTime::fromString(timestamp, DateFormat).toSecsSinceEpoch();
+}
+
+#endif // TELEMETRY_H
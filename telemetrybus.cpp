@@ -0,0 +1,181 @@
+#include "telemetrybus.h"
+
+//  -----------      ----------------                Constructor Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Default Constructor
+ *
+ * @code {.c++}
+ * TelemetryBus::TelemetryBus()
+ * @endcode
+ */
+TelemetryBus::TelemetryBus()
+{
+}
+
+//  -----------      ----------------                Subscription Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Subscribe to a property
+ *
+ * @code {.c++}
+ * TelemetryBus::subscribe(TelemetrySubscriber *subscriber, int property)
+ * @endcode
+ */
+void TelemetryBus::subscribe(TelemetrySubscriber *subscriber, int property)
+{
+    if (property < 0)
+        return;
+
+    int slot = subscriptionOf(subscriber);
+    while (propertyTable.size() <= property) // first subscription of the property id
+    {
+        propertyTable.append(QVector<int>());
+    }
+    if (!propertyTable[property].contains(slot))
+        propertyTable[property].append(slot);
+}
+
+/**
+ * @brief Subscribe to every property
+ *
+ * @code {.c++}
+ * TelemetryBus::subscribeAll(TelemetrySubscriber *subscriber)
+ * @endcode
+ */
+void TelemetryBus::subscribeAll(TelemetrySubscriber *subscriber)
+{
+    int slot = subscriptionOf(subscriber);
+    if (!allTable.contains(slot))
+        allTable.append(slot);
+}
+
+/**
+ * @brief Remove subscriber
+ *
+ * Queued samples of the subscriber are dropped. Slot is reused by the next subscriber.
+ * Slot stays in the pending list, a running flush skips it since it has no samples.
+ *
+ * @code {.c++}
+ * TelemetryBus::unsubscribe(TelemetrySubscriber *subscriber)
+ * @endcode
+ */
+void TelemetryBus::unsubscribe(TelemetrySubscriber *subscriber)
+{
+    for (int slot = 0; slot < subscriptions.size(); slot++)
+    {
+        if (subscriptions[slot].subscriber != subscriber)
+            continue;
+
+        allTable.removeAll(slot);
+        for (int i = 0; i < propertyTable.size(); i++)
+            propertyTable[i].removeAll(slot);
+
+        subscriptions[slot].subscriber = nullptr;
+        subscriptions[slot].pending.resize(0);
+    }
+}
+
+/**
+ * @brief Slot of the subscriber
+ *
+ * @code {.c++}
+ * TelemetryBus::subscriptionOf(TelemetrySubscriber *subscriber)
+ * @endcode
+ */
+int TelemetryBus::subscriptionOf(TelemetrySubscriber *subscriber)
+{
+    int freeSlot = -1;
+    for (int slot = 0; slot < subscriptions.size(); slot++)
+    {
+        if (subscriptions[slot].subscriber == subscriber)
+            return slot;
+        if (subscriptions[slot].subscriber == nullptr && freeSlot < 0)
+            freeSlot = slot;
+    }
+
+    if (freeSlot < 0) // no free slot -> new one
+    {
+        subscriptions.append(subscription());
+        freeSlot = subscriptions.size() - 1;
+    }
+    subscriptions[freeSlot].subscriber = subscriber;
+    return freeSlot;
+}
+
+//  -----------      ----------------                Delivery Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Publish sample
+ *
+ * Sample is only queued, subscribers receive it with the next flush.
+ *
+ * @code {.c++}
+ * TelemetryBus::publish(const telemetrySample &sample)
+ * @endcode
+ */
+void TelemetryBus::publish(const telemetrySample &sample)
+{
+    for (int i = 0; i < allTable.size(); i++)
+        queue(allTable[i], sample);
+
+    if (sample.property >= 0 && sample.property < propertyTable.size())
+    {
+        const QVector<int> &targets = propertyTable.at(sample.property);
+        for (int i = 0; i < targets.size(); i++)
+            queue(targets[i], sample);
+    }
+}
+
+/**
+ * @brief Queue sample for a subscriber
+ *
+ * Batch vectors keep their capacity between batches.
+ *
+ * @code {.c++}
+ * TelemetryBus::queue(int slot, const telemetrySample &sample)
+ * @endcode
+ */
+void TelemetryBus::queue(int slot, const telemetrySample &sample)
+{
+    QVector<telemetrySample> &pending = subscriptions[slot].pending;
+    if (pending.isEmpty()) // first sample of the batch
+        pendingSlots.append(slot);
+    pending.append(sample);
+}
+
+/**
+ * @brief Deliver queued batches
+ *
+ * Called once after each receive batch. Subscribers may publish, subscribe or
+ * unsubscribe while receiving their batch: pending slots are swapped out before
+ * delivering and every batch is moved out of its slot, so nothing iterated or delivered
+ * here is changed by them. Unsubscribed slots are skipped, samples queued for a slot
+ * after its batch was moved out are delivered with the next flush.
+ *
+ * @code {.c++}
+ * TelemetryBus::flush()
+ * @endcode
+ */
+void TelemetryBus::flush()
+{
+    QVector<int> delivering;
+    delivering.swap(pendingSlots);
+    for (int i = 0; i < delivering.size(); i++)
+    {
+        int slot = delivering[i];
+        TelemetrySubscriber *subscriber = subscriptions[slot].subscriber;
+        if (subscriber == nullptr || subscriptions[slot].pending.isEmpty()) // unsubscribed or already delivered
+            continue;
+
+        QVector<telemetrySample> batch;
+        batch.swap(subscriptions[slot].pending);
+        subscriber->deliver(batch);
+        batch.resize(0);
+        if (subscriptions[slot].pending.isEmpty()) // capacity is kept for the next batch of the slot
+            subscriptions[slot].pending.swap(batch);
+    }
+    delivering.resize(0);
+    if (pendingSlots.isEmpty())
+        pendingSlots.swap(delivering);
+}
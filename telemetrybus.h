@@ -0,0 +1,68 @@
+#ifndef TELEMETRYBUS_H
+#define TELEMETRYBUS_H
+
+#include <QVector>
+
+// -> received sample published on the bus
+struct telemetrySample
+{
+public:
+    telemetrySample() {}
+    telemetrySample(int prop, double k, double v, int ln) : property(prop), key(k), value(v), line(ln) {}
+
+    int property = -1; // property registry id
+    double key = 0;    // time, seconds since epoch
+    double value = 0;  // numeric value
+    int line = -1;     // index of the received line in the log store
+};
+
+/*
+ * Interface of the bus consumers.
+ * Samples are delivered in batches on the ui thread, in receive order.
+ */
+class TelemetrySubscriber
+{
+public:
+    virtual ~TelemetrySubscriber() {}
+
+    virtual void deliver(const QVector<telemetrySample> &samples) = 0;
+};
+
+/*
+ * In process publish / subscribe bus between ingest and its consumers.
+ *
+ * Subscribers register for property ids or for every property. Published samples
+ * are queued per subscriber and delivered with one call per receive batch, so
+ * a subscriber only ever sees the properties it asked for.
+ * Only used from the ui thread.
+ */
+class TelemetryBus
+{
+public:
+    TelemetryBus();
+
+    void subscribe(TelemetrySubscriber *subscriber, int property); // samples of one property
+    void subscribeAll(TelemetrySubscriber *subscriber);            // samples of every property
+    void unsubscribe(TelemetrySubscriber *subscriber);             // removes every subscription, safe while delivering
+
+    void publish(const telemetrySample &sample); // queues sample for matching subscribers
+    void flush();                                // delivers queued batches
+
+private:
+    // -> state of a subscriber
+    struct subscription
+    {
+        TelemetrySubscriber *subscriber = nullptr; // nullptr -> free slot
+        QVector<telemetrySample> pending;          // samples of the current batch
+    };
+
+    int subscriptionOf(TelemetrySubscriber *subscriber); // slot of the subscriber, created if not exists
+    void queue(int slot, const telemetrySample &sample);
+
+    QVector<subscription> subscriptions;
+    QVector<QVector<int>> propertyTable; // property id -> subscriber slots
+    QVector<int> allTable;               // slots receiving every property
+    QVector<int> pendingSlots;           // slots with queued samples
+};
+
+#endif // TELEMETRYBUS_H
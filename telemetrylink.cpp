@@ -0,0 +1,520 @@
+#include "telemetrylink.h"
+#include "logstore.h"
+#include "propertyregistry.h"
+
+#include <QHostAddress>
+
+// ---- Definitions ---- //
+
+#define LinkLineSize 65536      ///< Size of the reused receive buffer, longer lines are split
+#define LinkReconnectMin 500    ///< First reconnect delay in ms, doubled after each failed attempt
+#define LinkReconnectMax 30000  ///< Longest reconnect delay in ms
+
+/**
+ * @brief Case insensitive search for "error"
+ *
+ * Used to mark unknown packages reported as errors without creating a string.
+ */
+static bool containsError(const char *text, int length)
+{
+    for (int i = 0; i + 5 <= length; i++)
+    {
+        if (qstrnicmp(text + i, "error", 5) == 0)
+            return true;
+    }
+    return false;
+}
+
+//  -----------      ----------------                Constructor Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Constructor
+ *
+ * Link is created on the ui thread and moved to its own thread, socket is created by start.
+ *
+ * @code {.c++}
+ * TelemetryLink::TelemetryLink(int id, const QString &host, quint16 port, const QString &prefix, int timeout, TelemetryStore *store)
+ * @endcode
+ */
+TelemetryLink::TelemetryLink(int id, const QString &host, quint16 port, const QString &prefix, int timeout, TelemetryStore *store)
+    : linkId(id), targetHost(host), targetPort(port), namePrefix(prefix), targetStore(store), connectTimeout(timeout)
+{
+    if (!namePrefix.isEmpty())
+        prefixBytes = namePrefix.toUtf8() + ':';
+
+    receiveBuffer.resize(LinkLineSize);
+    pending.link = linkId;
+}
+
+/**
+ * @brief Id of the link
+ *
+ * @code {.c++}
+ * TelemetryLink::id()
+ * @endcode
+ */
+int TelemetryLink::id() const
+{
+    return linkId;
+}
+
+/**
+ * @brief Namespace of the link
+ *
+ * @code {.c++}
+ * TelemetryLink::prefix()
+ * @endcode
+ */
+QString TelemetryLink::prefix() const
+{
+    return namePrefix;
+}
+
+/**
+ * @brief Description shown on the links list
+ *
+ * @code {.c++}
+ * TelemetryLink::description()
+ * @endcode
+ */
+QString TelemetryLink::description() const
+{
+    QString name = namePrefix.isEmpty() ? QString("(default)") : namePrefix;
+    return name + "  " + targetHost + ":" + QString::number(targetPort);
+}
+
+/**
+ * @brief Set socket options
+ *
+ * Options are applied to the socket of each connection, so they must be set before the link is started.
+ *
+ * @code {.c++}
+ * TelemetryLink::setOptions(const linkOptions &options)
+ * @endcode
+ */
+void TelemetryLink::setOptions(const linkOptions &options)
+{
+    socketOptions = options;
+}
+
+//  -----------      ----------------                Connection Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Connect to the server
+ *
+ * Runs on the link thread. Socket and timers are created here so they belong to the link thread,
+ * nothing waits for the server, result is reported by the socket signals or the connect timer.
+ *
+ * @code {.c++}
+ * TelemetryLink::start()
+ * @endcode
+ */
+void TelemetryLink::start()
+{
+    socket = new QTcpSocket(this); // read buffer stays unlimited, a full buffer without line end would stop reading
+    connect(socket, SIGNAL(connected()), this, SLOT(onConnected()));
+    connect(socket, SIGNAL(errorOccurred(QAbstractSocket::SocketError)), this, SLOT(onSocketError(QAbstractSocket::SocketError)));
+    connect(socket, SIGNAL(disconnected()), this, SLOT(onDisconnected()));
+    connect(socket, SIGNAL(readyRead()), this, SLOT(onReadyRead()));
+
+    channel = new CommandChannel(linkId, socket, this);
+    connect(channel, SIGNAL(commandFinished(commandResult)), this, SIGNAL(commandFinished(commandResult)));
+
+    connectTimer = new QTimer(this);
+    connectTimer->setSingleShot(true);
+    connect(connectTimer, SIGNAL(timeout()), this, SLOT(onConnectTimeout()));
+
+    reconnectTimer = new QTimer(this);
+    reconnectTimer->setSingleShot(true);
+    connect(reconnectTimer, SIGNAL(timeout()), this, SLOT(reconnect()));
+
+    beginConnect();
+}
+
+/**
+ * @brief Start connect attempt
+ *
+ * @code {.c++}
+ * TelemetryLink::beginConnect()
+ * @endcode
+ */
+void TelemetryLink::beginConnect()
+{
+    state = linkConnecting;
+    socket->abort(); // leftovers of the previous connection
+    connectTimer->start(connectTimeout);
+    socket->connectToHost(QHostAddress(targetHost), targetPort);
+}
+
+/**
+ * @brief Server accepted the connection
+ *
+ * After a reconnect, subscriptions are sent again in the order they were sent first,
+ * so the server sends the same properties as before the connection was lost.
+ *
+ * @code {.c++}
+ * TelemetryLink::onConnected()
+ * @endcode
+ */
+void TelemetryLink::onConnected()
+{
+    if (state != linkConnecting)
+        return;
+
+    connectTimer->stop();
+    state = linkConnected;
+    reconnectAttempt = 0;
+    applyOptions();
+
+    if (wasConnected) // subscriptions are written before the commands queued while disconnected
+    {
+        for (int i = subscriptions.size() - 1; i >= 0; i--)
+            channel->enqueue(subscriptions[i], -1, true);
+    }
+    wasConnected = true;
+    channel->setConnected(true);
+    emit connected(linkId);
+}
+
+/**
+ * @brief Apply socket options
+ *
+ * Options are set on the socket descriptor, which exists only after connecting.
+ * Without low delay option, a command written while the previous segment is not acked yet
+ * waits for the ack of the server (up to the delayed ack time of the server).
+ *
+ * @code {.c++}
+ * TelemetryLink::applyOptions()
+ * @endcode
+ */
+void TelemetryLink::applyOptions()
+{
+    socket->setSocketOption(QAbstractSocket::LowDelayOption, socketOptions.lowDelay ? 1 : 0);
+    socket->setSocketOption(QAbstractSocket::KeepAliveOption, socketOptions.keepAlive ? 1 : 0);
+    if (socketOptions.receiveBuffer > 0)
+        socket->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, socketOptions.receiveBuffer);
+    if (socketOptions.sendBuffer > 0)
+        socket->setSocketOption(QAbstractSocket::SendBufferSizeSocketOption, socketOptions.sendBuffer);
+}
+
+/**
+ * @brief Socket error
+ *
+ * Only errors of a connect attempt are handled here, lost connections are handled by onDisconnected.
+ *
+ * @code {.c++}
+ * TelemetryLink::onSocketError(QAbstractSocket::SocketError error)
+ * @endcode
+ */
+void TelemetryLink::onSocketError(QAbstractSocket::SocketError error)
+{
+    Q_UNUSED(error);
+    if (state == linkConnecting)
+        connectFailed(socket->errorString());
+}
+
+/**
+ * @brief Connect timer expired
+ *
+ * @code {.c++}
+ * TelemetryLink::onConnectTimeout()
+ * @endcode
+ */
+void TelemetryLink::onConnectTimeout()
+{
+    if (state != linkConnecting)
+        return;
+
+    socket->abort();
+    connectFailed("Server did not answer in " + QString::number(connectTimeout / 1000.0) + " s");
+}
+
+/**
+ * @brief Connect attempt failed
+ *
+ * First connection is not retried, the owner removes the link.
+ *
+ * @code {.c++}
+ * TelemetryLink::connectFailed(const QString &message)
+ * @endcode
+ */
+void TelemetryLink::connectFailed(const QString &message)
+{
+    connectTimer->stop();
+    if (wasConnected)
+    {
+        scheduleReconnect();
+        return;
+    }
+
+    state = linkClosed;
+    emit connectionFailed(linkId, message);
+}
+
+/**
+ * @brief Close the connection
+ *
+ * Also cancels a running connect attempt or reconnect delay.
+ *
+ * @code {.c++}
+ * TelemetryLink::stop()
+ * @endcode
+ */
+void TelemetryLink::stop()
+{
+    state = linkClosed;
+    if (connectTimer != nullptr)
+        connectTimer->stop();
+    if (reconnectTimer != nullptr)
+        reconnectTimer->stop();
+
+    if (socket != nullptr)
+    {
+        socket->disconnect(this); // no signals while closing on purpose
+        socket->abort();
+        channel->setConnected(false);
+    }
+    emit disconnected(linkId);
+}
+
+/**
+ * @brief Connection lost
+ *
+ * Lines received before the connection was lost are already sent to the ui.
+ *
+ * @code {.c++}
+ * TelemetryLink::onDisconnected()
+ * @endcode
+ */
+void TelemetryLink::onDisconnected()
+{
+    if (state != linkConnected)
+        return;
+
+    channel->setConnected(false); // acks of commands in flight are lost
+    reconnectAttempt = 0;
+    scheduleReconnect();
+}
+
+/**
+ * @brief Start backoff timer
+ *
+ * Delay is doubled after every failed attempt up to LinkReconnectMax.
+ *
+ * @code {.c++}
+ * TelemetryLink::scheduleReconnect()
+ * @endcode
+ */
+void TelemetryLink::scheduleReconnect()
+{
+    int delay = LinkReconnectMax;
+    if (reconnectAttempt < 16 && (LinkReconnectMin << reconnectAttempt) < LinkReconnectMax)
+        delay = LinkReconnectMin << reconnectAttempt;
+
+    reconnectAttempt++;
+    state = linkWaiting;
+    emit reconnecting(linkId, reconnectAttempt, delay);
+    reconnectTimer->start(delay);
+}
+
+/**
+ * @brief Reconnect attempt
+ *
+ * @code {.c++}
+ * TelemetryLink::reconnect()
+ * @endcode
+ */
+void TelemetryLink::reconnect()
+{
+    if (state != linkWaiting)
+        return;
+
+    beginConnect();
+}
+
+/**
+ * @brief Send command to the server
+ *
+ * Command is queued on the command channel and written without waiting for previous acks.
+ * Tag is returned with the result, so senders can match their own commands.
+ *
+ * @code {.c++}
+ * TelemetryLink::sendCommand(QByteArray command, int tag)
+ * @endcode
+ */
+void TelemetryLink::sendCommand(QByteArray command, int tag)
+{
+    trackCommand(command);
+    if (channel != nullptr)
+        channel->enqueue(command, tag);
+}
+
+/**
+ * @brief Keep subscriptions
+ *
+ * "sub <property>" commands are kept until the matching "unsub <property>" is sent.
+ *
+ * @code {.c++}
+ * TelemetryLink::trackCommand(const QByteArray &command)
+ * @endcode
+ */
+void TelemetryLink::trackCommand(const QByteArray &command)
+{
+    QByteArray trimmed = command.simplified();
+    if (trimmed.startsWith("sub "))
+    {
+        QByteArray line = trimmed + " \n";
+        if (!subscriptions.contains(line))
+            subscriptions.append(line);
+    }
+    else if (trimmed.startsWith("unsub "))
+    {
+        subscriptions.removeAll(trimmed.mid(2) + " \n"); // same property without "un"
+    }
+}
+
+//  -----------      ----------------                Ingest Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Read received lines
+ *
+ * Every complete line received so far is processed, then lines are sent to the
+ * ui thread as one batch. Samples are already in the store when the batch arrives.
+ *
+ * @code {.c++}
+ * TelemetryLink::onReadyRead()
+ * @endcode
+ */
+void TelemetryLink::onReadyRead()
+{
+    if (state != linkConnected)
+        return;
+
+    while (socket->canReadLine()) // every complete line received so far
+    {
+        qint64 length = socket->readLine(receiveBuffer.data(), receiveBuffer.size()); // reads into the reused buffer
+        if (length <= 0)
+            break;
+        ingestLine(receiveBuffer.constData(), (int)length);
+    }
+
+    if (pending.entries.isEmpty())
+        return;
+
+    emit batchReady(pending);
+    pending = ingestBatch(); // sent batch is shared with the ui thread -> start a new one
+    pending.link = linkId;
+}
+
+/**
+ * @brief Process a received line
+ *
+ * Line is copied into the pending batch with the namespace inserted in front of the
+ * property name, so log, database and views see the same name as the store.
+ *
+ * @code {.c++}
+ * TelemetryLink::ingestLine(const char *line, int length)
+ * @endcode
+ */
+void TelemetryLink::ingestLine(const char *line, int length)
+{
+    while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r')) // line end is not stored
+    {
+        length--;
+    }
+
+    TelemetryParser::tokenize(line, length, &record);
+
+    ingestEntry entry;
+    entry.offset = pending.text.size();
+
+    qint64 sequence = -1;
+    if (record.count >= 4) // every server line starts with <date> <time> <sequence>
+    {
+        entry.key = parser.timeKey(record.tokens[0], record.lengths[0], record.tokens[1], record.lengths[1]);
+        sequence = checkSequence(record, entry.key);
+    }
+
+    if (record.count == 6) // Check if data package fits for package with property value
+    {
+        int nameOffset = record.tokens[4] - line;
+        pending.text.append(line, nameOffset);
+        pending.text.append(prefixBytes);
+        pending.text.append(line + nameOffset, length - nameOffset);
+
+        entry.length = length + prefixBytes.size();
+        entry.severity = logTelemetry;
+        entry.property = PropertyRegistry::instance().intern(pending.text.constData() + entry.offset + nameOffset, prefixBytes.size() + record.lengths[4]);
+        entry.value = TelemetryParser::parseDecimal(record.tokens[5], record.lengths[5]);
+
+        if (targetStore->claim(entry.property, writerLink))
+        {
+            targetStore->append(entry.property, entry.key, entry.value); // add numeric sample to the store
+        }
+        else // name is computed by a derived channel -> sample is refused, line is kept and marked
+        {
+            entry.severity = logError;
+            entry.property = NoProperty;
+        }
+    }
+    else
+    {
+        pending.text.append(line, length);
+        entry.length = length;
+        entry.property = NoProperty;
+
+        if (record.count == 4) // if package is just ack response -> matched to the oldest command in flight
+        {
+            entry.severity = logResponse;
+            channel->acknowledge(record.token(3), sequence);
+        }
+        else // unknown package -> errors reported by server are marked to be found easily
+            entry.severity = containsError(line, length) ? logError : logInfo;
+    }
+
+    pending.entries.append(entry);
+}
+
+/**
+ * @brief Check sequence number of the line
+ *
+ * Missing numbers between the last and current line are marked as a gap in the store.
+ * A smaller number than the last one means the server was restarted, it is not a gap.
+ * Returns -1 if the line has no sequence number.
+ *
+ * @code {.c++}
+ * TelemetryLink::checkSequence(const telemetryRecord &record, double key)
+ * @endcode
+ */
+qint64 TelemetryLink::checkSequence(const telemetryRecord &record, double key)
+{
+    const char *text = record.tokens[2];
+    int length = record.lengths[2];
+    if (length == 0 || length > 18)
+        return -1;
+
+    qint64 sequence = 0;
+    for (int i = 0; i < length; i++)
+    {
+        if (text[i] < '0' || text[i] > '9') // not a sequence number
+            return -1;
+        sequence = sequence * 10 + (text[i] - '0');
+    }
+
+    if (lastSequence >= 0 && sequence > lastSequence + 1)
+    {
+        telemetryGap gap;
+        gap.fromKey = lastKey;
+        gap.toKey = key;
+        gap.lost = sequence - lastSequence - 1;
+        gap.prefix = namePrefix;
+        targetStore->addGap(gap);
+
+        lostLines += gap.lost;
+        emit sequenceGap(linkId, gap.lost, lostLines);
+    }
+
+    lastSequence = sequence;
+    lastKey = key;
+    return sequence;
+}
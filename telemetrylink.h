@@ -0,0 +1,143 @@
+#ifndef TELEMETRYLINK_H
+#define TELEMETRYLINK_H
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QList>
+#include "telemetrystore.h"
+#include "telemetryparser.h"
+#include "propertyregistry.h"
+#include "commandchannel.h"
+
+// ---- Connection states of a link ---- //
+enum linkState
+{
+    linkIdle = 0,       // not started yet
+    linkConnecting = 1, // waiting for the server, connect timer running
+    linkConnected = 2,  // receiving lines
+    linkWaiting = 3,    // connection lost, waiting for the next reconnect attempt
+    linkClosed = 4      // stopped by user or first connection failed
+};
+
+// -> socket options of a link, set before the link is started
+struct linkOptions
+{
+public:
+    bool lowDelay = true;  // TCP_NODELAY -> small commands are not held back by Nagle's algorithm
+    bool keepAlive = true; // dead connections are noticed while no telemetry is received
+    int receiveBuffer = 0; // bytes, kernel receive buffer of the socket, 0 -> system default
+    int sendBuffer = 0;    // bytes, socket send buffer, 0 -> system default
+};
+
+// -> line of an ingest batch, text is inside the batch text
+struct ingestEntry
+{
+public:
+    int offset = 0;            // first byte of the line in the batch text
+    int length = 0;            // bytes of the line, line end is not stored
+    int severity = 0;          // logSeverity of the line
+    int property = NoProperty; // property id, NoProperty if line is not a telemetry line
+    double key = 0;            // time key of telemetry lines
+    double value = 0;          // numeric value of telemetry lines
+};
+
+// -> lines received by a link since the last batch, sent to the ui thread at once
+struct ingestBatch
+{
+public:
+    int link = -1;
+    QByteArray text;              // lines of the batch, property names already prefixed
+    QVector<ingestEntry> entries; // one entry per line
+};
+Q_DECLARE_METATYPE(ingestBatch)
+
+/*
+ * Connection to a single EGSE server.
+ *
+ * Each link lives on its own thread. Lines are read, split and parsed there, samples
+ * are appended to the shared telemetry store directly. Ui thread only receives one
+ * batch per read with the text of the lines for the log, console and views.
+ * Property names of the link are prefixed with its namespace ("psu1:" + name),
+ * so every property of the store has a single writer.
+ *
+ * Connection is established without blocking, driven by the socket signals and a connect
+ * timer. When an established connection is lost, link reconnects with increasing delay and
+ * sends the subscriptions again. Sequence numbers of the received lines are checked,
+ * missing ones are marked as gaps in the store.
+ */
+class TelemetryLink : public QObject
+{
+    Q_OBJECT
+
+public:
+    TelemetryLink(int id, const QString &host, quint16 port, const QString &prefix, int timeout, TelemetryStore *store); // moved to its thread by the owner
+
+    int id() const;
+    QString prefix() const;
+    QString description() const; // "prefix  host:port" shown on the links list
+    void setOptions(const linkOptions &options); // called before the link thread is started
+
+public slots:
+    void start();                         // starts connecting on the link thread, emits connected or connectionFailed
+    void stop();                          // cancels connecting, closes the socket and stops reconnecting, emits disconnected
+    void sendCommand(QByteArray command, int tag = -1); // queues command on the command channel, sub commands are kept for reconnect
+
+signals:
+    void connected(int link);
+    void connectionFailed(int link, QString message);
+    void disconnected(int link);
+    void reconnecting(int link, int attempt, int delay); // connection lost, next attempt after delay ms
+    void sequenceGap(int link, qint64 lost, qint64 totalLost); // lines missing before the last received one
+    void batchReady(ingestBatch batch);                  // lines received by a read
+    void commandFinished(commandResult result);          // ack received or command failed
+
+private slots:
+    void onReadyRead();                                 // reads every complete line as one batch
+    void onConnected();                                 // server accepted the connection
+    void onSocketError(QAbstractSocket::SocketError error); // connect attempt failed
+    void onConnectTimeout();                            // server did not answer in time
+    void onDisconnected();                              // connection lost, reconnect is scheduled
+    void reconnect();                                   // next reconnect attempt
+
+private:
+    void beginConnect();                                // starts a connect attempt
+    void connectFailed(const QString &message);         // ends the attempt, retries if link was connected before
+    void scheduleReconnect();                           // starts the backoff timer
+    void applyOptions();                                // socket options of the connected socket
+    void trackCommand(const QByteArray &command);       // keeps sub commands sent to the server
+    qint64 checkSequence(const telemetryRecord &record, double key); // marks missing sequence numbers, returns sequence of the line
+    void ingestLine(const char *line, int length);      // parses line and adds it to the pending batch
+
+    int linkId;
+    QString targetHost;
+    quint16 targetPort;
+    QString namePrefix;     // namespace of the link, empty for the default link
+    QByteArray prefixBytes; // utf8 namespace followed by ':', empty for the default link
+
+    TelemetryStore *targetStore;
+    QTcpSocket *socket = nullptr; // created on the link thread
+    CommandChannel *channel = nullptr; // every command is written through the channel
+    QTimer *connectTimer = nullptr;
+    QTimer *reconnectTimer = nullptr;
+    int connectTimeout;            // ms waited for the server in each attempt
+    linkOptions socketOptions;
+    int reconnectAttempt = 0;
+    linkState state = linkIdle;
+    bool wasConnected = false;     // connected at least once -> failures are retried
+    QList<QByteArray> subscriptions; // sub commands, sent again after reconnect
+
+    qint64 lastSequence = -1; // sequence number of the last received line, -1 before the first one
+    double lastKey = 0;       // time key of the last received line
+    qint64 lostLines = 0;     // missing sequence numbers since start
+
+    QByteArray receiveBuffer;      // reused for every received line
+    telemetryRecord record;        // tokens of the current line
+    TelemetryParser parser;        // keeps converted hour of the timestamps
+    ingestBatch pending;           // lines of the current read
+};
+
+#endif // TELEMETRYLINK_H
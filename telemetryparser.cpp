@@ -0,0 +1,168 @@
+#include "telemetryparser.h"
+#include "telemetry.h"
+
+#include <cmath>
+#include <cstring>
+
+// ---- Definitions ---- //
+
+#define MaxMantissaDigits 18 ///< Digits collected into the integer mantissa, rest only moves the exponent
+
+/**
+ * @brief Value of two ascii digits
+ *
+ * Returns -1 if text does not start with two digits.
+ */
+static inline int twoDigits(const char *text)
+{
+    if (text[0] < '0' || text[0] > '9' || text[1] < '0' || text[1] > '9')
+        return -1;
+    return (text[0] - '0') * 10 + (text[1] - '0');
+}
+
+//  -----------      ----------------                Constructor Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Default Constructor
+ *
+ * @code {.c++}
+ * TelemetryParser::TelemetryParser()
+ * @endcode
+ */
+TelemetryParser::TelemetryParser()
+{
+}
+
+//  -----------      ----------------                Parsing Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Split line into tokens
+ *
+ * Splits at every space, empty tokens are kept so token count is the same
+ * as QString::split(" ") of the line.
+ *
+ * @code {.c++}
+ * TelemetryParser::tokenize(const char *line, int length, telemetryRecord *record)
+ * @endcode
+ */
+void TelemetryParser::tokenize(const char *line, int length, telemetryRecord *record)
+{
+    record->count = 0;
+    int start = 0;
+    for (int i = 0; i <= length; i++)
+    {
+        if (i == length || line[i] == ' ') // end of token
+        {
+            if (record->count < MaxRecordTokens)
+            {
+                record->tokens[record->count] = line + start;
+                record->lengths[record->count] = i - start;
+            }
+            record->count++;
+            start = i + 1;
+        }
+    }
+}
+
+/**
+ * @brief Parse leading number of the text
+ *
+ * Values are sent as <number>/<unit>, parsing stops at the first character
+ * which is not part of the number. Locale independent.
+ *
+ * @code {.c++}
+ * TelemetryParser::parseDecimal(const char *text, int length)
+ * @endcode
+ */
+double TelemetryParser::parseDecimal(const char *text, int length)
+{
+    int i = 0;
+    while (i < length && (text[i] == ' ' || text[i] == '\t'))
+        i++;
+
+    bool negative = false;
+    if (i < length && (text[i] == '-' || text[i] == '+'))
+    {
+        negative = text[i] == '-';
+        i++;
+    }
+
+    quint64 mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    for (; i < length && text[i] >= '0' && text[i] <= '9'; i++) // integer part
+    {
+        if (digits < MaxMantissaDigits)
+        {
+            mantissa = mantissa * 10 + (text[i] - '0');
+            digits++;
+        }
+        else
+        {
+            exponent++;
+        }
+    }
+    if (i < length && text[i] == '.') // fraction part
+    {
+        for (i++; i < length && text[i] >= '0' && text[i] <= '9'; i++)
+        {
+            if (digits < MaxMantissaDigits)
+            {
+                mantissa = mantissa * 10 + (text[i] - '0');
+                digits++;
+                exponent--;
+            }
+        }
+    }
+    if (i + 1 < length && (text[i] == 'e' || text[i] == 'E')) // exponent part
+    {
+        int j = i + 1;
+        bool negativeExponent = false;
+        if (text[j] == '-' || text[j] == '+')
+        {
+            negativeExponent = text[j] == '-';
+            j++;
+        }
+        int value = 0;
+        for (; j < length && text[j] >= '0' && text[j] <= '9' && value < 1000; j++)
+            value = value * 10 + (text[j] - '0');
+        exponent += negativeExponent ? -value : value;
+    }
+
+    double result = (double)mantissa;
+    if (exponent > 0)
+        result *= std::pow(10.0, exponent);
+    else if (exponent < 0)
+        result /= std::pow(10.0, -exponent);
+    return negative ? -result : result;
+}
+
+/**
+ * @brief Time key of the timestamp
+ *
+ * Time is parsed directly, date is only converted by QDateTime when the hour changes,
+ * so daylight saving and time zone handling stay the same as timeKeyFromString.
+ * Unexpected formats are converted by timeKeyFromString.
+ *
+ * @code {.c++}
+ * TelemetryParser::timeKey(const char *date, int dateLength, const char *time, int timeLength)
+ * @endcode
+ */
+double TelemetryParser::timeKey(const char *date, int dateLength, const char *time, int timeLength)
+{
+    int hour = (timeLength == 8 && time[2] == ':' && time[5] == ':') ? twoDigits(time) : -1;
+    int minute = hour >= 0 ? twoDigits(time + 3) : -1;
+    int second = minute >= 0 ? twoDigits(time + 6) : -1;
+
+    if (second < 0 || dateLength > (int)sizeof(cachedDate)) // unexpected format -> slow path
+        return timeKeyFromString(QString::fromUtf8(date, dateLength) + "-" + QString::fromUtf8(time, timeLength));
+
+    if (hour != cachedHour || dateLength != cachedDateLength || memcmp(date, cachedDate, dateLength) != 0) // new hour -> convert its start once
+    {
+        memcpy(cachedDate, date, dateLength);
+        cachedDateLength = dateLength;
+        cachedHour = hour;
+        cachedHourKey = timeKeyFromString(QString::fromUtf8(date, dateLength) + "-" + QString::fromUtf8(time, 2) + ":00:00");
+    }
+    return cachedHourKey + minute * 60 + second;
+}
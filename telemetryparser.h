@@ -0,0 +1,45 @@
+#ifndef TELEMETRYPARSER_H
+#define TELEMETRYPARSER_H
+
+#include <QString>
+
+// ---- Definitions ---- //
+
+#define MaxRecordTokens 8 ///< Tokens kept of a received line
+
+// -> tokens of a received line. Tokens point into the receive buffer, nothing is copied.
+struct telemetryRecord
+{
+public:
+    const char *tokens[MaxRecordTokens];
+    int lengths[MaxRecordTokens];
+    int count = 0; // number of tokens in the line, can be larger than MaxRecordTokens
+
+    QString token(int index) const { return QString::fromUtf8(tokens[index], lengths[index]); }
+};
+
+/*
+ * Parser for received lines without temporary strings.
+ *
+ * Telemetry line : <date> <time> <sequence> <note> <property> <value>
+ * Results are the same as splitting the line into QStrings and using
+ * timeKeyFromString and QString::toDouble, but nothing is allocated in steady state.
+ */
+class TelemetryParser
+{
+public:
+    TelemetryParser();
+
+    static void tokenize(const char *line, int length, telemetryRecord *record);         // splits at every space like QString::split(" ")
+    static double parseDecimal(const char *text, int length);                            // leading number of the text, 0 if none
+    double timeKey(const char *date, int dateLength, const char *time, int timeLength); // seconds since epoch, same as timeKeyFromString
+
+private:
+    // -> start of the last converted hour, date conversion is only done once an hour
+    char cachedDate[32];
+    int cachedDateLength = -1;
+    int cachedHour = -1;
+    double cachedHourKey = 0;
+};
+
+#endif // TELEMETRYPARSER_H
@@ -0,0 +1,254 @@
+#include "telemetrystatistics.h"
+
+#include <cmath>
+
+//  -----------      ----------------                Property Statistics Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Standard deviation of every sample
+ *
+ * @code {.c++}
+ * propertyStatistics::stddev()
+ * @endcode
+ */
+double propertyStatistics::stddev() const
+{
+    if (count < 2)
+        return 0;
+    return std::sqrt(m2 / (count - 1));
+}
+
+/**
+ * @brief Standard deviation of the window
+ *
+ * Removing samples may leave a tiny negative rounding error, it is treated as zero.
+ *
+ * @code {.c++}
+ * propertyStatistics::windowStddev()
+ * @endcode
+ */
+double propertyStatistics::windowStddev() const
+{
+    if (windowCount < 2 || windowM2 <= 0)
+        return 0;
+    return std::sqrt(windowM2 / (windowCount - 1));
+}
+
+/**
+ * @brief Minimum of the window
+ *
+ * @code {.c++}
+ * propertyStatistics::windowMinValue()
+ * @endcode
+ */
+double propertyStatistics::windowMinValue() const
+{
+    return windowMin.empty() ? lastValue : windowMin.front().value;
+}
+
+/**
+ * @brief Maximum of the window
+ *
+ * @code {.c++}
+ * propertyStatistics::windowMaxValue()
+ * @endcode
+ */
+double propertyStatistics::windowMaxValue() const
+{
+    return windowMax.empty() ? lastValue : windowMax.front().value;
+}
+
+/**
+ * @brief Sample rate of the window
+ *
+ * Intervals between the samples of the window over the time they cover.
+ *
+ * @code {.c++}
+ * propertyStatistics::rate()
+ * @endcode
+ */
+double propertyStatistics::rate() const
+{
+    double span = lastKey - windowFirstKey;
+    if (windowCount < 2 || span <= 0)
+        return 0;
+    return (windowCount - 1) / span;
+}
+
+//  -----------      ----------------                Constructor Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Constructor
+ *
+ * @code {.c++}
+ * TelemetryStatistics::TelemetryStatistics(TelemetryStore *store, double window)
+ * @endcode
+ */
+TelemetryStatistics::TelemetryStatistics(TelemetryStore *store, double window) : sourceStore(store), windowLength(window)
+{
+}
+
+//  -----------      ----------------                Statistics Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Statistics of the property
+ *
+ * @code {.c++}
+ * TelemetryStatistics::statistics(int property)
+ * @endcode
+ */
+const propertyStatistics *TelemetryStatistics::statistics(int property) const
+{
+    if (property < 0 || property >= propertyList.size() || propertyList[property].count == 0)
+        return nullptr;
+    return &propertyList[property];
+}
+
+/**
+ * @brief Window length in seconds
+ *
+ * @code {.c++}
+ * TelemetryStatistics::window()
+ * @endcode
+ */
+double TelemetryStatistics::window() const
+{
+    return windowLength;
+}
+
+/**
+ * @brief Receive batch from the telemetry bus
+ *
+ * Samples of a property are delivered in the order they were added to the store,
+ * so the n-th delivered sample is the n-th sample of the series.
+ *
+ * @code {.c++}
+ * TelemetryStatistics::deliver(const QVector<telemetrySample> &samples)
+ * @endcode
+ */
+void TelemetryStatistics::deliver(const QVector<telemetrySample> &samples)
+{
+    for (int i = 0; i < samples.size(); i++)
+    {
+        const telemetrySample &sample = samples.at(i);
+        if (sample.property < 0)
+            continue;
+        add(sample.property, sample.key, sample.value);
+    }
+}
+
+/**
+ * @brief Add sample to the statistics
+ *
+ * @code {.c++}
+ * TelemetryStatistics::add(int property, double key, double value)
+ * @endcode
+ */
+void TelemetryStatistics::add(int property, double key, double value)
+{
+    while (propertyList.size() <= property) // first sample of the property id
+    {
+        propertyList.append(propertyStatistics());
+        chunkCache.append(cachedChunks());
+    }
+    propertyStatistics &stats = propertyList[property];
+
+    if (stats.count == 0)
+    {
+        stats.firstKey = key;
+        stats.minValue = value;
+        stats.maxValue = value;
+        stats.lastChange = key;
+    }
+    else if (value != stats.lastValue)
+    {
+        stats.lastChange = key;
+    }
+    stats.lastKey = key;
+    stats.lastValue = value;
+
+    // running
+    stats.count++;
+    double delta = value - stats.mean;
+    stats.mean += delta / stats.count;
+    stats.m2 += delta * (value - stats.mean);
+    stats.minValue = qMin(stats.minValue, value);
+    stats.maxValue = qMax(stats.maxValue, value);
+
+    // window
+    stats.windowCount++;
+    delta = value - stats.windowMean;
+    stats.windowMean += delta / stats.windowCount;
+    stats.windowM2 += delta * (value - stats.windowMean);
+
+    while (!stats.windowMin.empty() && stats.windowMin.back().value >= value)
+        stats.windowMin.pop_back();
+    stats.windowMin.push_back(statisticsSample(key, value));
+    while (!stats.windowMax.empty() && stats.windowMax.back().value <= value)
+        stats.windowMax.pop_back();
+    stats.windowMax.push_back(statisticsSample(key, value));
+
+    expire(property, key - windowLength);
+}
+
+/**
+ * @brief Remove old samples from the window
+ *
+ * Welford's update is applied in reverse for each sample leaving the window.
+ *
+ * @code {.c++}
+ * TelemetryStatistics::expire(int property, double cutoff)
+ * @endcode
+ */
+void TelemetryStatistics::expire(int property, double cutoff)
+{
+    propertyStatistics &stats = propertyList[property];
+
+    while (stats.windowCount > 1)
+    {
+        statisticsSample oldest = storedSample(property, stats.windowFirst);
+        if (oldest.key >= cutoff)
+        {
+            stats.windowFirstKey = oldest.key;
+            break;
+        }
+
+        stats.windowFirst++;
+        stats.windowCount--;
+        double delta = oldest.value - stats.windowMean;
+        stats.windowMean -= delta / stats.windowCount;
+        stats.windowM2 -= delta * (oldest.value - stats.windowMean);
+    }
+    if (stats.windowCount == 1) // no rounding error is carried over
+    {
+        stats.windowMean = stats.lastValue;
+        stats.windowM2 = 0;
+        stats.windowFirstKey = stats.lastKey;
+    }
+
+    while (stats.windowMin.size() > 1 && stats.windowMin.front().key < cutoff)
+        stats.windowMin.pop_front();
+    while (stats.windowMax.size() > 1 && stats.windowMax.front().key < cutoff)
+        stats.windowMax.pop_front();
+}
+
+/**
+ * @brief Sample of the store by index
+ *
+ * Chunk list of the property is copied from the store only when the index is
+ * in a chunk added after the last copy, once per chunk of samples.
+ *
+ * @code {.c++}
+ * TelemetryStatistics::storedSample(int property, int index)
+ * @endcode
+ */
+statisticsSample TelemetryStatistics::storedSample(int property, int index)
+{
+    int chunkSize = TelemetryStore::chunkSize();
+    QVector<QSharedPointer<sampleChunk>> &chunks = chunkCache[property].chunks;
+    if (index / chunkSize >= chunks.size())
+        chunks = sourceStore->snapshot(property);
+
+    const sampleChunk *chunk = chunks.at(index / chunkSize).data();
+    return statisticsSample(chunk->keys[index % chunkSize], chunk->values[index % chunkSize]);
+}
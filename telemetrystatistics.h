@@ -0,0 +1,94 @@
+#ifndef TELEMETRYSTATISTICS_H
+#define TELEMETRYSTATISTICS_H
+
+#include <QSharedPointer>
+#include <QVector>
+#include <deque>
+#include "telemetrystore.h"
+#include "telemetrybus.h"
+
+// ---- Definitions ---- //
+
+#define StatisticsWindow 10.0 ///< Default length of the statistics window in seconds
+
+// -> sample kept by the window minimum and maximum queues
+struct statisticsSample
+{
+public:
+    statisticsSample() {}
+    statisticsSample(double k, double v) : key(k), value(v) {}
+
+    double key = 0;
+    double value = 0;
+};
+
+// -> running and windowed statistics of one property
+struct propertyStatistics
+{
+public:
+    // running -> every received sample
+    qint64 count = 0;
+    double mean = 0;
+    double m2 = 0; // sum of squared differences from the mean (Welford)
+    double minValue = 0;
+    double maxValue = 0;
+
+    // window -> samples of the last window seconds
+    int windowFirst = 0; // store index of the oldest sample in the window
+    int windowCount = 0;
+    double windowFirstKey = 0; // time of the oldest sample in the window
+    double windowMean = 0;
+    double windowM2 = 0;
+    std::deque<statisticsSample> windowMin; // increasing values, front is the minimum
+    std::deque<statisticsSample> windowMax; // decreasing values, front is the maximum
+
+    double firstKey = 0;   // time of the first sample
+    double lastKey = 0;    // time of the last sample
+    double lastValue = 0;  // value of the last sample
+    double lastChange = 0; // time the value last changed
+
+    double stddev() const;       // sample standard deviation of every sample
+    double windowStddev() const; // sample standard deviation of the window
+    double windowMinValue() const;
+    double windowMaxValue() const;
+    double rate() const; // samples per second in the window
+};
+
+/*
+ * Incremental statistics of every property.
+ *
+ * Mean and variance are updated with Welford's method, each sample is added once and
+ * removed once when it leaves the window, so updating is O(1) per sample. Samples leaving
+ * the window are read back from the telemetry store instead of being copied.
+ * Window minimum and maximum are kept with monotonic queues, amortized O(1) per sample.
+ * Subscribed to every property on the telemetry bus before the views, so statistics
+ * are up to date when the views receive the same batch.
+ */
+class TelemetryStatistics : public TelemetrySubscriber
+{
+public:
+    TelemetryStatistics(TelemetryStore *store, double window = StatisticsWindow);
+
+    const propertyStatistics *statistics(int property) const; // nullptr if property has no samples
+    double window() const;                                    // window length in seconds
+
+    void deliver(const QVector<telemetrySample> &samples) override; // samples are already in the store
+
+private:
+    // -> chunk list of a property, refreshed only when a sample outside of it is read
+    struct cachedChunks
+    {
+        QVector<QSharedPointer<sampleChunk>> chunks;
+    };
+
+    void add(int property, double key, double value);
+    void expire(int property, double cutoff); // removes samples older than cutoff from the window
+    statisticsSample storedSample(int property, int index); // sample of the store by index
+
+    TelemetryStore *sourceStore;
+    double windowLength;
+    QVector<propertyStatistics> propertyList; // property id -> statistics
+    QVector<cachedChunks> chunkCache;         // property id -> chunks of the store
+};
+
+#endif // TELEMETRYSTATISTICS_H
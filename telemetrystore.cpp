@@ -0,0 +1,432 @@
+#include "telemetrystore.h"
+
+#include <QMutexLocker>
+
+// ---- Definitions ---- //
+
+#define SampleChunkSize 4096 ///< Samples per storage chunk
+
+//  -----------      ----------------                Constructor Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Default Constructor
+ *
+ * @code {.c++}
+ * TelemetryStore::TelemetryStore()
+ * @endcode
+ */
+TelemetryStore::TelemetryStore()
+{
+}
+
+/**
+ * @brief Destructor
+ *
+ * Series are never removed while the store exists, they are deleted here.
+ *
+ * @code {.c++}
+ * TelemetryStore::~TelemetryStore()
+ * @endcode
+ */
+TelemetryStore::~TelemetryStore()
+{
+    for (int block = 0; block < SeriesBlockLimit; block++)
+    {
+        seriesBlock *entries = directory[block].loadAcquire();
+        if (entries == nullptr)
+            continue;
+        for (int i = 0; i < SeriesBlockSize; i++)
+            delete entries->entries[i].loadAcquire();
+        delete entries;
+    }
+}
+
+/**
+ * @brief Returns number of samples in a storage chunk
+ *
+ * @code {.c++}
+ * TelemetryStore::chunkSize()
+ * @endcode
+ */
+int TelemetryStore::chunkSize()
+{
+    return SampleChunkSize;
+}
+
+//  -----------      ----------------                Series Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Series of the property
+ *
+ * Lock free lookup, used by the writers for every sample.
+ *
+ * @code {.c++}
+ * TelemetryStore::seriesAt(int property)
+ * @endcode
+ */
+telemetrySeries *TelemetryStore::seriesAt(int property) const
+{
+    if (property < 0 || property >= SeriesBlockSize * SeriesBlockLimit)
+        return nullptr;
+
+    seriesBlock *block = directory[property / SeriesBlockSize].loadAcquire();
+    if (block == nullptr)
+        return nullptr;
+    return block->entries[property % SeriesBlockSize].loadAcquire();
+}
+
+/**
+ * @brief Create series of the property
+ *
+ * Called at the first sample of the property. Series is published after it is
+ * constructed, so lock free readers never see a half built series.
+ *
+ * @code {.c++}
+ * TelemetryStore::createSeries(int property)
+ * @endcode
+ */
+telemetrySeries *TelemetryStore::createSeries(int property)
+{
+    QMutexLocker locker(&seriesLock);
+
+    seriesBlock *block = directory[property / SeriesBlockSize].loadAcquire();
+    if (block == nullptr) // first property of the block
+    {
+        block = new seriesBlock();
+        directory[property / SeriesBlockSize].storeRelease(block);
+    }
+
+    telemetrySeries *target = block->entries[property % SeriesBlockSize].loadAcquire();
+    if (target == nullptr)
+    {
+        target = new telemetrySeries();
+        block->entries[property % SeriesBlockSize].storeRelease(target);
+    }
+
+    if (property >= seriesTotal.loadAcquire())
+        seriesTotal.storeRelease(property + 1);
+    return target;
+}
+
+/**
+ * @brief Append sample
+ *
+ * Called from ingest threads, each property is only appended by the writer which claimed it.
+ * Sample is written first and published afterwards,
+ * so readers never see half written samples. Chunk summary is updated on the fly.
+ * Lock is only taken when a series or chunk is created.
+ *
+ * @code {.c++}
+ * TelemetryStore::append(int property, double key, double value)
+ * @endcode
+ */
+void TelemetryStore::append(int property, double key, double value)
+{
+    if (property < 0 || property >= SeriesBlockSize * SeriesBlockLimit)
+        return;
+
+    telemetrySeries *target = seriesAt(property);
+    if (target == nullptr) // first sample of the property
+        target = createSeries(property);
+
+    int count = target->count.loadAcquire();
+    int inChunk = count % SampleChunkSize;
+
+    if (inChunk == 0) // current chunk is full -> create new one
+    {
+        QMutexLocker locker(&seriesLock);
+        target->chunks.append(QSharedPointer<sampleChunk>(new sampleChunk(SampleChunkSize)));
+    }
+
+    sampleChunk *chunk = target->chunks.at(target->chunks.size() - 1).data(); // chunk list is only modified by this writer
+    chunk->keys[inChunk] = key;
+    chunk->values[inChunk] = value;
+    if (inChunk == 0 || value < chunk->minValue)
+        chunk->minValue = value;
+    if (inChunk == 0 || value > chunk->maxValue)
+        chunk->maxValue = value;
+    chunk->count.storeRelease(inChunk + 1);
+
+    target->count.storeRelease(count + 1);
+}
+
+/**
+ * @brief Claim series for a writer
+ *
+ * A series has one writer, appends of two threads would break the published samples
+ * and the time order of the series. First claim owns the series, later claims of the
+ * same writer succeed, claims of other writers fail. Lock free once the series exists,
+ * called by the links for every sample.
+ *
+ * @code {.c++}
+ * TelemetryStore::claim(int property, int writer)
+ * @endcode
+ */
+bool TelemetryStore::claim(int property, int writer)
+{
+    if (property < 0 || property >= SeriesBlockSize * SeriesBlockLimit)
+        return false;
+
+    telemetrySeries *target = seriesAt(property);
+    if (target == nullptr) // series is created empty, owner is known before the first sample
+        target = createSeries(property);
+
+    int owner = target->writer.loadAcquire();
+    if (owner == writer)
+        return true;
+    return owner == writerNone && (target->writer.testAndSetOrdered(writerNone, writer) || target->writer.loadAcquire() == writer);
+}
+
+/**
+ * @brief Writer which owns the series
+ *
+ * @code {.c++}
+ * TelemetryStore::writerOf(int property)
+ * @endcode
+ */
+int TelemetryStore::writerOf(int property) const
+{
+    telemetrySeries *target = seriesAt(property);
+    if (target == nullptr)
+        return writerNone;
+    return target->writer.loadAcquire();
+}
+
+/**
+ * @brief Number of series in the store
+ *
+ * @code {.c++}
+ * TelemetryStore::seriesCount()
+ * @endcode
+ */
+int TelemetryStore::seriesCount() const
+{
+    return seriesTotal.loadAcquire();
+}
+
+/**
+ * @brief Number of samples in the series
+ *
+ * @code {.c++}
+ * TelemetryStore::sampleCount(int property)
+ * @endcode
+ */
+int TelemetryStore::sampleCount(int property) const
+{
+    telemetrySeries *target = seriesAt(property);
+    if (target == nullptr)
+        return 0;
+    return target->count.loadAcquire();
+}
+
+/**
+ * @brief Copy of chunk list of the series
+ *
+ * Readers on other threads work on this copy. Only samples below
+ * each chunk's count should be read.
+ *
+ * @code {.c++}
+ * TelemetryStore::snapshot(int property)
+ * @endcode
+ */
+QVector<QSharedPointer<sampleChunk>> TelemetryStore::snapshot(int property) const
+{
+    telemetrySeries *target = seriesAt(property);
+    if (target == nullptr)
+        return QVector<QSharedPointer<sampleChunk>>();
+
+    QMutexLocker locker(&seriesLock);
+    return target->chunks;
+}
+
+/**
+ * @brief Key range of the series
+ *
+ * Samples are appended in time order, so only the first and the last sample are read.
+ *
+ * @code {.c++}
+ * TelemetryStore::keyRange(int property, double *firstKey, double *lastKey)
+ * @endcode
+ */
+bool TelemetryStore::keyRange(int property, double *firstKey, double *lastKey) const
+{
+    int count = sampleCount(property); // count first, every counted sample is inside the snapshot
+    if (count == 0)
+        return false;
+
+    QVector<QSharedPointer<sampleChunk>> chunks = snapshot(property);
+    *firstKey = chunks.at(0)->keys[0];
+    *lastKey = chunks.at((count - 1) / SampleChunkSize)->keys[(count - 1) % SampleChunkSize];
+    return true;
+}
+
+/**
+ * @brief Value range of the samples in a key range
+ *
+ * Ends of the key range are found by binary search. Full chunks inside the range are
+ * taken from their summaries, only the partly covered chunks at the ends are scanned,
+ * so the cost does not grow with the number of samples in the range.
+ *
+ * @code {.c++}
+ * TelemetryStore::valueRange(int property, double lower, double upper, double *minValue, double *maxValue)
+ * @endcode
+ */
+bool TelemetryStore::valueRange(int property, double lower, double upper, double *minValue, double *maxValue) const
+{
+    int count = sampleCount(property);
+    if (count == 0)
+        return false;
+
+    QVector<QSharedPointer<sampleChunk>> chunks = snapshot(property);
+    auto keyAt = [&chunks](int i) { return chunks.at(i / SampleChunkSize)->keys[i % SampleChunkSize]; };
+
+    // first sample with key >= lower
+    int low = 0;
+    int high = count;
+    while (low < high)
+    {
+        int middle = (low + high) / 2;
+        if (keyAt(middle) < lower)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    int first = low;
+
+    // first sample with key > upper
+    high = count;
+    while (low < high)
+    {
+        int middle = (low + high) / 2;
+        if (keyAt(middle) <= upper)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    int end = low;
+
+    if (first >= end)
+        return false;
+
+    double minimum = chunks.at(first / SampleChunkSize)->values[first % SampleChunkSize];
+    double maximum = minimum;
+    int i = first;
+    while (i < end)
+    {
+        const sampleChunk *chunk = chunks.at(i / SampleChunkSize).data();
+        int inChunk = i % SampleChunkSize;
+        if (inChunk == 0 && i + SampleChunkSize <= end) // whole chunk inside the range -> summary is final
+        {
+            minimum = qMin(minimum, chunk->minValue);
+            maximum = qMax(maximum, chunk->maxValue);
+            i += SampleChunkSize;
+            continue;
+        }
+
+        int stop = qMin(end - (i - inChunk), SampleChunkSize);
+        for (int j = inChunk; j < stop; j++)
+        {
+            minimum = qMin(minimum, chunk->values[j]);
+            maximum = qMax(maximum, chunk->values[j]);
+        }
+        i += stop - inChunk;
+    }
+
+    *minValue = minimum;
+    *maxValue = maximum;
+    return true;
+}
+
+//  -----------      ----------------                Gap Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Mark lost lines
+ *
+ * Called by link threads when sequence numbers of received lines are not consecutive.
+ *
+ * @code {.c++}
+ * TelemetryStore::addGap(const telemetryGap &gap)
+ * @endcode
+ */
+void TelemetryStore::addGap(const telemetryGap &gap)
+{
+    QMutexLocker locker(&seriesLock);
+    gapList.append(gap);
+}
+
+/**
+ * @brief Number of marked gaps
+ *
+ * @code {.c++}
+ * TelemetryStore::gapCount()
+ * @endcode
+ */
+int TelemetryStore::gapCount() const
+{
+    QMutexLocker locker(&seriesLock);
+    return gapList.size();
+}
+
+/**
+ * @brief Copy of marked gaps
+ *
+ * Views keep the number of gaps they have shown and only ask for the new ones.
+ *
+ * @code {.c++}
+ * TelemetryStore::gaps(int from)
+ * @endcode
+ */
+QVector<telemetryGap> TelemetryStore::gaps(int from) const
+{
+    QMutexLocker locker(&seriesLock);
+    if (from <= 0)
+        return gapList;
+    return gapList.mid(from);
+}
+
+//  -----------      ----------------                Alarm Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Mark alarm state change
+ *
+ * Called by the alarm engine when a limit rule of a property changes its state.
+ *
+ * @code {.c++}
+ * TelemetryStore::addAlarm(const telemetryAlarm &alarm)
+ * @endcode
+ */
+void TelemetryStore::addAlarm(const telemetryAlarm &alarm)
+{
+    QMutexLocker locker(&seriesLock);
+    alarmList.append(alarm);
+}
+
+/**
+ * @brief Number of marked alarm changes
+ *
+ * @code {.c++}
+ * TelemetryStore::alarmCount()
+ * @endcode
+ */
+int TelemetryStore::alarmCount() const
+{
+    QMutexLocker locker(&seriesLock);
+    return alarmList.size();
+}
+
+/**
+ * @brief Copy of marked alarm changes
+ *
+ * Views keep the number of alarm changes they have shown and only ask for the new ones.
+ *
+ * @code {.c++}
+ * TelemetryStore::alarms(int from)
+ * @endcode
+ */
+QVector<telemetryAlarm> TelemetryStore::alarms(int from) const
+{
+    QMutexLocker locker(&seriesLock);
+    if (from <= 0)
+        return alarmList;
+    return alarmList.mid(from);
+}
@@ -0,0 +1,125 @@
+#ifndef TELEMETRYSTORE_H
+#define TELEMETRYSTORE_H
+
+#include <QString>
+#include <QVector>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QAtomicPointer>
+#include <QSharedPointer>
+#include <vector>
+
+// -> fixed size block of samples of one property.
+// Storage is allocated once, readers on other threads can access
+// samples below count while new samples are appended.
+struct sampleChunk
+{
+public:
+    sampleChunk(int size) : keys(size), values(size) {}
+
+    std::vector<double> keys;   // time, seconds since epoch
+    std::vector<double> values; // numeric value of the property
+    QAtomicInt count;           // number of published samples
+
+    // summary of the published samples, final once the chunk is full
+    double minValue = 0;
+    double maxValue = 0;
+};
+
+// ---- Writers of a series, a series is only appended by the kind which claimed it first ---- //
+enum seriesWriter
+{
+    writerNone = 0,   // not claimed yet
+    writerLink = 1,   // received by a link, properties of the links are separated by their namespaces
+    writerDerived = 2 // computed by the derived channels on the ui thread
+};
+
+// -> all samples of one property as columns
+struct telemetrySeries
+{
+public:
+    QVector<QSharedPointer<sampleChunk>> chunks;
+    QAtomicInt count;  // number of published samples
+    QAtomicInt writer; // seriesWriter which owns the series
+};
+
+// -> lines lost between two received lines of a link, found by sequence numbers
+struct telemetryGap
+{
+public:
+    double fromKey = 0; // time of the last line before the gap
+    double toKey = 0;   // time of the first line after the gap
+    qint64 lost = 0;    // number of missing sequence numbers
+    QString prefix;     // namespace of the link, empty for the default link
+};
+
+// -> change of the alarm state of a property, raised by the alarm engine
+struct telemetryAlarm
+{
+public:
+    double key = 0;    // time of the sample changing the state
+    int property = -1; // property registry id
+    double value = 0;  // value of the sample
+    int level = 0;     // alarmLevel after the change, 0 -> back to normal
+    QString reason;    // limit or rate which changed the state
+};
+
+// ---- Definitions ---- //
+
+#define SeriesBlockSize 256   ///< Series per directory block
+#define SeriesBlockLimit 1024 ///< Directory blocks -> property ids up to SeriesBlockSize * SeriesBlockLimit
+
+// -> block of series pointers, allocated once and never moved
+struct seriesBlock
+{
+public:
+    QAtomicPointer<telemetrySeries> entries[SeriesBlockSize];
+};
+
+/*
+ * In memory columnar store for received telemetry.
+ *
+ * Each property has its own time and value columns stored in fixed size chunks.
+ * Series are indexed by property registry id through a fixed directory, so series
+ * are found without locking. Ingest threads of several links append concurrently,
+ * each series has a single writer (properties of a link are namespaced by its prefix).
+ * Exporters and other readers on worker threads read snapshots of the chunk lists
+ * without blocking the ingest.
+ */
+class TelemetryStore
+{
+public:
+    TelemetryStore();
+    ~TelemetryStore();
+
+    void append(int property, double key, double value); // add new sample to the end of the series, series created at first sample
+    bool claim(int property, int writer);                 // false if the series is owned by another writer
+    int writerOf(int property) const;                     // writerNone if not claimed
+
+    int seriesCount() const;                               // highest property id with a series + 1
+    int sampleCount(int property) const;                   // 0 if property has no samples
+    QVector<QSharedPointer<sampleChunk>> snapshot(int property) const; // chunk list, used by readers on other threads
+    bool keyRange(int property, double *firstKey, double *lastKey) const; // first and last published key, false without samples
+    bool valueRange(int property, double lower, double upper, double *minValue, double *maxValue) const; // bounds of the samples in [lower, upper]
+    static int chunkSize();
+
+    void addGap(const telemetryGap &gap);           // marks lost lines of a link, thread safe
+    int gapCount() const;                           // number of marked gaps
+    QVector<telemetryGap> gaps(int from = 0) const; // gaps marked after the first from ones
+
+    void addAlarm(const telemetryAlarm &alarm);         // marks alarm state change, thread safe
+    int alarmCount() const;                             // number of marked alarm changes
+    QVector<telemetryAlarm> alarms(int from = 0) const; // alarm changes marked after the first from ones
+
+private:
+    telemetrySeries *seriesAt(int property) const; // nullptr if property has no samples
+    telemetrySeries *createSeries(int property);   // series of the first sample
+
+    mutable QMutex seriesLock; //-> protects series creation and chunk lists, not the samples
+    QAtomicPointer<seriesBlock> directory[SeriesBlockLimit]; // property id / SeriesBlockSize -> block
+    QAtomicInt seriesTotal;                                  // highest property id with samples + 1
+    QVector<telemetryGap> gapList;                           // in marking order, protected by seriesLock
+    QVector<telemetryAlarm> alarmList;                       // in marking order, protected by seriesLock
+};
+
+#endif // TELEMETRYSTORE_H
@@ -0,0 +1,31 @@
+#-------------------------------------------------
+#
+# Allocation counting test of the ingest path.
+# Build and run with: qmake && make check
+#
+#-------------------------------------------------
+
+QT       += core testlib
+QT       -= gui
+
+TARGET = tst_allocations
+TEMPLATE = app
+
+CONFIG += console c++11 testcase
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+        tst_allocations.cpp \
+    ../../telemetryparser.cpp \
+    ../../propertyregistry.cpp \
+    ../../telemetrystore.cpp
+
+HEADERS += \
+    ../../telemetry.h \
+    ../../telemetryparser.h \
+    ../../propertyregistry.h \
+    ../../telemetrystore.h
@@ -0,0 +1,190 @@
+#include <QtTest>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include "telemetryparser.h"
+#include "propertyregistry.h"
+#include "telemetrystore.h"
+
+// ---- Definitions ---- //
+
+#define SteadyStateRuns 10000 ///< Calls counted after the warm up call
+
+//  -----------      ----------------                Allocation Counter                     ----------------              ---------------- //
+
+// every allocation of the test binary goes through the replaced operator new
+static std::atomic<long> allocationCount(0);
+
+void *operator new(std::size_t size)
+{
+    allocationCount++;
+    void *memory = std::malloc(size > 0 ? size : 1);
+    if (memory == nullptr)
+        throw std::bad_alloc();
+    return memory;
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void *memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+//  -----------      ----------------                Test Functions                     ----------------              ---------------- //
+
+/*
+ * Steady state of the ingest path allocates nothing.
+ *
+ * Every function is called once to warm up caches, series and chunks, then the
+ * allocations of SteadyStateRuns further calls are counted, expected to be zero.
+ */
+class tst_Allocations : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void tokenize();
+    void parseDecimal();
+    void timeKey();
+    void propertyLookup();
+    void storeAppend();
+};
+
+static const char telemetryLine[] = "2022-Jun-22 16:23:41 1234 note psu1:volt 5.25/V";
+
+/**
+ * @brief Splitting a line into tokens
+ */
+void tst_Allocations::tokenize()
+{
+    telemetryRecord record;
+    int length = int(strlen(telemetryLine));
+    TelemetryParser::tokenize(telemetryLine, length, &record);
+
+    long before = allocationCount;
+    int tokens = 0;
+    for (int i = 0; i < SteadyStateRuns; i++)
+    {
+        TelemetryParser::tokenize(telemetryLine, length, &record);
+        tokens += record.count;
+    }
+    long allocations = allocationCount - before;
+
+    QCOMPARE(tokens, 6 * SteadyStateRuns);
+    QCOMPARE(allocations, 0L);
+}
+
+/**
+ * @brief Parsing values with units
+ */
+void tst_Allocations::parseDecimal()
+{
+    const char value[] = "-1.25e3/mV";
+    int length = int(strlen(value));
+    TelemetryParser::parseDecimal(value, length);
+
+    long before = allocationCount;
+    double sum = 0;
+    for (int i = 0; i < SteadyStateRuns; i++)
+        sum += TelemetryParser::parseDecimal(value, length);
+    long allocations = allocationCount - before;
+
+    QCOMPARE(sum, -1250.0 * SteadyStateRuns);
+    QCOMPARE(allocations, 0L);
+}
+
+/**
+ * @brief Time keys inside one hour
+ *
+ * First key converts the start of the hour, the rest of the hour is parsed directly.
+ */
+void tst_Allocations::timeKey()
+{
+    TelemetryParser parser;
+    const char date[] = "2022-Jun-22";
+    char time[] = "16:00:00";
+    double first = parser.timeKey(date, 11, time, 8);
+
+    long before = allocationCount;
+    double last = first;
+    for (int i = 0; i < SteadyStateRuns; i++)
+    {
+        int second = i % 3600;
+        time[3] = char('0' + second / 600);
+        time[4] = char('0' + second / 60 % 10);
+        time[6] = char('0' + second % 60 / 10);
+        time[7] = char('0' + second % 10);
+        last = parser.timeKey(date, 11, time, 8);
+    }
+    long allocations = allocationCount - before;
+
+    QCOMPARE(last - first, double((SteadyStateRuns - 1) % 3600));
+    QCOMPARE(allocations, 0L);
+}
+
+/**
+ * @brief Looking up a known property name in the receive buffer
+ */
+void tst_Allocations::propertyLookup()
+{
+    const char *name = telemetryLine + 31; // "psu1:volt" inside the line
+    int id = PropertyRegistry::instance().intern(name, 9);
+
+    long before = allocationCount;
+    int found = 0;
+    for (int i = 0; i < SteadyStateRuns; i++)
+    {
+        found += PropertyRegistry::instance().find(name, 9) == id;
+        found += PropertyRegistry::instance().intern(name, 9) == id;
+    }
+    long allocations = allocationCount - before;
+
+    QCOMPARE(found, 2 * SteadyStateRuns);
+    QCOMPARE(allocations, 0L);
+}
+
+/**
+ * @brief Appending samples inside one chunk
+ *
+ * First sample creates the series and its chunk, a new chunk is only allocated
+ * every chunkSize() samples.
+ */
+void tst_Allocations::storeAppend()
+{
+    TelemetryStore store;
+    int property = PropertyRegistry::instance().intern(QByteArray("psu1:curr"));
+    store.append(property, 0, 0);
+
+    int runs = TelemetryStore::chunkSize() - 1;
+    long before = allocationCount;
+    for (int i = 1; i <= runs; i++)
+        store.append(property, i, i * 0.5);
+    long allocations = allocationCount - before;
+
+    QCOMPARE(store.sampleCount(property), runs + 1);
+    QCOMPARE(allocations, 0L);
+}
+
+QTEST_APPLESS_MAIN(tst_Allocations)
+
+#include "tst_allocations.moc"
@@ -0,0 +1,138 @@
+#include "timeaxisticker.h"
+#include "telemetry.h"
+
+#include <cmath>
+
+// ---- Definitions ---- //
+
+#define LabelCacheLimit 4096 ///< Labels kept in the cache, cache is cleared when full
+
+//  -----------      ----------------                Constructor Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Constructor
+ *
+ * @code {.c++}
+ * TimeAxisTicker::TimeAxisTicker()
+ * @endcode
+ */
+TimeAxisTicker::TimeAxisTicker()
+{
+    setDateTimeFormat(DateFormat);
+}
+
+//  -----------      ----------------                Tick Functions                     ----------------              ---------------- //
+
+/**
+ * @brief Generate ticks of the range
+ *
+ * Called by the axis on every replot. Same range and tick count as the last call ->
+ * previous ticks and labels are returned without calculation.
+ *
+ * @code {.c++}
+ * TimeAxisTicker::generate(const QCPRange &range, const QLocale &locale, QChar formatChar, int precision, QVector<double> &ticks, QVector<double> *subTicks, QVector<QString> *tickLabels)
+ * @endcode
+ */
+void TimeAxisTicker::generate(const QCPRange &range, const QLocale &locale, QChar formatChar, int precision, QVector<double> &ticks, QVector<double> *subTicks, QVector<QString> *tickLabels)
+{
+    checkSettings(locale);
+
+    bool reuse = range == cachedRange && mTickCount == cachedTickCount && (subTicks == nullptr || cachedWithSubTicks) && (tickLabels == nullptr || cachedWithLabels);
+    if (!reuse)
+    {
+        QCPAxisTickerDateTime::generate(range, locale, formatChar, precision, cachedTicks, subTicks != nullptr ? &cachedSubTicks : nullptr, tickLabels != nullptr ? &cachedLabels : nullptr);
+        cachedRange = range;
+        cachedTickCount = mTickCount;
+        cachedWithSubTicks = subTicks != nullptr;
+        cachedWithLabels = tickLabels != nullptr;
+    }
+
+    ticks = cachedTicks; // implicitly shared, no copy
+    if (subTicks != nullptr)
+        *subTicks = cachedSubTicks;
+    if (tickLabels != nullptr)
+        *tickLabels = cachedLabels;
+}
+
+/**
+ * @brief Label of a single tick
+ *
+ * @code {.c++}
+ * TimeAxisTicker::getTickLabel(double tick, const QLocale &locale, QChar formatChar, int precision)
+ * @endcode
+ */
+QString TimeAxisTicker::getTickLabel(double tick, const QLocale &locale, QChar formatChar, int precision)
+{
+    qint64 id = qRound64(tick * 1000);
+    QHash<qint64, QString>::const_iterator found = labelCache.constFind(id);
+    if (found != labelCache.constEnd())
+        return found.value();
+
+    QString label;
+    if (mDateTimeFormat == DateFormat && mDateTimeSpec == Qt::LocalTime)
+        label = fastLabel(tick, locale);
+    else
+        label = QCPAxisTickerDateTime::getTickLabel(tick, locale, formatChar, precision);
+
+    if (labelCache.size() >= LabelCacheLimit)
+        labelCache.clear();
+    labelCache.insert(id, label);
+    return label;
+}
+
+/**
+ * @brief DateFormat label without QDateTime
+ *
+ * Date and hour are formatted once per hour of local time, minutes and seconds are
+ * written as digits. Offset of the local time only changes at hour boundaries, so the
+ * seconds inside the hour are taken from the key directly.
+ *
+ * @code {.c++}
+ * TimeAxisTicker::fastLabel(double tick, const QLocale &locale)
+ * @endcode
+ */
+QString TimeAxisTicker::fastLabel(double tick, const QLocale &locale)
+{
+    double second = std::floor(tick);
+    if (second < hourStart || second >= hourEnd)
+    {
+        QDateTime time = keyToDateTime(second).toLocalTime();
+        hourStart = second - time.time().minute() * 60 - time.time().second();
+        hourEnd = hourStart + 3600;
+        hourPrefix = locale.toString(time, "yyyy-MMM-dd-hh:");
+    }
+
+    int inHour = (int)(second - hourStart);
+    int minute = inHour / 60;
+    int seconds = inHour % 60;
+
+    QString label = hourPrefix;
+    label.reserve(hourPrefix.size() + 5);
+    label.append(QChar('0' + minute / 10));
+    label.append(QChar('0' + minute % 10));
+    label.append(QChar(':'));
+    label.append(QChar('0' + seconds / 10));
+    label.append(QChar('0' + seconds % 10));
+    return label;
+}
+
+/**
+ * @brief Clear caches after settings change
+ *
+ * @code {.c++}
+ * TimeAxisTicker::checkSettings(const QLocale &locale)
+ * @endcode
+ */
+void TimeAxisTicker::checkSettings(const QLocale &locale)
+{
+    if (mDateTimeFormat == cachedFormat && mDateTimeSpec == cachedSpec && locale == cachedLocale)
+        return;
+
+    cachedFormat = mDateTimeFormat;
+    cachedSpec = mDateTimeSpec;
+    cachedLocale = locale;
+    labelCache.clear();
+    hourStart = 1;
+    hourEnd = 0;
+    cachedTickCount = -1; // labels must be generated again
+}
@@ -0,0 +1,53 @@
+#ifndef TIMEAXISTICKER_H
+#define TIMEAXISTICKER_H
+
+#include <QHash>
+#include <QLocale>
+#include <QString>
+#include <QVector>
+#include "qcustomplot.h"
+
+/*
+ * Date time ticker of the plot time axes with cached ticks and labels.
+ *
+ * Ticks of the last generated range are reused while the range does not change.
+ * While scrolling, most ticks stay the same, their labels are kept in a label cache
+ * keyed by the tick. Labels of the default format (DateFormat, local time) are built
+ * with integer arithmetic on top of a cached "yyyy-MMM-dd-hh:" prefix of the hour,
+ * other formats fall back to QDateTime.
+ */
+class TimeAxisTicker : public QCPAxisTickerDateTime
+{
+public:
+    TimeAxisTicker();
+
+    void generate(const QCPRange &range, const QLocale &locale, QChar formatChar, int precision, QVector<double> &ticks, QVector<double> *subTicks, QVector<QString> *tickLabels) override;
+
+protected:
+    QString getTickLabel(double tick, const QLocale &locale, QChar formatChar, int precision) override;
+
+private:
+    QString fastLabel(double tick, const QLocale &locale); // DateFormat labels in local time
+    void checkSettings(const QLocale &locale);             // clears the caches when format or locale changes
+
+    // *** Last generated ticks *** //
+    QCPRange cachedRange;
+    int cachedTickCount = -1;
+    bool cachedWithSubTicks = false;
+    bool cachedWithLabels = false;
+    QVector<double> cachedTicks;
+    QVector<double> cachedSubTicks;
+    QVector<QString> cachedLabels;
+
+    // *** Labels *** //
+    QString cachedFormat;
+    QLocale cachedLocale;
+    Qt::TimeSpec cachedSpec = Qt::LocalTime;
+    QHash<qint64, QString> labelCache; // tick in ms -> label
+
+    double hourStart = 1;  // key range of the cached hour prefix, empty at start
+    double hourEnd = 0;
+    QString hourPrefix;    // "yyyy-MMM-dd-hh:"
+};
+
+#endif // TIMEAXISTICKER_H
@@ -6,52 +6,84 @@
 
 #include <QMessageBox>
 
-#include <mainwindow.h>
+#include "procedurerunner.h"
 #include <QDateTime>
 
 //-----------       ----------------             Command Tree Functions                ----------------          ----------------//
+/*
+ * Index of the field separator '-' of a command line.
+ * '-' after a space belongs to the command (negative values as "set heater -5"), -1 if there is no separator
+ */
+static int commandSeparator(const QString &line, int from)
+{
+    for (int i = from; i < line.size(); i++)
+    {
+        if (line[i] == '-' && i > 0 && line[i - 1] != ' ')
+            return i;
+    }
+    return -1;
+}
+
 /*
  * Method for reading commands from text file, returns the ready tree view model
+ *
+ *      *<group name>
+ *      #<command>-<description>            -> sent right after the previous command
+ *      #<command>-<description>-@<seconds> -> sent at the given time after the procedure start
+ *      <empty line>                        -> ends the group
+ *
+ * Columns : command, description, schedule
  */
 QStandardItemModel *readCommandsFromFile(QString &fileName)
 {
     QStandardItemModel *tempModel = new QStandardItemModel;
     QStandardItem *tempMainItem = nullptr;
-    QStandardItem *tempSubItem = nullptr;
-    QStandardItem *tempSubColumn = nullptr;
     QFile commandText(fileName);
 
-    tempModel->setColumnCount(2);
-
-    int count = 0;
+    tempModel->setColumnCount(3);
 
     QTextStream stream(&commandText);
-    if (commandText.open(QIODevice::ReadWrite))
+    if (commandText.open(QIODevice::ReadOnly))
     {
         while (!stream.atEnd())
         {
             QString line = stream.readLine();
-            QStringList listedLine = line.split("-");
             QList<QStandardItem *> tempItem;
-            // commandDataStruct* tempData = new commandDataStruct(listedLine[0],listedLine[1]);
-            if (line[0] == '*') // if main function
+            if (line.startsWith('*')) // if main function
             {
-                tempMainItem = new QStandardItem(listedLine[0].mid(1));
+                if (tempMainItem != nullptr) // group without empty line at the end
+                    tempModel->appendRow(tempMainItem);
+                tempMainItem = new QStandardItem(line.mid(1).trimmed());
             }
-            else if (line[0] == '#')
+            else if (line.startsWith('#') && tempMainItem != nullptr)
             {
-                tempItem.append(new QStandardItem(listedLine[0].mid(1)));
-                tempItem.append(new QStandardItem(listedLine[1]));
-                // tempSubItem = new QStandardItem(listedLine[0]);
+                int separator = commandSeparator(line, 1);
+                QString command = separator < 0 ? line.mid(1) : line.mid(1, separator - 1);
+                QString description = separator < 0 ? QString() : line.mid(separator + 1);
+                QString schedule;
+
+                int scheduleSeparator = description.lastIndexOf("-@");
+                if (scheduleSeparator >= 0) // scheduled command
+                {
+                    schedule = description.mid(scheduleSeparator + 1);
+                    description = description.left(scheduleSeparator);
+                }
+
+                tempItem.append(new QStandardItem(command.trimmed()));
+                tempItem.append(new QStandardItem(description.trimmed()));
+                tempItem.append(new QStandardItem(schedule));
                 tempMainItem->appendRow(tempItem);
             }
-            else
+            else if (line.trimmed().isEmpty() && tempMainItem != nullptr)
             {
                 tempModel->appendRow(tempMainItem);
-                count++;
+                tempMainItem = nullptr;
             }
         }
     }
+    if (tempMainItem != nullptr) // last group
+        tempModel->appendRow(tempMainItem);
+
     commandText.close();
     return tempModel;
 }